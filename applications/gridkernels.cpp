@@ -0,0 +1,122 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Time the bulk GridProperty kernels against plain serial loops over
+  the same data, i.e. the loops the kernels replaced:
+
+      gridkernels [cells] [threads]
+
+  threads = 0, the default, is the OpenMP default. The masks select
+  every 100th cell.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opm/parser/eclipse/EclipseState/Grid/Box.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+
+namespace {
+
+    template< typename F >
+    double seconds( F f ) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    template< typename Serial, typename Kernel >
+    void report( const std::string& name, Serial serial, Kernel kernel ) {
+        const double t_serial = seconds( serial );
+        const double t_kernel = seconds( kernel );
+        std::cout << std::setw( 22 ) << std::left << name << std::right
+                  << std::fixed << std::setprecision( 4 )
+                  << std::setw( 10 ) << t_serial << " s"
+                  << std::setw( 10 ) << t_kernel << " s"
+                  << std::setprecision( 1 ) << std::setw( 8 ) << t_serial / t_kernel << "x"
+                  << std::endl;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    typedef Opm::GridProperty< double >::SupportedKeywordInfo SupportedKeywordInfo;
+
+    const size_t cells = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 10000000;
+    Opm::GridKernels::setThreads( argc > 2 ? std::atoi( argv[2] ) : 0 );
+
+    std::cout << "threads: " << Opm::GridKernels::threads() << std::endl;
+    std::cout << "cells:   " << cells << std::endl;
+    std::cout << std::setw( 22 ) << "" << std::setw( 12 ) << "serial" << std::setw( 12 ) << "kernel" << std::endl;
+
+    const Opm::Box global( cells, 1, 1 );
+    Opm::GridProperty< double > prop( cells, 1, 1, SupportedKeywordInfo( "P", 1.0, "1" ) );
+    Opm::GridProperty< double > other( cells, 1, 1, SupportedKeywordInfo( "Q", 1.0, "1" ) );
+    auto& data = prop.getData();
+    const auto& src = other.getData();
+    for (size_t g = 0; g < cells; g += 100)
+        data[g] = 2;
+
+    std::vector< bool > bits;
+    Opm::GridProperty< double >::ByteMask bytes;
+
+    report( "initMask (bool)",
+            [&] { bits.resize( cells ); for (size_t g = 0; g < cells; g++) bits[g] = data[g] == 2; },
+            [&] { prop.initMask( 2, bits ); } );
+
+    report( "initMask (byte)",
+            [&] { bytes.resize( cells ); for (size_t g = 0; g < cells; g++) bytes[g] = data[g] == 2; },
+            [&] { prop.initMask( 2, bytes ); } );
+
+    report( "maskedAdd (bool)",
+            [&] { for (size_t g = 0; g < cells; g++) if (bits[g]) data[g] += 1; },
+            [&] { prop.maskedAdd( 1, bits ); } );
+
+    report( "maskedAdd (byte)",
+            [&] { for (size_t g = 0; g < cells; g++) if (bytes[g]) data[g] += 1; },
+            [&] { prop.maskedAdd( 1, bytes ); } );
+
+    report( "maskedCopy (byte)",
+            [&] { for (size_t g = 0; g < cells; g++) if (bytes[g]) data[g] = src[g]; },
+            [&] { prop.maskedCopy( other, bytes ); } );
+
+    report( "multiplyWith",
+            [&] { for (size_t g = 0; g < cells; g++) data[g] *= src[g]; },
+            [&] { prop.multiplyWith( other ); } );
+
+    report( "scale",
+            [&] { for (size_t g : global) data[g] *= 1.0; },
+            [&] { prop.scale( 1.0, global ); } );
+
+    report( "checkLimits",
+            [&] { for (size_t g = 0; g < cells; g++) if (data[g] < 0 || data[g] > 10) std::abort(); },
+            [&] { prop.checkLimits( 0, 10 ); } );
+
+    report( "containsNaN",
+            [&] { for (size_t g = 0; g < cells; g++) if (std::isnan( data[g] )) std::abort(); },
+            [&] { if (prop.containsNaN()) std::abort(); } );
+}
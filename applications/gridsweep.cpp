@@ -0,0 +1,82 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Compare the bandwidth of a parallel per-cell sweep over plain grid
+  sized std::vectors with the same arrays backed by huge pages through
+  GridMemory:
+
+      gridsweep [cells] [sweeps] [threads]
+
+  Both kinds of arrays are initialized by one thread. The sweep is
+  a[i] = a[i] * s + b[i], i.e. two loads and one store, run through
+  GridKernels::forEachChunk like the bulk property operations; threads
+  is passed to GridKernels::setThreads().
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+
+namespace {
+
+    double sweep( std::vector< double >& a, const std::vector< double >& b, size_t sweeps ) {
+        const size_t size = a.size();
+        const auto start = std::chrono::steady_clock::now();
+
+        for( size_t s = 0; s < sweeps; s++ ) {
+            Opm::GridKernels::forEachChunk( size, [&]( size_t begin, size_t end ) {
+                for( size_t i = begin; i < end; i++ )
+                    a[i] = a[i] * 0.5 + b[i];
+            });
+        }
+
+        const std::chrono::duration< double > seconds = std::chrono::steady_clock::now() - start;
+        return 3.0 * sizeof( double ) * size * sweeps / seconds.count() / 1e9;
+    }
+
+    void report( const char* name, std::vector< double > a, std::vector< double > b, size_t sweeps ) {
+        sweep( a, b, 1 );
+        std::cout << std::setw( 12 ) << name << "  "
+                  << std::fixed << std::setprecision( 2 ) << sweep( a, b, sweeps ) << " GB/s"
+                  << std::endl;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const size_t cells = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : size_t( 1 ) << 24;
+    const size_t sweeps = argc > 2 ? std::strtoul( argv[2], nullptr, 10 ) : 20;
+    if( argc > 3 )
+        Opm::GridKernels::setThreads( std::atoi( argv[3] ) );
+
+    std::cout << "threads: " << Opm::GridKernels::threads() << std::endl;
+    std::cout << "cells:   " << cells << std::endl;
+
+    report( "vector", std::vector< double >( cells, 1.0 ),
+                      std::vector< double >( cells, 1.0 ), sweeps );
+
+    report( "huge pages", Opm::GridMemory::filled( cells, 1.0 ),
+                          Opm::GridMemory::filled( cells, 1.0 ), sweeps );
+}
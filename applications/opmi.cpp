@@ -17,7 +17,9 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
@@ -27,6 +29,7 @@
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 inline void dumpMessages( const Opm::MessageContainer& messageContainer) {
     auto extractMessage = [](const Opm::Message& msg) {
@@ -43,7 +46,7 @@ inline void dumpMessages( const Opm::MessageContainer& messageContainer) {
 }
 
 
-inline void loadDeck( const char * deck_file) {
+inline void loadDeck( const char * deck_file, bool memory_report, bool compress) {
     Opm::ParseContext parseContext;
     Opm::Parser parser;
 
@@ -53,14 +56,39 @@ inline void loadDeck( const char * deck_file) {
     Opm::EclipseState state( deck, parseContext );
     Opm::Schedule schedule( deck, state.getInputGrid(), state.get3DProperties(), state.runspec().phases(), parseContext);
     Opm::SummaryConfig summary( deck, schedule, state.getTableManager( ), parseContext );
+    if (compress)
+        state.compressProperties();
     std::cout << "complete." << std::endl;
 
     dumpMessages( deck.getMessageContainer() );
+
+    if (memory_report) {
+        Opm::MemoryUsage usage;
+        deck.memoryUsage( usage );
+        state.memoryUsage( usage );
+        schedule.memoryUsage( usage );
+        summary.memoryUsage( usage );
+        usage.report( std::cout , 25 );
+    }
 }
 
 
 int main(int argc, char** argv) {
-    for (int iarg = 1; iarg < argc; iarg++)
-        loadDeck( argv[iarg] );
+    bool memory_report = false;
+    bool compress = false;
+    std::vector< const char* > deck_files;
+
+    /* the options apply to all the decks, wherever they are given */
+    for (int iarg = 1; iarg < argc; iarg++) {
+        if (std::strcmp( argv[iarg], "--memory" ) == 0)
+            memory_report = true;
+        else if (std::strcmp( argv[iarg], "--compress" ) == 0)
+            compress = true;
+        else
+            deck_files.push_back( argv[iarg] );
+    }
+
+    for (const auto* deck_file : deck_files)
+        loadDeck( deck_file, memory_report, compress );
 }
 
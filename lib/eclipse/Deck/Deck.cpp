@@ -25,6 +25,7 @@
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
 #include <opm/parser/eclipse/Deck/Section.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -128,6 +129,10 @@ namespace Opm {
             this->keywordMap[ kw.name() ].push_back( index++ );
     }
 
+    size_t DeckView::indexMemoryUsage() const {
+        return memory::heap( this->keywordMap );
+    }
+
     DeckView::DeckView( std::pair< const_iterator, const_iterator > limits ) :
         DeckView( limits.first, limits.second )
     {}
@@ -239,6 +244,26 @@ namespace Opm {
             if (kw_index < size())
                 output.write_string( output.keyword_sep );
         }
+        output.flush( );
+    }
+
+    void Deck::memoryUsage( MemoryUsage& usage ) const {
+        for( const auto& keyword : *this )
+            usage.add( "Deck/keywords/" + keyword.name(),
+                       sizeof( DeckKeyword ) + keyword.memoryUsage() );
+
+        const auto unused = this->keywordList.capacity() - this->keywordList.size();
+        usage.add( "Deck/index", unused * sizeof( DeckKeyword ) + this->indexMemoryUsage() );
+        usage.add( "Deck/messages", this->m_messageContainer.memoryUsage() );
+        usage.add( "Deck/units", this->defaultUnits.memoryUsage()
+                               + this->activeUnits.memoryUsage()
+                               + memory::heap( this->m_dataFile ) );
+    }
+
+    size_t Deck::memoryUsage() const {
+        MemoryUsage usage;
+        this->memoryUsage( usage );
+        return usage.total();
     }
 
     std::ostream& operator<<(std::ostream& os, const Deck& deck) {
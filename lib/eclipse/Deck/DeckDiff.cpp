@@ -0,0 +1,149 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckDiff.hpp>
+
+namespace Opm {
+
+namespace {
+
+    DeckDiff::KeywordDiff keyword_diff( const std::string& name,
+                                        size_t occurrence,
+                                        DeckDiff::Status status ) {
+        DeckDiff::KeywordDiff diff;
+        diff.name = name;
+        diff.occurrence = occurrence;
+        diff.status = status;
+        return diff;
+    }
+
+    /*
+      Differing hashes prove a difference; equal hashes can collide, so
+      a match is confirmed by an exact compare of the values.
+    */
+    template< typename T >
+    bool same_content( const T& first, const T& second ) {
+        const bool cmp_default = false;
+        const bool cmp_numeric = false;
+        return first.hash() == second.hash()
+            && first.equal( second, cmp_default, cmp_numeric );
+    }
+
+    const char* status_name( DeckDiff::Status status ) {
+        switch( status ) {
+            case DeckDiff::Status::added:   return "ADDED";
+            case DeckDiff::Status::removed: return "REMOVED";
+            case DeckDiff::Status::changed: return "CHANGED";
+        }
+        return "";
+    }
+
+    void write_indices( std::ostream& os,
+                        const char* label,
+                        const std::vector< size_t >& indices ) {
+        if( indices.empty() ) return;
+
+        os << " " << label << ":";
+        for( auto index : indices )
+            os << " " << index;
+    }
+
+}
+
+    DeckDiff::DeckDiff( const Deck& first, const Deck& second ) {
+        std::unordered_map< std::string, size_t > occurrences;
+
+        for( const auto& keyword : first ) {
+            const auto& name = keyword.name();
+            const auto occurrence = occurrences[ name ]++;
+
+            if( occurrence >= second.count( name ) ) {
+                this->keywords.push_back( keyword_diff( name, occurrence, Status::removed ) );
+                continue;
+            }
+
+            const auto& other = second.getKeyword( name, occurrence );
+            if( same_content( keyword, other ) ) continue;
+
+            auto diff = keyword_diff( name, occurrence, Status::changed );
+            const auto common = std::min( keyword.size(), other.size() );
+
+            for( size_t index = 0; index < common; ++index ) {
+                if( !same_content( keyword.getRecord( index ), other.getRecord( index ) ) )
+                    diff.changed_records.push_back( index );
+            }
+
+            for( size_t index = common; index < keyword.size(); ++index )
+                diff.removed_records.push_back( index );
+
+            for( size_t index = common; index < other.size(); ++index )
+                diff.added_records.push_back( index );
+
+            this->keywords.push_back( std::move( diff ) );
+        }
+
+        std::unordered_map< std::string, size_t > added;
+        for( const auto& keyword : second ) {
+            const auto& name = keyword.name();
+            const auto occurrence = added[ name ]++;
+
+            if( occurrence >= first.count( name ) )
+                this->keywords.push_back( keyword_diff( name, occurrence, Status::added ) );
+        }
+    }
+
+    bool DeckDiff::empty() const {
+        return this->keywords.empty();
+    }
+
+    size_t DeckDiff::size() const {
+        return this->keywords.size();
+    }
+
+    const DeckDiff::KeywordDiff& DeckDiff::operator[]( size_t index ) const {
+        return this->keywords.at( index );
+    }
+
+    DeckDiff::const_iterator DeckDiff::begin() const {
+        return this->keywords.begin();
+    }
+
+    DeckDiff::const_iterator DeckDiff::end() const {
+        return this->keywords.end();
+    }
+
+    std::ostream& operator<<( std::ostream& os, const DeckDiff& diff ) {
+        for( const auto& keyword : diff ) {
+            os << status_name( keyword.status ) << " "
+               << keyword.name << "[" << keyword.occurrence << "]";
+
+            write_indices( os, "changed records", keyword.changed_records );
+            write_indices( os, "removed records", keyword.removed_records );
+            write_indices( os, "added records", keyword.added_records );
+            os << std::endl;
+        }
+
+        return os;
+    }
+
+}
@@ -20,17 +20,21 @@
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
 #include <opm/parser/eclipse/Units/Dimension.hpp>
+#include <opm/parser/eclipse/Utility/Hash.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <boost/algorithm/string.hpp>
 
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 #include <cmath>
 
 namespace Opm {
 
 template< typename T >
 std::vector< T >& DeckItem::value_ref() {
+    this->hash_valid = false;
     return const_cast< std::vector< T >& >(
             const_cast< const DeckItem& >( *this ).value_ref< T >()
          );
@@ -94,6 +98,10 @@ bool DeckItem::defaultApplied( size_t index ) const {
     return this->defaulted.at( index );
 }
 
+bool DeckItem::hasDefaultedValues() const {
+    return this->num_defaulted > 0;
+}
+
 bool DeckItem::hasValue( size_t index ) const {
     switch( this->type ) {
         case type_tag::integer: return this->ival.size() > index;
@@ -176,6 +184,7 @@ void DeckItem::push_default( T x ) {
 
     val.push_back( std::move( x ) );
     this->defaulted.push_back( true );
+    this->num_defaulted++;
 }
 
 void DeckItem::push_backDefault( int x ) {
@@ -195,7 +204,9 @@ void DeckItem::push_backDummyDefault() {
     if( !this->defaulted.empty() )
         throw std::logic_error("Pseudo defaults can only be specified for empty items");
 
+    this->hash_valid = false;
     this->defaulted.push_back( true );
+    this->num_defaulted++;
 }
 
 std::string DeckItem::getTrimmedString( size_t index ) const {
@@ -226,6 +237,17 @@ const std::vector< double >& DeckItem::getSIDoubleData() const {
     const auto sz = raw.size();
     this->SIdata.resize( sz );
 
+    if( dim_size == 1 && sz > 0 ) {
+        /* the common case, e.g. a grid property: one factor and offset */
+        const auto& dim = this->dimensions.front();
+        const double factor = dim.getSIScaling();
+        const double offset = dim.getSIOffset();
+        for( size_t index = 0; index < sz; index++ )
+            this->SIdata[ index ] = raw[ index ] * factor + offset;
+
+        return this->SIdata;
+    }
+
     for( size_t index = 0; index < sz; index++ ) {
         const auto dimIndex = index % dim_size;
         this->SIdata[ index ] = this->dimensions[ dimIndex ]
@@ -250,27 +272,16 @@ type_tag DeckItem::getType() const {
 
 
 
-template< typename T >
-void DeckItem::write_vector(DeckOutput& stream, const std::vector<T>& data) const {
-    for (size_t index = 0; index < this->out_size(); index++) {
-        if (this->defaultApplied(index))
-            stream.stash_default( );
-        else
-            stream.write( data[index] );
-    }
-}
-
-
 void DeckItem::write(DeckOutput& stream) const {
     switch( this->type ) {
     case type_tag::integer:
-        this->write_vector( stream, this->ival );
+        stream.write_data( this->ival, this->defaulted );
         break;
     case type_tag::fdouble:
-        this->write_vector( stream,  this->dval );
+        stream.write_data( this->dval, this->defaulted );
         break;
     case type_tag::string:
-        this->write_vector( stream,  this->sval );
+        stream.write_data( this->sval, this->defaulted );
         break;
     default:
         throw std::logic_error( "Type not set." );
@@ -317,6 +328,15 @@ bool DeckItem::equal(const DeckItem& other, bool cmp_default, bool cmp_numeric)
         if (this->defaulted != other.defaulted)
             return false;
 
+    /*
+      The hash covers exactly name, type and values, so differing hashes
+      imply differing values when comparing exactly. Equal hashes can
+      still collide, and a tolerance compare can accept differing values,
+      so in every other case the values themselves are compared.
+    */
+    if (!cmp_numeric && this->hash() != other.hash())
+        return false;
+
     switch( this->type ) {
     case type_tag::integer:
         if (this->ival != other.ival)
@@ -346,6 +366,54 @@ bool DeckItem::equal(const DeckItem& other, bool cmp_default, bool cmp_numeric)
     return true;
 }
 
+uint64_t DeckItem::hash() const {
+    if( this->hash_valid )
+        return this->content_hash;
+
+    auto h = hash::combine( hash::string( this->item_name ),
+                            static_cast< uint64_t >( this->type ) );
+
+    switch( this->type ) {
+    case type_tag::integer:
+        h = hash::bytes( this->ival.data(), this->ival.size() * sizeof( int ), h );
+        break;
+    case type_tag::fdouble: {
+        /* -0.0 == 0.0, so the sign of zero must not leak into the hash */
+        double block[ 256 ];
+        h = hash::combine( h, this->dval.size() );
+        for( size_t first = 0; first < this->dval.size(); first += 256 ) {
+            const auto n = std::min< size_t >( 256, this->dval.size() - first );
+            for( size_t i = 0; i < n; i++ )
+                block[ i ] = this->dval[ first + i ] + 0.0;
+
+            h = hash::bytes( block, n * sizeof( double ), h );
+        }
+        break;
+    }
+    case type_tag::string:
+        h = hash::combine( h, this->sval.size() );
+        for( const auto& s : this->sval )
+            h = hash::string( s, h );
+        break;
+    default:
+        break;
+    }
+
+    this->content_hash = h;
+    this->hash_valid = true;
+    return h;
+}
+
+size_t DeckItem::memoryUsage() const {
+    return memory::heap( this->dval )
+         + memory::heap( this->ival )
+         + memory::heap( this->sval )
+         + memory::heap( this->item_name )
+         + memory::heap( this->defaulted )
+         + memory::heap( this->dimensions )
+         + memory::heap( this->SIdata );
+}
+
 bool DeckItem::operator==(const DeckItem& other) const {
     bool cmp_default = false;
     bool cmp_numeric = true;
@@ -21,6 +21,8 @@
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Utility/Hash.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -192,5 +194,19 @@ namespace Opm {
         return !(*this == other);
     }
 
+    size_t DeckKeyword::memoryUsage() const {
+        return memory::heap( this->m_keywordName )
+             + memory::heap( this->m_fileName )
+             + memory::heap( this->m_recordList );
+    }
+
+    uint64_t DeckKeyword::hash() const {
+        auto h = hash::combine( hash::string( this->name() ), this->size() );
+        for (const auto& record : *this)
+            h = hash::combine( h, record.hash() );
+
+        return hash::mix( h );
+    }
+
 }
 
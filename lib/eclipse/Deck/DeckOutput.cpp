@@ -17,13 +17,169 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <ostream>
+#include <type_traits>
 
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 
 
 namespace Opm {
 
+namespace {
+
+    /*
+      The buffer is handed over to the underlying stream when it
+      exceeds this size.
+    */
+    const size_t flush_size = 1 << 20;
+
+    /*
+      Items with fewer values than this are always formatted serially,
+      and parallel formatting uses chunks of roughly this many tokens.
+    */
+    const size_t parallel_size = 1 << 16;
+    const size_t chunk_tokens = 1 << 14;
+
+    struct value_run {
+        size_t index;
+        size_t count;
+        bool defaulted;
+    };
+
+    /* -0.0 and 0.0 are written differently, so they do not form a run */
+    template <typename T>
+    bool same_value( const T& a, const T& b ) {
+        return a == b;
+    }
+
+    template <>
+    bool same_value( const double& a, const double& b ) {
+        return a == b && std::signbit( a ) == std::signbit( b );
+    }
+
+    template <typename T>
+    size_t run_end( const std::vector<T>& data, const std::vector<bool>& defaulted, size_t size, size_t index ) {
+        size_t end = index + 1;
+        if (defaulted[index]) {
+            while (end < size && defaulted[end])
+                end++;
+        } else {
+            while (end < size && !defaulted[end] && same_value( data[end], data[index] ))
+                end++;
+        }
+        return end;
+    }
+
+    size_t format_integer( long long value, char * buf ) {
+        char tmp[24];
+        char * p = tmp + sizeof tmp;
+        unsigned long long u = value < 0 ? 0ULL - static_cast<unsigned long long>( value )
+                                         : static_cast<unsigned long long>( value );
+        do {
+            *--p = static_cast<char>( '0' + u % 10 );
+            u /= 10;
+        } while (u > 0);
+
+        if (value < 0)
+            *--p = '-';
+
+        const size_t length = tmp + sizeof tmp - p;
+        for (size_t i = 0; i < length; i++)
+            buf[i] = p[i];
+
+        return length;
+    }
+
+    /*
+      Shortest representation which reads back as the same double. The
+      integral values which are very common in decks are formatted
+      directly, otherwise we try increasing precision until strtod()
+      gives back the original value. Since both snprintf() and strtod()
+      honor LC_NUMERIC the round trip check is consistent, and the
+      decimal point is normalized to '.' afterwards.
+    */
+    size_t format_double( double value, char * buf, size_t buf_size ) {
+        static const double pow10[] = { 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+        if (!std::isfinite( value ))
+            return std::snprintf( buf, buf_size, "%g", value );
+
+        /* the sign of zero is kept, "-0" parses back to -0.0 */
+        if (value == 0 && std::signbit( value )) {
+            buf[0] = '-';
+            buf[1] = '0';
+            return 2;
+        }
+
+        const double abs_value = std::fabs( value );
+        if (abs_value < 1e15 && value == std::trunc( value ))
+            return format_integer( static_cast<long long>( value ), buf );
+
+        /*
+          Most values in a deck have been parsed from short decimal
+          strings. If value == r / 10^d for an integer r < 2^53 the
+          decimal string 'r' with the point shifted d places parses back
+          to exactly value, because the division and strtod() are both
+          correctly rounded.
+        */
+        if (abs_value >= 1e-5) {
+            for (int d = 1; d < 16 && abs_value * pow10[d] < 9e15; d++) {
+                const double scaled = std::round( value * pow10[d] );
+                if (scaled / pow10[d] != value)
+                    continue;
+
+                char digits[24];
+                size_t num_digits = format_integer( static_cast<long long>( std::fabs( scaled ) ), digits );
+                size_t length = 0;
+                if (value < 0)
+                    buf[length++] = '-';
+
+                if (num_digits <= static_cast<size_t>( d )) {
+                    buf[length++] = '0';
+                    buf[length++] = '.';
+                    for (size_t i = num_digits; i < static_cast<size_t>( d ); i++)
+                        buf[length++] = '0';
+                    for (size_t i = 0; i < num_digits; i++)
+                        buf[length++] = digits[i];
+                } else {
+                    const size_t int_digits = num_digits - d;
+                    for (size_t i = 0; i < int_digits; i++)
+                        buf[length++] = digits[i];
+                    buf[length++] = '.';
+                    for (size_t i = int_digits; i < num_digits; i++)
+                        buf[length++] = digits[i];
+                }
+                return length;
+            }
+        }
+
+        int length = 0;
+        for (int precision = 15; precision <= 17; precision++) {
+            length = std::snprintf( buf, buf_size, "%.*g", precision, value );
+            if (std::strtod( buf, nullptr ) == value)
+                break;
+        }
+
+        const char decimal_point = std::localeconv()->decimal_point[0];
+        if (decimal_point != '.') {
+            for (int i = 0; i < length; i++) {
+                if (buf[i] == decimal_point) {
+                    buf[i] = '.';
+                    break;
+                }
+            }
+        }
+
+        return static_cast<size_t>( length );
+    }
+
+}
+
     DeckOutput::DeckOutput( std::ostream& s) :
         os( s ),
         default_count( 0 ),
@@ -31,58 +187,234 @@ namespace Opm {
         record_on( false )
     {}
 
+    DeckOutput::~DeckOutput() {
+        this->flush();
+    }
+
+    void DeckOutput::flush() {
+        if (!this->buffer.empty()) {
+            this->os.write( this->buffer.data(), this->buffer.size() );
+            this->buffer.clear();
+        }
+    }
+
     void DeckOutput::endl() {
-        this->os << std::endl;
+        this->buffer += '\n';
+        if (buffer.size() > flush_size)
+            this->flush();
     }
 
     void DeckOutput::write_string(const std::string& s) {
-        this->os << s;
+        this->buffer += s;
+        if (buffer.size() > flush_size)
+            this->flush();
     }
 
 
-    template <typename T>
-    void DeckOutput::write( const T& value ) {
-        if (default_count > 0) {
-            write_sep( );
+    template <>
+    void DeckOutput::write_value( const std::string& value ) {
+        this->buffer += '\'';
+        this->buffer += value;
+        this->buffer += '\'';
+    }
 
-            os << default_count << "*";
-            default_count = 0;
-            row_count++;
-        }
+    template <>
+    void DeckOutput::write_value( const int& value ) {
+        char buf[24];
+        this->buffer.append( buf, format_integer( value, buf ) );
+    }
+
+    template <>
+    void DeckOutput::write_value( const double& value ) {
+        char buf[32];
+        this->buffer.append( buf, format_double( value, buf, sizeof buf ) );
+    }
+
+    template <typename T>
+    void DeckOutput::write( const T& value, size_t count ) {
+        write_defaults( );
 
         write_sep( );
+        if (count > 1) {
+            write_count( count );
+            buffer += '*';
+        }
         write_value( value );
         row_count++;
+
+        if (buffer.size() > flush_size)
+            this->flush();
     }
 
+    /*
+      Repeated strings are written out in full; the star notation is
+      only used for numerical values.
+    */
     template <>
-    void DeckOutput::write_value( const std::string& value ) {
-        this->os << "'" << value << "'";
+    void DeckOutput::write( const std::string& value, size_t count ) {
+        write_defaults( );
+        for (size_t i = 0; i < count; i++) {
+            write_sep( );
+            write_value( value );
+            row_count++;
+        }
+
+        if (buffer.size() > flush_size)
+            this->flush();
     }
 
-    template <>
-    void DeckOutput::write_value( const int& value ) {
-        this->os << value;
+    template <typename T>
+    void DeckOutput::write( const T& value ) {
+        this->write( value, 1 );
     }
 
-    template <>
-    void DeckOutput::write_value( const double& value ) {
-        this->os << value;
+    template <typename T>
+    void DeckOutput::write_data( const std::vector<T>& data, const std::vector<bool>& defaulted ) {
+        const size_t size = std::max( data.size(), defaulted.size() );
+        if (std::is_arithmetic<T>::value && this->threads > 1 && size >= parallel_size) {
+            this->write_parallel( data, defaulted );
+            return;
+        }
+
+        size_t index = 0;
+        while (index < size) {
+            const size_t end = run_end( data, defaulted, size, index );
+            if (defaulted[index])
+                this->stash_default( end - index );
+            else
+                this->write( data[index], end - index );
+            index = end;
+        }
+    }
+
+
+    /*
+      The values are first split in runs, which become the tokens of the
+      output. Defaults pending from the previous items are merged with a
+      leading default run, and a trailing default run is left pending
+      exactly as in the serial code. The row count at the start of each
+      chunk follows from the number of tokens before it, so the chunks
+      can be formatted independently and concatenated in order.
+    */
+    template <typename T>
+    void DeckOutput::write_parallel( const std::vector<T>& data, const std::vector<bool>& defaulted ) {
+        const size_t size = std::max( data.size(), defaulted.size() );
+        std::vector<value_run> runs;
+        for (size_t index = 0; index < size; ) {
+            const size_t end = run_end( data, defaulted, size, index );
+            runs.push_back( { index, end - index, defaulted[index] } );
+            index = end;
+        }
+
+        if (runs.front().defaulted) {
+            runs.front().count += this->default_count;
+            this->default_count = 0;
+        }
+
+        size_t trailing_defaults = 0;
+        if (runs.back().defaulted) {
+            trailing_defaults = runs.back().count;
+            runs.pop_back();
+        }
+
+        if (runs.empty()) {
+            this->default_count = trailing_defaults;
+            return;
+        }
+
+        this->write_defaults( );
+        this->flush( );
+
+        const size_t line_tokens = this->record_on ? this->columns : 1;
+        const size_t tokens = line_tokens * std::max<size_t>( 1, chunk_tokens / line_tokens );
+        const int num_chunks = static_cast<int>( (runs.size() + tokens - 1) / tokens );
+        std::vector<std::string> chunks( num_chunks );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(this->threads))
+#endif
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            DeckOutput worker( this->os );
+            worker.item_sep = this->item_sep;
+            worker.columns = this->columns;
+            worker.record_indent = this->record_indent;
+            worker.record_on = this->record_on;
+            worker.row_count = this->row_count_after( chunk * tokens );
+
+            const size_t end = std::min( runs.size(), (chunk + 1) * tokens );
+            for (size_t token = chunk * tokens; token < end; token++) {
+                const auto& run = runs[token];
+                worker.write_sep( );
+                if (run.defaulted || run.count > 1) {
+                    worker.write_count( run.count );
+                    worker.buffer += '*';
+                }
+                if (!run.defaulted)
+                    worker.write_value( data[run.index] );
+                worker.row_count++;
+            }
+
+            chunks[chunk].swap( worker.buffer );
+        }
+
+        for (const auto& chunk : chunks)
+            this->os.write( chunk.data(), chunk.size() );
+
+        this->row_count = this->row_count_after( runs.size() );
+        this->default_count = trailing_defaults;
+    }
+
+
+    /*
+      The row count after writing a number of tokens from the current
+      position; when a record is active the row count wraps around at
+      'columns'.
+    */
+    size_t DeckOutput::row_count_after( size_t tokens ) const {
+        if (tokens == 0)
+            return this->row_count;
+
+        if (!this->record_on)
+            return this->row_count + tokens;
+
+        return ((this->row_count + tokens - 1) % this->columns) + 1;
+    }
+
+
+    void DeckOutput::write_count( size_t count ) {
+        char buf[24];
+        this->buffer.append( buf, format_integer( static_cast<long long>( count ), buf ) );
+    }
+
+    void DeckOutput::write_defaults( ) {
+        if (default_count > 0) {
+            write_sep( );
+            write_count( default_count );
+            buffer += '*';
+            default_count = 0;
+            row_count++;
+        }
     }
 
     void DeckOutput::stash_default( ) {
         this->default_count++;
     }
 
+    void DeckOutput::stash_default( size_t count ) {
+        this->default_count += count;
+    }
+
 
     void DeckOutput::start_keyword(const std::string& kw) {
-        this->os << kw << std::endl;
+        this->buffer += kw;
+        this->buffer += '\n';
     }
 
 
     void DeckOutput::end_keyword(bool add_slash) {
         if (add_slash)
-            this->os << "/" << std::endl;
+            this->buffer += "/\n";
+        this->flush();
     }
 
 
@@ -93,9 +425,9 @@ namespace Opm {
         }
 
         if (row_count > 0)
-            os << item_sep;
+            buffer += item_sep;
         else if (record_on)
-            os << record_indent;
+            buffer += record_indent;
     }
 
     void DeckOutput::start_record( ) {
@@ -106,18 +438,25 @@ namespace Opm {
 
 
     void DeckOutput::split_record() {
-        this->os << std::endl;
+        this->buffer += '\n';
         this->row_count = 0;
     }
 
 
     void DeckOutput::end_record( ) {
-        this->os << " /" << std::endl;
+        this->buffer += " /\n";
         this->record_on = false;
+        if (buffer.size() > flush_size)
+            this->flush();
     }
 
 
     template void DeckOutput::write( const int& value);
     template void DeckOutput::write( const double& value);
     template void DeckOutput::write( const std::string& value);
+    template void DeckOutput::write( const int& value, size_t count);
+    template void DeckOutput::write( const double& value, size_t count);
+    template void DeckOutput::write_data( const std::vector<int>& data, const std::vector<bool>& defaulted);
+    template void DeckOutput::write_data( const std::vector<double>& data, const std::vector<bool>& defaulted);
+    template void DeckOutput::write_data( const std::vector<std::string>& data, const std::vector<bool>& defaulted);
 }
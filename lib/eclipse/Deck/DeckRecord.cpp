@@ -26,6 +26,8 @@
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
 #include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/Utility/Hash.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 
 namespace Opm {
@@ -173,4 +175,16 @@ namespace Opm {
         return !(*this == other);
     }
 
+    size_t DeckRecord::memoryUsage() const {
+        return memory::heap( this->m_items );
+    }
+
+    uint64_t DeckRecord::hash() const {
+        auto h = hash::combine( hash::seed, this->size() );
+        for (const auto& item : *this)
+            h = hash::combine( h, item.hash() );
+
+        return hash::mix( h );
+    }
+
 }
@@ -18,8 +18,13 @@
 
 
 #include <algorithm>
+#include <exception>
 #include <functional>
+#include <map>
+#include <memory>
 #include <set>
+#include <stdexcept>
+#include <type_traits>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Deck/Section.hpp>
@@ -31,6 +36,8 @@
 #include <opm/parser/eclipse/EclipseState/Grid/MULTREGTScanner.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/SatfuncPropertyInitializers.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 #include <opm/parser/eclipse/Utility/String.hpp>
 
 namespace Opm {
@@ -75,15 +82,21 @@ namespace Opm {
             const auto& ntg =  doubleGridProperties->getKeyword("NTG");
 
             const auto& poroData = poro.getData();
-            for (size_t globalIndex = 0; globalIndex < poro.getCartesianSize(); globalIndex++) {
-                if (!std::isfinite(values[globalIndex])) {
-                    double cell_poro = poroData[globalIndex];
-                    if (std::isnan(cell_poro))
-                        throw std::logic_error("Some cells neither specify the PORV keyword nor PORO");
-
-                    double cell_ntg = ntg.iget(globalIndex);
-                    double cell_volume = eclipseGrid->getCellVolume(globalIndex);
-                    values[globalIndex] = cell_poro * cell_volume * cell_ntg;
+            const bool needVolume = std::any_of( values.begin(), values.end(),
+                                                 []( double value ) { return !std::isfinite( value ); } );
+
+            if (needVolume) {
+                const auto& volume = eclipseGrid->getCellVolumes();
+
+                for (size_t globalIndex = 0; globalIndex < poro.getCartesianSize(); globalIndex++) {
+                    if (!std::isfinite(values[globalIndex])) {
+                        double cell_poro = poroData[globalIndex];
+                        if (std::isnan(cell_poro))
+                            throw std::logic_error("Some cells neither specify the PORV keyword nor PORO");
+
+                        double cell_ntg = ntg.iget(globalIndex);
+                        values[globalIndex] = cell_poro * volume[globalIndex] * cell_ntg;
+                    }
                 }
             }
 
@@ -144,6 +157,50 @@ namespace Opm {
         }
 
 
+        /*
+          The properties initPORV() reads with getKeyword(), and so
+          creates when they are missing. MULTPV is only read when it is
+          present.
+        */
+        std::vector< std::string > porvDependencies( const Deck& deck ) {
+            std::vector< std::string > dependencies = { "PORO", "NTG" };
+            if (!deck.hasKeyword("MULTREGP"))
+                return dependencies;
+
+            const auto& multregpKeyword = deck.getKeyword("MULTREGP");
+            for (size_t recordIdx = 0; recordIdx < multregpKeyword.size(); ++recordIdx) {
+                const auto& record = multregpKeyword.getRecord(recordIdx);
+                const int regionId = record.getItem("REGION").template get<int>(0);
+                if (regionId <= 0)
+                    continue;
+
+                // only the last record of a region index is used
+                const auto later = std::find_if( multregpKeyword.begin() + recordIdx + 1, multregpKeyword.end(),
+                                                 [regionId]( const DeckRecord& record2 ) {
+                                                     return record2.getItem("REGION").template get<int>(0) == regionId;
+                                                 });
+                if (later != multregpKeyword.end())
+                    continue;
+
+                std::string regionType = record.getItem("REGION_TYPE").template get<std::string>(0);
+                uppercase(regionType, regionType);
+
+                std::string region;
+                if (regionType == "M")
+                    region = "MULTNUM";
+                else if (regionType == "F")
+                    region = "FLUXNUM";
+                else if (regionType == "O")
+                    region = "OPERNUM";
+
+                if (!region.empty() && std::find( dependencies.begin(), dependencies.end(), region ) == dependencies.end())
+                    dependencies.push_back( region );
+            }
+
+            return dependencies;
+        }
+
+
         /*
           In this codeblock we explicitly set the ACTNUM value to zero
           for cells with pore volume equal to zero. Observe the
@@ -175,9 +232,11 @@ namespace Opm {
                 const auto& porv = doubleGridProperties->getKeyword("PORV");
                 {
                     const auto& porvData = porv.getData();
-                    for (size_t i = 0; i < porvData.size(); i++)
-                        if (porvData[i] == 0)
-                            values[i] = 0;
+                    GridKernels::forEachChunk( porvData.size(), [&]( size_t begin, size_t end ) {
+                        for (size_t i = begin; i < end; i++)
+                            if (porvData[i] == 0)
+                                values[i] = 0;
+                    });
                 }
             }
         }
@@ -185,6 +244,41 @@ namespace Opm {
 
 
 
+    namespace {
+
+        /* A property in the graph evaluated by Eclipse3DProperties::finalize(). */
+        struct PropertyNode {
+            enum : int { deferred = -1, visiting = -2, unresolved = -3 };
+
+            std::string keyword;
+            bool isInt = false;
+            bool constantDefault = true;
+            bool postProcessor = false;
+            std::vector< std::string > dependencies;
+
+            /* created by the level, rather than evaluated in place */
+            bool create = false;
+            int level = unresolved;
+            std::unique_ptr< GridProperty< double > > created;
+        };
+
+        /* kwInfo is nullptr for a FIPxxx keyword which is not created yet */
+        template< typename T >
+        PropertyNode makeNode( const std::string& keyword,
+                               const GridPropertySupportedKeywordInfo< T >* kwInfo ) {
+            PropertyNode node;
+            node.keyword = keyword;
+            node.isInt = std::is_same< T, int >::value;
+            if (kwInfo) {
+                node.constantDefault = kwInfo->hasConstantDefault();
+                node.postProcessor = kwInfo->hasPostProcessor();
+                node.dependencies = kwInfo->dependencies();
+            }
+            return node;
+        }
+    }
+
+
     static std::vector< GridProperties< int >::SupportedKeywordInfo >
     makeSupportedIntKeywords() {
          /*
@@ -260,112 +354,119 @@ namespace Opm {
 
         const auto distributeTopLayer = std::bind( &distTopLayer, _1, eclipseGrid );
 
+        /* the region properties read by the initializers, see finalize() */
+        const std::vector< std::string > satnumRegions = { "SATNUM", "ENDNUM" };
+        const std::vector< std::string > imbnumRegions = { "IMBNUM", "ENDNUM" };
+        std::vector< std::string > tempRegions;
+        if (tableManager->hasTables("RTEMPVD"))
+            tempRegions.push_back( "EQLNUM" );
+
         std::vector< GridProperties< double >::SupportedKeywordInfo > supportedDoubleKeywords;
 
         // keywords to specify the scaled connate gas saturations.
         for( const auto& kw : { "SGL", "SGLX", "SGLX-", "SGLY", "SGLY-", "SGLZ", "SGLZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SGLLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SGLLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISGL", "ISGLX", "ISGLX-", "ISGLY", "ISGLY-", "ISGLZ", "ISGLZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISGLLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISGLLookup, imbnumRegions, "1" );
 
         // keywords to specify the connate water saturation.
         for( const auto& kw : { "SWL", "SWLX", "SWLX-", "SWLY", "SWLY-", "SWLZ", "SWLZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SWLLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SWLLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISWL", "ISWLX", "ISWLX-", "ISWLY", "ISWLY-", "ISWLZ", "ISWLZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISWLLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISWLLookup, imbnumRegions, "1" );
 
         // keywords to specify the maximum gas saturation.
         for( const auto& kw : { "SGU", "SGUX", "SGUX-", "SGUY", "SGUY-", "SGUZ", "SGUZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SGULookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SGULookup, satnumRegions, "1" );
         for( const auto& kw : { "ISGU", "ISGUX", "ISGUX-", "ISGUY", "ISGUY-", "ISGUZ", "ISGUZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISGULookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISGULookup, imbnumRegions, "1" );
 
         // keywords to specify the maximum water saturation.
         for( const auto& kw : { "SWU", "SWUX", "SWUX-", "SWUY", "SWUY-", "SWUZ", "SWUZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SWULookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SWULookup, satnumRegions, "1" );
         for( const auto& kw : { "ISWU", "ISWUX", "ISWUX-", "ISWUY", "ISWUY-", "ISWUZ", "ISWUZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISWULookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISWULookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled critical gas saturation.
         for( const auto& kw : { "SGCR", "SGCRX", "SGCRX-", "SGCRY", "SGCRY-", "SGCRZ", "SGCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SGCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SGCRLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISGCR", "ISGCRX", "ISGCRX-", "ISGCRY", "ISGCRY-", "ISGCRZ", "ISGCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISGCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISGCRLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled critical oil-in-water saturation.
         for( const auto& kw : { "SOWCR", "SOWCRX", "SOWCRX-", "SOWCRY", "SOWCRY-", "SOWCRZ", "SOWCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SOWCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SOWCRLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISOWCR", "ISOWCRX", "ISOWCRX-", "ISOWCRY", "ISOWCRY-", "ISOWCRZ", "ISOWCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISOWCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISOWCRLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled critical oil-in-gas saturation.
         for( const auto& kw : { "SOGCR", "SOGCRX", "SOGCRX-", "SOGCRY", "SOGCRY-", "SOGCRZ", "SOGCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SOGCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SOGCRLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISOGCR", "ISOGCRX", "ISOGCRX-", "ISOGCRY", "ISOGCRY-", "ISOGCRZ", "ISOGCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISOGCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISOGCRLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled critical water saturation.
         for( const auto& kw : { "SWCR", "SWCRX", "SWCRX-", "SWCRY", "SWCRY-", "SWCRZ", "SWCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, SWCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, SWCRLookup, satnumRegions, "1" );
         for( const auto& kw : { "ISWCR", "ISWCRX", "ISWCRX-", "ISWCRY", "ISWCRY-", "ISWCRZ", "ISWCRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, ISWCRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, ISWCRLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled oil-water capillary pressure
         for( const auto& kw : { "PCW", "PCWX", "PCWX-", "PCWY", "PCWY-", "PCWZ", "PCWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, PCWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, PCWLookup, satnumRegions, "1" );
         for( const auto& kw : { "IPCW", "IPCWX", "IPCWX-", "IPCWY", "IPCWY-", "IPCWZ", "IPCWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IPCWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IPCWLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled gas-oil capillary pressure
         for( const auto& kw : { "PCG", "PCGX", "PCGX-", "PCGY", "PCGY-", "PCGZ", "PCGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, PCGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, PCGLookup, satnumRegions, "1" );
         for( const auto& kw : { "IPCG", "IPCGX", "IPCGX-", "IPCGY", "IPCGY-", "IPCGZ", "IPCGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IPCGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IPCGLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled water relative permeability
         for( const auto& kw : { "KRW", "KRWX", "KRWX-", "KRWY", "KRWY-", "KRWZ", "KRWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, KRWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KRWLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRW", "IKRWX", "IKRWX-", "IKRWY", "IKRWY-", "IKRWZ", "IKRWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRWLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled water relative permeability at the critical
         // saturation
         for( const auto& kw : { "KRWR" , "KRWRX" , "KRWRX-" , "KRWRY" , "KRWRY-" , "KRWRZ" , "KRWRZ-"  } )
-            supportedDoubleKeywords.emplace_back( kw, KRWRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KRWRLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRWR" , "IKRWRX" , "IKRWRX-" , "IKRWRY" , "IKRWRY-" , "IKRWRZ" , "IKRWRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRWRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRWRLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled oil relative permeability
         for( const auto& kw : { "KRO", "KROX", "KROX-", "KROY", "KROY-", "KROZ", "KROZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, KROLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KROLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRO", "IKROX", "IKROX-", "IKROY", "IKROY-", "IKROZ", "IKROZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKROLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKROLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled water relative permeability at the critical
         // water saturation
         for( const auto& kw : { "KRORW", "KRORWX", "KRORWX-", "KRORWY", "KRORWY-", "KRORWZ", "KRORWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, KRORWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KRORWLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRORW", "IKRORWX", "IKRORWX-", "IKRORWY", "IKRORWY-", "IKRORWZ", "IKRORWZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRORWLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRORWLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled water relative permeability at the critical
         // water saturation
         for( const auto& kw : { "KRORG", "KRORGX", "KRORGX-", "KRORGY", "KRORGY-", "KRORGZ", "KRORGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, KRORGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KRORGLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRORG", "IKRORGX", "IKRORGX-", "IKRORGY", "IKRORGY-", "IKRORGZ", "IKRORGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRORGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRORGLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled gas relative permeability
         for( const auto& kw : { "KRG", "KRGX", "KRGX-", "KRGY", "KRGY-", "KRGZ", "KRGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, KRGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, KRGLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRG", "IKRGX", "IKRGX-", "IKRGY", "IKRGY-", "IKRGZ", "IKRGZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRGLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRGLookup, imbnumRegions, "1" );
 
         // keywords to specify the scaled gas relative permeability
         for( const auto& kw : { "KRGR", "KRGRX", "KRGRX-", "KRGRY", "KRGRY-", "KRGRZ", "KRGRZ-" } )
-             supportedDoubleKeywords.emplace_back( kw, KRGRLookup, "1" );
+             supportedDoubleKeywords.emplace_back( kw, KRGRLookup, satnumRegions, "1" );
         for( const auto& kw : { "IKRGR", "IKRGRX", "IKRGRX-", "IKRGRY", "IKRGRY-", "IKRGRZ", "IKRGRZ-" } )
-            supportedDoubleKeywords.emplace_back( kw, IKRGRLookup, "1" );
+            supportedDoubleKeywords.emplace_back( kw, IKRGRLookup, imbnumRegions, "1" );
 
         // Solution keywords - required fror enumerated restart.
         supportedDoubleKeywords.emplace_back( "PRESSURE", 0.0 , "Pressure" );
@@ -378,7 +479,7 @@ namespace Opm {
 
 
         // cell temperature (E300 only, but makes a lot of sense for E100, too)
-        supportedDoubleKeywords.emplace_back( "TEMPI", tempLookup, "Temperature" );
+        supportedDoubleKeywords.emplace_back( "TEMPI", tempLookup, tempRegions, "Temperature" );
 
         const double nan = std::numeric_limits<double>::quiet_NaN();
         // porosity
@@ -497,6 +598,7 @@ namespace Opm {
             m_doubleGridProperties.postAddKeyword( "PORV",
                                                    std::numeric_limits<double>::quiet_NaN(),
                                                    initPORVProcessor,
+                                                   porvDependencies( deck ),
                                                    "Volume" );
         }
 
@@ -508,6 +610,7 @@ namespace Opm {
             m_intGridProperties.postAddKeyword( "ACTNUM",
                                                 1,
                                                 actnumPP ,
+                                                { "PORV" },
                                                 "1");
         }
 
@@ -715,8 +818,13 @@ namespace Opm {
         BoxManager boxManager(eclipseGrid.getNX(),
                               eclipseGrid.getNY(),
                               eclipseGrid.getNZ());
+        SectionEdits edits;
 
         for( const auto& deckKeyword : section ) {
+            const auto& name = deckKeyword.name();
+            if (name != "BOX" && name != "ENDBOX" && name != "COPY"
+                && name != "EQUALS" && name != "ADD" && name != "MULTIPLY")
+                edits.apply();
 
             if (supportsGridProperty(deckKeyword.name()) )
                 loadGridPropertyFromDeckKeyword( boxManager.getActiveBox(),
@@ -730,17 +838,17 @@ namespace Opm {
 
 
                 else if (deckKeyword.name() == "COPY")
-                    handleCOPYKeyword( deckKeyword , boxManager);
+                    handleCOPYKeyword( deckKeyword , boxManager, edits);
 
                 else if (deckKeyword.name() == "EQUALS")
-                    handleEQUALSKeyword(deckKeyword, boxManager);
+                    handleEQUALSKeyword(deckKeyword, boxManager, edits);
 
 
                 else if (deckKeyword.name() == "ADD")
-                    handleADDKeyword( deckKeyword , boxManager);
+                    handleADDKeyword( deckKeyword , boxManager, edits);
 
                 else if (deckKeyword.name() == "MULTIPLY")
-                    handleMULTIPLYKeyword(deckKeyword, boxManager);
+                    handleMULTIPLYKeyword(deckKeyword, boxManager, edits);
 
 
                 else if (deckKeyword.name() == "EQUALREG")
@@ -761,6 +869,7 @@ namespace Opm {
                 boxManager.endKeyword();
             }
         }
+        edits.apply();
         boxManager.endSection();
     }
 
@@ -858,14 +967,14 @@ namespace Opm {
 
 
 
-    void Eclipse3DProperties::handleMULTIPLYKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager) {
+    void Eclipse3DProperties::handleMULTIPLYKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits) {
         for( const auto& record : deckKeyword ) {
             const std::string& field = record.getItem("field").get< std::string >(0);
 
             if (m_doubleGridProperties.hasKeyword( field ))
-                m_doubleGridProperties.handleMULTIPLYRecord( record , boxManager );
+                m_doubleGridProperties.handleMULTIPLYRecord( record , boxManager, edits.doubleEdits );
             else if (m_intGridProperties.hasKeyword( field ))
-                m_intGridProperties.handleMULTIPLYRecord( record , boxManager );
+                m_intGridProperties.handleMULTIPLYRecord( record , boxManager, edits.intEdits );
             else
                 throw std::invalid_argument("Fatal error processing MULTIPLY keyword. Tried to shift not defined keyword " + field);
 
@@ -878,14 +987,14 @@ namespace Opm {
       some state dependent semantics regarding endpoint scaling arrays
       in the PROPS section. That is not supported.
     */
-    void Eclipse3DProperties::handleADDKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager) {
+    void Eclipse3DProperties::handleADDKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits) {
         for( const auto& record : deckKeyword ) {
             const std::string& field = record.getItem("field").get< std::string >(0);
 
             if (m_doubleGridProperties.hasKeyword( field ))
-                m_doubleGridProperties.handleADDRecord( record , boxManager );
+                m_doubleGridProperties.handleADDRecord( record , boxManager, edits.doubleEdits );
             else if (m_intGridProperties.hasKeyword( field ))
-                m_intGridProperties.handleADDRecord( record , boxManager );
+                m_intGridProperties.handleADDRecord( record , boxManager, edits.intEdits );
             else
                 throw std::invalid_argument("Fatal error processing ADD keyword. Tried to shift not defined keyword " + field);
 
@@ -893,14 +1002,19 @@ namespace Opm {
     }
 
 
-    void Eclipse3DProperties::handleCOPYKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager) {
+    void Eclipse3DProperties::handleCOPYKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits) {
         for( const auto& record : deckKeyword ) {
             const std::string& field = record.getItem("src").get< std::string >(0);
+            const std::string& target = record.getItem("target").get< std::string >(0);
+
+            /* creating the target runs its initializer, which may read other properties */
+            if (!m_doubleGridProperties.hasKeyword( target ) && !m_intGridProperties.hasKeyword( target ))
+                edits.apply();
 
             if (m_doubleGridProperties.hasKeyword( field ))
-                m_doubleGridProperties.handleCOPYRecord( record , boxManager );
+                m_doubleGridProperties.handleCOPYRecord( record , boxManager, edits.doubleEdits );
             else if (m_intGridProperties.hasKeyword( field ))
-                m_intGridProperties.handleCOPYRecord( record , boxManager );
+                m_intGridProperties.handleCOPYRecord( record , boxManager, edits.intEdits );
             else
                 throw std::invalid_argument("Fatal error processing COPY keyword. Tried to copy not defined keyword " + field);
 
@@ -908,14 +1022,18 @@ namespace Opm {
     }
 
 
-    void Eclipse3DProperties::handleEQUALSKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager) {
+    void Eclipse3DProperties::handleEQUALSKeyword( const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits) {
         for( const auto& record : deckKeyword ) {
             const std::string& field = record.getItem("field").get< std::string >(0);
 
+            /* creating the property runs its initializer, which may read other properties */
+            if (!m_doubleGridProperties.hasKeyword( field ) && !m_intGridProperties.hasKeyword( field ))
+                edits.apply();
+
             if (m_doubleGridProperties.supportsKeyword( field ))
-                m_doubleGridProperties.handleEQUALSRecord( record , boxManager );
+                m_doubleGridProperties.handleEQUALSRecord( record , boxManager, edits.doubleEdits );
             else if (m_intGridProperties.supportsKeyword( field ))
-                m_intGridProperties.handleEQUALSRecord( record , boxManager );
+                m_intGridProperties.handleEQUALSRecord( record , boxManager, edits.intEdits );
             else
                 throw std::invalid_argument("Fatal error processing EQUALS keyword. Tried to assign not defined keyword " + field);
 
@@ -931,6 +1049,207 @@ namespace Opm {
         return messages;
     }
 
+    void Eclipse3DProperties::memoryUsage(MemoryUsage& usage) const {
+        m_intGridProperties.memoryUsage(usage, "GridProperties/int");
+        m_doubleGridProperties.memoryUsage(usage, "GridProperties/double");
+        if (m_globalMap)
+            usage.add("GridProperties/globalMap", memory::heap(m_globalMap));
+    }
+
+    void Eclipse3DProperties::finalize( const std::vector< std::string >& keywords ) {
+        const auto describe = [this]( const std::string& keyword ) -> PropertyNode {
+            if (m_intGridProperties.supportsKeyword( keyword ))
+                return makeNode( keyword, m_intGridProperties.keywordInfo( keyword ) );
+            if (m_doubleGridProperties.supportsKeyword( keyword ))
+                return makeNode( keyword, m_doubleGridProperties.keywordInfo( keyword ) );
+
+            throw std::invalid_argument("Grid property " + keyword + " is unsupported!");
+        };
+
+        const auto exists = [this]( const std::string& keyword ) {
+            return m_intGridProperties.hasKeyword( keyword ) || m_doubleGridProperties.hasKeyword( keyword );
+        };
+
+        /* auto generate, without running the post processor */
+        const auto generate = [this]( const PropertyNode& node ) {
+            if (node.isInt)
+                m_intGridProperties.addAutoGeneratedKeyword_( node.keyword );
+            else
+                m_doubleGridProperties.addAutoGeneratedKeyword_( node.keyword );
+        };
+
+        std::vector< PropertyNode > nodes;
+        std::map< std::string, size_t > index;
+        const auto addNode = [&]( const std::string& keyword ) {
+            if (index.count( keyword ) > 0)
+                return;
+
+            index.emplace( keyword, nodes.size() );
+            nodes.push_back( describe( keyword ) );
+        };
+
+        for (const auto& pair : m_intGridProperties.m_properties)
+            if (pair.second.getKeywordInfo().hasPostProcessor())
+                addNode( pair.first );
+        for (const auto& pair : m_doubleGridProperties.m_properties)
+            if (pair.second.getKeywordInfo().hasPostProcessor())
+                addNode( pair.first );
+        for (const auto& keyword : keywords)
+            addNode( uppercase( keyword ) );
+
+        /*
+          The requested properties with an initializer function are
+          created by their level; the others are just a constant, and
+          are generated right away.
+        */
+        for (auto& node : nodes) {
+            if (exists( node.keyword ))
+                continue;
+
+            if (node.isInt || node.constantDefault)
+                generate( node );
+            else
+                node.create = true;
+        }
+
+        std::function< int( size_t ) > resolve = [&]( size_t n ) -> int {
+            if (nodes[ n ].level == PropertyNode::visiting)
+                throw std::logic_error("Cyclic dependency of the grid property " + nodes[ n ].keyword);
+            if (nodes[ n ].level != PropertyNode::unresolved)
+                return nodes[ n ].level;
+
+            nodes[ n ].level = PropertyNode::visiting;
+            int level = 0;
+            for (const auto& dependency : nodes[ n ].dependencies) {
+                const auto iter = index.find( dependency );
+                if (iter != index.end()) {
+                    const int dependencyLevel = resolve( iter->second );
+                    if (dependencyLevel == PropertyNode::deferred) {
+                        level = PropertyNode::deferred;
+                        break;
+                    }
+                    level = std::max( level, dependencyLevel + 1 );
+                }
+                else if (!exists( dependency )) {
+                    const auto missing = describe( dependency );
+                    if (missing.postProcessor) {
+                        level = PropertyNode::deferred;
+                        break;
+                    }
+                    generate( missing );
+                }
+            }
+
+            nodes[ n ].level = level;
+            return level;
+        };
+
+        std::vector< std::vector< size_t > > levels;
+        std::vector< size_t > deferred;
+        for (size_t n = 0; n < nodes.size(); n++) {
+            const int level = resolve( n );
+            if (level == PropertyNode::deferred) {
+                deferred.push_back( n );
+                continue;
+            }
+
+            if (levels.size() <= size_t( level ))
+                levels.resize( level + 1 );
+            levels[ level ].push_back( n );
+        }
+
+        const auto evaluate = [this]( PropertyNode& node ) {
+            if (node.create) {
+                node.created.reset( new GridProperty< double >( m_doubleGridProperties.createProperty( node.keyword ) ) );
+                node.created->runPostProcessor();
+            }
+            else if (node.isInt)
+                getIntGridProperty( node.keyword );
+            else
+                getDoubleGridProperty( node.keyword );
+        };
+
+        for (const auto& level : levels) {
+            /*
+              The first lookup of a property can generate it, and runs
+              its post processor; neither is synchronised, the
+              m_hasRunPostProcessor flag is a plain bool. A dependency
+              shared by several nodes of the level is therefore looked
+              up once, serially, before they run. Reading the data does
+              not change the storage of the property.
+            */
+            std::map< std::string, size_t > readers;
+            for (const auto n : level)
+                for (const auto& dependency : nodes[ n ].dependencies)
+                    readers[ dependency ]++;
+
+            for (const auto& pair : readers) {
+                if (pair.second < 2)
+                    continue;
+
+                if (m_intGridProperties.supportsKeyword( pair.first ))
+                    getIntGridProperty( pair.first );
+                else
+                    getDoubleGridProperty( pair.first );
+            }
+
+            std::vector< std::exception_ptr > errors( level.size() );
+            const long long count = level.size();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(GridKernels::threads())
+#endif
+            for (long long i = 0; i < count; i++) {
+                try {
+                    evaluate( nodes[ level[ i ] ] );
+                } catch (...) {
+                    errors[ i ] = std::current_exception();
+                }
+            }
+
+            for (const auto& error : errors)
+                if (error)
+                    std::rethrow_exception( error );
+
+            for (const auto n : level) {
+                if (!nodes[ n ].created)
+                    continue;
+
+                m_doubleGridProperties.insertAutoGenerated( std::move( *nodes[ n ].created ) );
+                nodes[ n ].created.reset();
+            }
+        }
+
+        for (const auto n : deferred) {
+            if (nodes[ n ].isInt)
+                getIntGridProperty( nodes[ n ].keyword );
+            else
+                getDoubleGridProperty( nodes[ n ].keyword );
+        }
+    }
+
+
+    void Eclipse3DProperties::compress( const EclipseGrid& eclipseGrid ) {
+        if (eclipseGrid.allActive())
+            return;
+
+        /*
+          A post processor can create and read other properties, so they
+          all run before the first property is compressed.
+        */
+        finalize();
+
+        if (!m_globalMap || *m_globalMap != eclipseGrid.getGlobalMap())
+            m_globalMap = std::make_shared< const std::vector< int > >( eclipseGrid.getGlobalMap() );
+
+        for (auto& pair : m_intGridProperties.m_properties)
+            if (pair.first != "ACTNUM")
+                pair.second.compress( m_globalMap );
+
+        for (auto& pair : m_doubleGridProperties.m_properties)
+            pair.second.compress( m_globalMap );
+    }
+
 
     void Eclipse3DProperties::setKeywordBox( const DeckKeyword& deckKeyword,
                                            const DeckRecord& deckRecord,
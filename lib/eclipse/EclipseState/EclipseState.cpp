@@ -44,6 +44,7 @@
 #include <opm/parser/eclipse/Units/Dimension.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 
 namespace Opm {
@@ -60,6 +61,7 @@ namespace Opm {
         m_simulationConfig(  deck, m_eclipseProperties ),
         m_transMult(         GridDims(deck), deck, m_eclipseProperties )
     {
+        m_eclipseProperties.finalize();
         m_inputGrid.resetACTNUM(m_eclipseProperties.getIntGridProperty("ACTNUM").getData().data());
 
         if( this->runspec().phases().size() < 3 )
@@ -119,6 +121,16 @@ namespace Opm {
         return m_messageContainer;
     }
 
+    void EclipseState::memoryUsage( MemoryUsage& usage ) const {
+        m_inputGrid.memoryUsage( usage );
+        m_eclipseProperties.memoryUsage( usage );
+        m_tables.memoryUsage( usage );
+
+        usage.add( "EclipseState/nnc", memory::heap( m_inputNnc.nncdata() ) );
+        usage.add( "EclipseState/transMult", m_transMult.memoryUsage() );
+        usage.add( "EclipseState/messages", m_messageContainer.memoryUsage() );
+    }
+
 
     const TableManager& EclipseState::getTableManager() const {
         return m_tables;
@@ -232,6 +244,10 @@ namespace Opm {
         }
     }
 
+    void EclipseState::compressProperties() {
+        m_eclipseProperties.compress( m_inputGrid );
+    }
+
     void EclipseState::applyModifierDeck(const Deck& deck) {
         using namespace ParserKeywords;
         for (const auto& keyword : deck) {
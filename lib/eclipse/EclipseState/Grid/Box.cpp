@@ -46,7 +46,6 @@ namespace Opm {
         m_stride[2] = m_dims[0] * m_dims[1];
 
         m_isGlobal = true;
-        initIndexList();
     }
 
 
@@ -71,8 +70,6 @@ namespace Opm {
             m_isGlobal = true;
         else
             m_isGlobal = false;
-
-        initIndexList();
     }
 
 
@@ -103,40 +100,81 @@ namespace Opm {
     }
 
 
+    size_t Box::getOffset(size_t idim) const {
+        if (idim >= 3)
+            throw std::invalid_argument("The input dimension value is invalid");
+
+        return m_offset[idim];
+    }
+
+
 
-    std::vector<size_t>::const_iterator Box::begin() const {
-        return m_indexList.begin();
+    Box::const_iterator Box::begin() const {
+        return const_iterator( this, 0 );
     }
 
-    std::vector<size_t>::const_iterator Box::end() const {
-        return m_indexList.end();
+    Box::const_iterator Box::end() const {
+        return const_iterator( this, m_dims[2] );
     }
 
 
     const std::vector<size_t>& Box::getIndexList() const {
+        if (m_indexList.size() != size()) {
+            m_indexList.reserve( size() );
+            forEachRun( [this]( size_t start, size_t, size_t length ) {
+                for (size_t g = start; g < start + length; g++)
+                    m_indexList.push_back( g );
+            });
+        }
+
         return m_indexList;
     }
 
 
-    void Box::initIndexList() {
-        m_indexList.resize( size() );
+    Box::const_iterator::const_iterator( const Box* box, size_t k ) :
+        m_box( box )
+    {
+        m_ijk[2] = k;
+        update();
+    }
 
-        size_t ii,ij,ik;
-        size_t l = 0;
+    void Box::const_iterator::update() {
+        m_global = (m_ijk[0] + m_box->m_offset[0]) * m_box->m_stride[0]
+                 + (m_ijk[1] + m_box->m_offset[1]) * m_box->m_stride[1]
+                 + (m_ijk[2] + m_box->m_offset[2]) * m_box->m_stride[2];
+    }
 
-        for (ik=0; ik < m_dims[2]; ik++) {
-            size_t k = ik + m_offset[2];
-            for (ij=0; ij < m_dims[1]; ij++) {
-                size_t j = ij + m_offset[1];
-                for (ii=0; ii < m_dims[0]; ii++) {
-                    size_t i = ii + m_offset[0];
-                    size_t g = i * m_stride[0] + j*m_stride[1] + k*m_stride[2];
+    Box::const_iterator& Box::const_iterator::operator++() {
+        if (++m_ijk[0] < m_box->m_dims[0]) {
+            m_global++;
+            return *this;
+        }
 
-                    m_indexList[l] = g;
-                    l++;
-                }
-            }
+        m_ijk[0] = 0;
+        if (++m_ijk[1] == m_box->m_dims[1]) {
+            m_ijk[1] = 0;
+            m_ijk[2]++;
         }
+
+        update();
+        return *this;
+    }
+
+    Box::const_iterator Box::const_iterator::operator++( int ) {
+        auto copy = *this;
+        ++(*this);
+        return copy;
+    }
+
+    bool Box::const_iterator::operator==( const const_iterator& other ) const {
+        return m_box == other.m_box
+            && m_ijk[0] == other.m_ijk[0]
+            && m_ijk[1] == other.m_ijk[1]
+            && m_ijk[2] == other.m_ijk[2];
+    }
+
+    bool Box::const_iterator::operator!=( const const_iterator& other ) const {
+        return !(*this == other);
     }
 
     bool Box::equal(const Box& other) const {
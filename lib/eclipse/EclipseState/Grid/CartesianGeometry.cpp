@@ -0,0 +1,315 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/EclipseState/Grid/CartesianGeometry.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
+namespace Opm {
+
+namespace {
+
+    void assertSize( const std::vector< double >& v, size_t dim_size, size_t size, const std::string& name ) {
+        if( v.size() != dim_size && v.size() != size )
+            throw std::invalid_argument( name + " has wrong size: " + std::to_string( v.size() ) );
+    }
+
+    std::vector< double > offsets( const std::vector< double >& v, size_t dim_size ) {
+        if( v.size() != dim_size ) return {};
+
+        std::vector< double > offset( dim_size + 1, 0.0 );
+        for( size_t n = 0; n < dim_size; n++ )
+            offset[n + 1] = offset[n] + v[n];
+
+        return offset;
+    }
+
+}
+
+    CartesianGeometry::CartesianGeometry( size_t nx_, size_t ny_, size_t nz_,
+                                          std::vector< double > dx,
+                                          std::vector< double > dy,
+                                          std::vector< double > dz,
+                                          std::vector< double > tops ) :
+        nx( nx_ ), ny( ny_ ), nz( nz_ ),
+        m_dx( std::move( dx ) ),
+        m_dy( std::move( dy ) ),
+        m_dz( std::move( dz ) ),
+        m_tops( std::move( tops ) )
+    {
+        const size_t size = nx * ny * nz;
+        assertSize( m_dx, nx, size, "DX" );
+        assertSize( m_dy, ny, size, "DY" );
+        assertSize( m_dz, nz, size, "DZ" );
+
+        if( m_tops.size() != size && !( m_tops.size() == nx * ny && m_dz.size() == nz ) )
+            throw std::invalid_argument( "TOPS has wrong size: " + std::to_string( m_tops.size() ) );
+
+        m_xv = offsets( m_dx, nx );
+        m_yv = offsets( m_dy, ny );
+        m_zv = offsets( m_dz, nz );
+    }
+
+    size_t CartesianGeometry::getNX() const {
+        return this->nx;
+    }
+
+    size_t CartesianGeometry::getNY() const {
+        return this->ny;
+    }
+
+    size_t CartesianGeometry::getNZ() const {
+        return this->nz;
+    }
+
+    size_t CartesianGeometry::globalIndex( size_t i, size_t j, size_t k ) const {
+        return i + j * this->nx + k * this->nx * this->ny;
+    }
+
+    double CartesianGeometry::dx( size_t i, size_t j, size_t k ) const {
+        return m_dx.size() == this->nx ? m_dx[i] : m_dx[ this->globalIndex( i, j, k ) ];
+    }
+
+    double CartesianGeometry::dy( size_t i, size_t j, size_t k ) const {
+        return m_dy.size() == this->ny ? m_dy[j] : m_dy[ this->globalIndex( i, j, k ) ];
+    }
+
+    double CartesianGeometry::dz( size_t i, size_t j, size_t k ) const {
+        return m_dz.size() == this->nz ? m_dz[k] : m_dz[ this->globalIndex( i, j, k ) ];
+    }
+
+    double CartesianGeometry::top( size_t i, size_t j, size_t k ) const {
+        if( m_tops.size() == this->nx * this->ny * this->nz )
+            return m_tops[ this->globalIndex( i, j, k ) ];
+
+        return m_tops[ i + j * this->nx ] + m_zv[k];
+    }
+
+    /*
+      The x and y coordinates of the low corner of the cell. For axis
+      compressed dx and dy the offsets are looked up in m_xv and m_yv;
+      for cellwise values in the cell offsets.
+    */
+    std::array< double, 2 > CartesianGeometry::origin( size_t i, size_t j, size_t k ) const {
+        if( !m_xv.empty() && !m_yv.empty() )
+            return {{ m_xv[i], m_yv[j] }};
+
+        const auto& offsets = this->cellOffsets();
+        const size_t g = this->globalIndex( i, j, k );
+        return {{ m_xv.empty() ? offsets.x[g] : m_xv[i],
+                  m_yv.empty() ? offsets.y[g] : m_yv[j] }};
+    }
+
+    /*
+      The sizes along each row, and column, are summed once for all the
+      cells; summing them per call made a loop over the cells quadratic
+      in nx and ny. If another thread built the offsets first, its copy
+      is returned.
+    */
+    const CartesianGeometry::CellOffsets& CartesianGeometry::cellOffsets() const {
+        auto offsets = std::atomic_load( &this->m_offsets );
+        if( offsets ) return *offsets;
+
+        auto built = std::make_shared< CellOffsets >();
+        if( m_xv.empty() ) {
+            built->x.resize( this->nx * this->ny * this->nz );
+            for( size_t k = 0; k < this->nz; k++ )
+                for( size_t j = 0; j < this->ny; j++ ) {
+                    double x0 = 0;
+                    for( size_t i = 0; i < this->nx; i++ ) {
+                        built->x[ this->globalIndex( i, j, k ) ] = x0;
+                        x0 += this->dx( i, j, k );
+                    }
+                }
+        }
+
+        if( m_yv.empty() ) {
+            built->y.resize( this->nx * this->ny * this->nz );
+            for( size_t k = 0; k < this->nz; k++ )
+                for( size_t i = 0; i < this->nx; i++ ) {
+                    double y0 = 0;
+                    for( size_t j = 0; j < this->ny; j++ ) {
+                        built->y[ this->globalIndex( i, j, k ) ] = y0;
+                        y0 += this->dy( i, j, k );
+                    }
+                }
+        }
+
+        std::shared_ptr< const CellOffsets > view = built;
+        if( std::atomic_compare_exchange_strong( &this->m_offsets, &offsets, view ) )
+            offsets = view;
+
+        return *offsets;
+    }
+
+    std::array< double, 3 > CartesianGeometry::getCornerPos( size_t i, size_t j, size_t k, size_t corner ) const {
+        if( i >= this->nx || j >= this->ny || k >= this->nz || corner >= 8 )
+            throw std::invalid_argument( "Invalid cell or corner argument" );
+
+        const auto xy = this->origin( i, j, k );
+        return {{ xy[0] + ( corner & 1 ? this->dx( i, j, k ) : 0.0 ),
+                  xy[1] + ( corner & 2 ? this->dy( i, j, k ) : 0.0 ),
+                  this->top( i, j, k ) + ( corner & 4 ? this->dz( i, j, k ) : 0.0 ) }};
+    }
+
+    double CartesianGeometry::volume( size_t i, size_t j, size_t k ) const {
+        return this->dx( i, j, k ) * this->dy( i, j, k ) * this->dz( i, j, k );
+    }
+
+    std::array< double, 3 > CartesianGeometry::center( size_t i, size_t j, size_t k ) const {
+        const auto xy = this->origin( i, j, k );
+        return {{ xy[0] + this->dx( i, j, k ) / 2,
+                  xy[1] + this->dy( i, j, k ) / 2,
+                  this->top( i, j, k ) + this->dz( i, j, k ) / 2 }};
+    }
+
+    /*
+      The x and y coordinates of the (nx + 1) * (ny + 1) pillars in
+      layer k. The pillars on the high i (j) boundary take their
+      position from the last cell in the row (column).
+    */
+    void CartesianGeometry::pillarOffsets( size_t k, std::vector< double >& x, std::vector< double >& y ) const {
+        x.resize( ( this->nx + 1 ) * ( this->ny + 1 ) );
+        y.resize( x.size() );
+
+        for( size_t pj = 0; pj <= this->ny; pj++ ) {
+            const size_t j = std::min( pj, this->ny - 1 );
+            double offset = 0;
+            for( size_t pi = 0; pi <= this->nx; pi++ ) {
+                x[ pi + pj * ( this->nx + 1 ) ] = offset;
+                if( pi < this->nx ) offset += this->dx( pi, j, k );
+            }
+        }
+
+        for( size_t pi = 0; pi <= this->nx; pi++ ) {
+            const size_t i = std::min( pi, this->nx - 1 );
+            double offset = 0;
+            for( size_t pj = 0; pj <= this->ny; pj++ ) {
+                y[ pi + pj * ( this->nx + 1 ) ] = offset;
+                if( pj < this->ny ) offset += this->dy( i, pj, k );
+            }
+        }
+    }
+
+    void CartesianGeometry::exportCOORD( std::vector< double >& coord ) const {
+        std::vector< double > top_x, top_y, bottom_x, bottom_y;
+        this->pillarOffsets( 0, top_x, top_y );
+        this->pillarOffsets( this->nz - 1, bottom_x, bottom_y );
+
+        GridMemory::resize( coord, 6 * top_x.size() );
+        for( size_t pj = 0; pj <= this->ny; pj++ ) {
+            for( size_t pi = 0; pi <= this->nx; pi++ ) {
+                const size_t p = pi + pj * ( this->nx + 1 );
+                const size_t i = std::min( pi, this->nx - 1 );
+                const size_t j = std::min( pj, this->ny - 1 );
+                const size_t k = this->nz - 1;
+
+                coord[6 * p + 0] = top_x[p];
+                coord[6 * p + 1] = top_y[p];
+                coord[6 * p + 2] = this->top( i, j, 0 );
+                coord[6 * p + 3] = bottom_x[p];
+                coord[6 * p + 4] = bottom_y[p];
+                coord[6 * p + 5] = this->top( i, j, k ) + this->dz( i, j, k );
+            }
+        }
+    }
+
+    void CartesianGeometry::exportZCORN( std::vector< double >& zcorn ) const {
+        const ZcornMapper mapper( this->nx, this->ny, this->nz );
+        GridMemory::resize( zcorn, mapper.size() );
+
+        /*
+          The loops stay within the dimensions, so the corner offsets are
+          computed directly instead of through the checked
+          ZcornMapper::index().
+        */
+        const size_t shift[4] = { 0, 1, 2 * this->nx, 2 * this->nx + 1 };
+        const size_t layer = 4 * this->nx * this->ny;
+        double* z = zcorn.data();
+
+        for( size_t k = 0; k < this->nz; k++ ) {
+            for( size_t j = 0; j < this->ny; j++ ) {
+                for( size_t i = 0; i < this->nx; i++ ) {
+                    const double top = this->top( i, j, k );
+                    const double bottom = top + this->dz( i, j, k );
+                    const size_t base = 2 * i + 4 * this->nx * j + 2 * layer * k;
+
+                    for( int c = 0; c < 4; c++ ) {
+                        z[ base + shift[c] ] = top;
+                        z[ base + layer + shift[c] ] = bottom;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector< double > CartesianGeometry::expand( const std::vector< double >& v, size_t dim ) const {
+        const size_t size = this->nx * this->ny * this->nz;
+        if( v.size() == size ) return v;
+
+        std::vector< double > expanded( size );
+        for( size_t k = 0; k < this->nz; k++ )
+            for( size_t j = 0; j < this->ny; j++ )
+                for( size_t i = 0; i < this->nx; i++ ) {
+                    const size_t index[3] = { i, j, k };
+                    expanded[ this->globalIndex( i, j, k ) ] = v[ index[dim] ];
+                }
+
+        return expanded;
+    }
+
+    std::vector< double > CartesianGeometry::expandTops() const {
+        const size_t size = this->nx * this->ny * this->nz;
+        if( m_tops.size() == size ) return m_tops;
+
+        std::vector< double > tops( size );
+        for( size_t k = 0; k < this->nz; k++ )
+            for( size_t j = 0; j < this->ny; j++ )
+                for( size_t i = 0; i < this->nx; i++ )
+                    tops[ this->globalIndex( i, j, k ) ] = this->top( i, j, k );
+
+        return tops;
+    }
+
+    ecl_grid_type* CartesianGeometry::alloc_ecl_grid( const int* actnum ) const {
+        const auto dx = this->expand( m_dx, 0 );
+        const auto dy = this->expand( m_dy, 1 );
+        const auto dz = this->expand( m_dz, 2 );
+        const auto tops = this->expandTops();
+
+        return ecl_grid_alloc_dx_dy_dz_tops( this->nx, this->ny, this->nz,
+                                             dx.data(), dy.data(), dz.data(), tops.data(),
+                                             actnum );
+    }
+
+    size_t CartesianGeometry::memoryUsage() const {
+        size_t offsets = 0;
+        if( const auto cached = std::atomic_load( &this->m_offsets ) )
+            offsets = sizeof( CellOffsets ) + memory::heap( cached->x ) + memory::heap( cached->y );
+
+        return memory::heap( m_dx ) + memory::heap( m_dy ) + memory::heap( m_dz )
+             + memory::heap( m_tops )
+             + memory::heap( m_xv ) + memory::heap( m_yv ) + memory::heap( m_zv )
+             + offsets;
+    }
+}
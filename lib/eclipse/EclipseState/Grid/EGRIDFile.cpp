@@ -0,0 +1,299 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <opm/parser/eclipse/EclipseState/Grid/EGRIDFile.hpp>
+
+namespace Opm {
+
+namespace {
+
+    inline uint32_t bswap( uint32_t value ) {
+#if defined(__GNUC__)
+        return __builtin_bswap32( value );
+#else
+        return ((value & 0x000000FFU) << 24) | ((value & 0x0000FF00U) << 8)
+             | ((value & 0x00FF0000U) >> 8)  | ((value & 0xFF000000U) >> 24);
+#endif
+    }
+
+    inline uint64_t bswap( uint64_t value ) {
+#if defined(__GNUC__)
+        return __builtin_bswap64( value );
+#else
+        return (uint64_t( bswap( uint32_t( value ) ) ) << 32) | bswap( uint32_t( value >> 32 ) );
+#endif
+    }
+
+    /* The files are big-endian; the host is assumed to be little-endian unless told otherwise. */
+    template< typename T >
+    inline T load_be( const unsigned char* ptr ) {
+        T value;
+        std::memcpy( &value, ptr, sizeof value );
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return value;
+#else
+        return bswap( value );
+#endif
+    }
+
+    inline int32_t load_int( const unsigned char* ptr ) {
+        return static_cast< int32_t >( load_be< uint32_t >( ptr ) );
+    }
+
+    inline float load_float( const unsigned char* ptr ) {
+        const uint32_t bits = load_be< uint32_t >( ptr );
+        float value;
+        std::memcpy( &value, &bits, sizeof value );
+        return value;
+    }
+
+    inline double load_double( const unsigned char* ptr ) {
+        const uint64_t bits = load_be< uint64_t >( ptr );
+        double value;
+        std::memcpy( &value, &bits, sizeof value );
+        return value;
+    }
+
+    std::string trim( const char* ptr, size_t length ) {
+        std::string s( ptr, length );
+        return s.substr( 0, s.find_last_not_of( ' ' ) + 1 );
+    }
+
+    /* element size in bytes, and the number of elements per record */
+    std::pair< size_t, size_t > layout( const std::string& type ) {
+        if( type == "INTE" || type == "REAL" || type == "LOGI" ) return { 4, 1000 };
+        if( type == "DOUB" ) return { 8, 1000 };
+        if( type == "CHAR" ) return { 8, 105 };
+        if( type == "MESS" ) return { 0, 1000 };
+        if( type.size() == 4 && type[0] == 'C' && type[1] == '0' )
+            return { size_t( std::stoi( type.substr( 2 ) ) ), 105 };
+
+        throw std::invalid_argument( "Unknown EGRID data type: " + type );
+    }
+
+    std::vector< unsigned char > readFile( const std::string& filename ) {
+        std::ifstream stream( filename, std::ios::binary | std::ios::ate );
+        if( !stream )
+            throw std::invalid_argument( "Could not open EGRID file: " + filename );
+
+        const auto size = stream.tellg();
+        if( size <= 0 )
+            throw std::invalid_argument( "Could not read EGRID file: " + filename );
+
+        std::vector< unsigned char > buffer( static_cast< size_t >( size ) );
+        stream.seekg( 0 );
+        if( !stream.read( reinterpret_cast< char* >( buffer.data() ), size ) )
+            throw std::invalid_argument( "Could not read EGRID file: " + filename );
+
+        return buffer;
+    }
+
+}
+
+    EGRIDFile::EGRIDFile( const std::string& filename ) :
+        m_filename( filename )
+    {
+#ifndef _WIN32
+        const int fd = open( filename.c_str(), O_RDONLY );
+        if( fd < 0 )
+            throw std::invalid_argument( "Could not open EGRID file: " + filename );
+
+        struct stat st;
+        if( fstat( fd, &st ) != 0 || st.st_size == 0 ) {
+            close( fd );
+            throw std::invalid_argument( "Could not read EGRID file: " + filename );
+        }
+
+        void* data = mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        close( fd );
+
+        if( data != MAP_FAILED ) {
+            m_data = static_cast< const unsigned char* >( data );
+            m_size = static_cast< size_t >( st.st_size );
+            m_mapped = true;
+        }
+#endif
+        /* No mmap(), or the mapping failed: read the whole file instead. */
+        if( !m_mapped ) {
+            m_buffer = readFile( filename );
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+
+        const auto invalid = [&filename]( const std::string& msg ) {
+            return std::invalid_argument( "Invalid EGRID file " + filename + ": " + msg );
+        };
+
+        size_t pos = 0;
+        bool main_grid = true;
+
+        try {
+            while( pos < m_size ) {
+                if( pos + 24 > m_size || load_int( m_data + pos ) != 16 || load_int( m_data + pos + 20 ) != 16 )
+                    throw invalid( "bad keyword header at byte " + std::to_string( pos ) );
+
+                const auto name = trim( reinterpret_cast< const char* >( m_data + pos + 4 ), 8 );
+                const int count = load_int( m_data + pos + 12 );
+                const auto type = std::string( reinterpret_cast< const char* >( m_data + pos + 16 ), 4 );
+                pos += 24;
+
+                if( count < 0 )
+                    throw invalid( "negative element count for " + name );
+
+                const auto data_layout = layout( type );
+                const size_t offset = pos;
+                size_t remaining = count;
+
+                while( remaining > 0 && data_layout.first > 0 ) {
+                    const size_t n = std::min( remaining, data_layout.second );
+                    const size_t bytes = n * data_layout.first;
+
+                    if( pos + bytes + 8 > m_size
+                        || size_t( load_int( m_data + pos ) ) != bytes
+                        || size_t( load_int( m_data + pos + 4 + bytes ) ) != bytes )
+                        throw invalid( "bad data record for " + name );
+
+                    pos += bytes + 8;
+                    remaining -= n;
+                }
+
+                if( !main_grid ) {
+                    if( name == "LGR" ) m_lgr = true;
+                    continue;
+                }
+
+                if( name == "ENDGRID" )
+                    main_grid = false;
+
+                m_keywords.emplace( name, Entry{ type, size_t( count ), offset } );
+            }
+        } catch( ... ) {
+            this->release();
+            throw;
+        }
+    }
+
+    EGRIDFile::~EGRIDFile() {
+        this->release();
+    }
+
+    void EGRIDFile::release() {
+#ifndef _WIN32
+        if( m_mapped )
+            munmap( const_cast< unsigned char* >( m_data ), m_size );
+#endif
+        m_mapped = false;
+    }
+
+    bool EGRIDFile::isEGRID( const std::string& filename ) {
+        std::ifstream stream( filename, std::ios::binary );
+        unsigned char header[ 24 ];
+        if( !stream.read( reinterpret_cast< char* >( header ), sizeof header ) )
+            return false;
+
+        return load_int( header ) == 16
+            && trim( reinterpret_cast< const char* >( header + 4 ), 8 ) == "FILEHEAD";
+    }
+
+    bool EGRIDFile::hasKeyword( const std::string& keyword ) const {
+        return m_keywords.count( keyword ) > 0;
+    }
+
+    bool EGRIDFile::hasLGR() const {
+        return m_lgr;
+    }
+
+    const EGRIDFile::Entry& EGRIDFile::entry( const std::string& keyword ) const {
+        const auto iter = m_keywords.find( keyword );
+        if( iter == m_keywords.end() )
+            throw std::invalid_argument( "Keyword " + keyword + " not found in EGRID file " + m_filename );
+
+        return iter->second;
+    }
+
+    size_t EGRIDFile::size( const std::string& keyword ) const {
+        return this->entry( keyword ).count;
+    }
+
+    /*
+      Calls convert( ptr, n, index ) for each record, with ptr pointing
+      to the n elements starting at element number index.
+    */
+    template< typename Convert >
+    void EGRIDFile::readBlocks( const Entry& e, size_t element_size, Convert convert ) const {
+        const size_t block_size = layout( e.type ).second;
+        size_t pos = e.offset;
+
+        for( size_t index = 0; index < e.count; index += block_size ) {
+            const size_t n = std::min( block_size, e.count - index );
+            convert( m_data + pos + 4, n, index );
+            pos += n * element_size + 8;
+        }
+    }
+
+    std::vector< int > EGRIDFile::getIntData( const std::string& keyword ) const {
+        const auto& e = this->entry( keyword );
+        if( e.type != "INTE" && e.type != "LOGI" )
+            throw std::invalid_argument( "Keyword " + keyword + " is of type " + e.type + " - expected INTE or LOGI" );
+
+        const bool logical = e.type == "LOGI";
+        std::vector< int > data( e.count );
+        this->readBlocks( e, 4, [&]( const unsigned char* ptr, size_t n, size_t index ) {
+            for( size_t i = 0; i < n; i++ ) {
+                const int value = load_int( ptr + 4 * i );
+                data[index + i] = logical ? (value != 0) : value;
+            }
+        } );
+
+        return data;
+    }
+
+    std::vector< double > EGRIDFile::getDoubleData( const std::string& keyword ) const {
+        const auto& e = this->entry( keyword );
+        std::vector< double > data( e.count );
+
+        if( e.type == "REAL" )
+            this->readBlocks( e, 4, [&]( const unsigned char* ptr, size_t n, size_t index ) {
+                for( size_t i = 0; i < n; i++ )
+                    data[index + i] = load_float( ptr + 4 * i );
+            } );
+        else if( e.type == "DOUB" )
+            this->readBlocks( e, 8, [&]( const unsigned char* ptr, size_t n, size_t index ) {
+                for( size_t i = 0; i < n; i++ )
+                    data[index + i] = load_double( ptr + 8 * i );
+            } );
+        else
+            throw std::invalid_argument( "Keyword " + keyword + " is of type " + e.type + " - expected REAL or DOUB" );
+
+        return data;
+    }
+}
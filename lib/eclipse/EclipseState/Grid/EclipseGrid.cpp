@@ -18,11 +18,13 @@
 */
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 
 #include <iostream>
 #include <tuple>
 #include <functional>
+#include <type_traits>
 
 #include <opm/parser/eclipse/Deck/Section.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -43,7 +45,12 @@
 #include <opm/parser/eclipse/Parser/ParserKeywords/T.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeywords/Z.hpp>
 
+#include <opm/parser/eclipse/EclipseState/Grid/CartesianGeometry.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EGRIDFile.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridGeometry.hpp>
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <ert/ecl/ecl_grid.h>
 
@@ -55,20 +62,24 @@ namespace Opm {
 			     const std::vector<double>& zcorn , 
 			     const int * actnum, 
 			     const double * mapaxes) 
-	: m_minpvValue(0),
+	: GridDims(dims),
+	  m_minpvValue(0),
 	  m_minpvMode(MinpvMode::ModeEnum::Inactive),
 	  m_pinch("PINCH"),
 	  m_pinchoutMode(PinchMode::ModeEnum::TOPBOT),
 	  m_multzMode(PinchMode::ModeEnum::TOP)
     {
         initCornerPointGrid( dims, coord , zcorn , actnum , mapaxes );
+        initIndexMaps();
     }
 
 
 
     /**
        Will create an EclipseGrid instance based on an existing
-       GRID/EGRID file.
+       GRID/EGRID file. Unformatted EGRID files without LGRs are read
+       directly from a memory mapping of the file; other files are
+       loaded with ERT.
     */
     EclipseGrid::EclipseGrid(const std::string& filename )
         : GridDims(),
@@ -78,6 +89,45 @@ namespace Opm {
           m_pinchoutMode(PinchMode::ModeEnum::TOPBOT),
           m_multzMode(PinchMode::ModeEnum::TOP)
     {
+        if (EGRIDFile::isEGRID( filename )) {
+            const EGRIDFile egrid( filename );
+            const auto gridhead = egrid.hasKeyword( "GRIDHEAD" ) ? egrid.getIntData( "GRIDHEAD" ) : std::vector<int>();
+
+            if (gridhead.size() >= 4 && gridhead[0] == 1 && !egrid.hasLGR()) {
+                const std::array<int, 3> dims = {{ gridhead[1], gridhead[2], gridhead[3] }};
+                const auto coord = egrid.getDoubleData( "COORD" );
+                const auto zcorn = egrid.getDoubleData( "ZCORN" );
+                std::vector<int> actnum;
+                std::vector<double> mapaxes;
+
+                if (egrid.hasKeyword( "ACTNUM" ))
+                    actnum = egrid.getIntData( "ACTNUM" );
+
+                if (egrid.hasKeyword( "MAPAXES" ))
+                    mapaxes = egrid.getDoubleData( "MAPAXES" );
+
+                const auto assertSize = [&filename]( const std::string& keyword, size_t size, size_t expected ) {
+                    if (size != expected)
+                        throw std::invalid_argument( keyword + " in " + filename + " has " + std::to_string( size )
+                                                     + " elements - expected : " + std::to_string( expected ) );
+                };
+
+                m_nx = dims[0];
+                m_ny = dims[1];
+                m_nz = dims[2];
+                assertSize( "ZCORN", zcorn.size(), ZcornMapper( m_nx, m_ny, m_nz ).size() );
+                assertSize( "COORD", coord.size(), 6 * (m_nx + 1) * (m_ny + 1) );
+                if (!actnum.empty())
+                    assertSize( "ACTNUM", actnum.size(), getCartesianSize() );
+
+                initCornerPointGrid( dims, coord, zcorn,
+                                     actnum.empty() ? nullptr : actnum.data(),
+                                     mapaxes.size() == 6 ? mapaxes.data() : nullptr );
+                initIndexMaps();
+                return;
+            }
+        }
+
         ecl_grid_type * new_ptr = ecl_grid_load_case__( filename.c_str() , false );
         if (new_ptr)
             m_grid.reset( new_ptr );
@@ -87,6 +137,7 @@ namespace Opm {
         m_nx = ecl_grid_get_nx( c_ptr() );
         m_ny = ecl_grid_get_ny( c_ptr() );
         m_nz = ecl_grid_get_nz( c_ptr() );
+        initIndexMaps();
     }
 
 
@@ -98,8 +149,13 @@ namespace Opm {
           m_pinch("PINCH"),
           m_pinchoutMode(PinchMode::ModeEnum::TOPBOT),
           m_multzMode(PinchMode::ModeEnum::TOP),
-          m_grid( ecl_grid_alloc_rectangular(nx, ny, nz, dx, dy, dz, NULL) )
+          m_cartesian( std::make_shared< const CartesianGeometry >( nx, ny, nz,
+                                                                    std::vector<double>( nx, dx ),
+                                                                    std::vector<double>( ny, dy ),
+                                                                    std::vector<double>( nz, dz ),
+                                                                    std::vector<double>( nx * ny, 0.0 ) ) )
     {
+        initIndexMaps( nullptr );
     }
 
     EclipseGrid::EclipseGrid(const EclipseGrid& src, const double* zcorn , const std::vector<int>& actnum)
@@ -109,10 +165,34 @@ namespace Opm {
           m_minpvMode( src.m_minpvMode ),
           m_pinch( src.m_pinch ),
           m_pinchoutMode( src.m_pinchoutMode ),
-          m_multzMode( src.m_multzMode )
+          m_multzMode( src.m_multzMode ),
+          m_pinchGapMode( src.m_pinchGapMode ),
+          m_pinchMaxEmptyGap( src.m_pinchMaxEmptyGap ),
+          m_grid( zcorn ? ert_grid() : src.m_grid ),
+          m_cartesian( zcorn ? nullptr : src.m_cartesian ),
+          m_geometry( zcorn ? geometry_cache() : src.m_geometry )
     {
         const int * actnum_data = (actnum.empty()) ? nullptr : actnum.data();
-        m_grid.reset( ecl_grid_alloc_processed_copy( src.c_ptr(), zcorn , actnum_data ));
+
+        /*
+          As long as ZCORN is not changed the geometry - the ERT grid or
+          the implicit geometry, and the geometry cache - is shared with
+          src, and only the ACTNUM is applied.
+        */
+        if (zcorn == nullptr) {
+            if (actnum_data) {
+                m_grid.resetACTNUM( actnum_data );
+                initIndexMaps( actnum_data );
+            } else {
+                m_activeMap = src.m_activeMap;
+                m_globalMap = src.m_globalMap;
+            }
+            return;
+        }
+
+        const auto * src_grid = actnum_data ? src.c_geometry_ptr() : src.c_ptr();
+        m_grid.reset( ecl_grid_alloc_processed_copy( src_grid, zcorn , actnum_data ));
+        initIndexMaps();
     }
 
 
@@ -168,19 +248,20 @@ namespace Opm {
         const std::array<int, 3> dims = getNXYZ();
         initGrid(dims, deck);
 
-        if (actnum != nullptr)
-            resetACTNUM(actnum);
-        else {
-            if (deck.hasKeyword<ParserKeywords::ACTNUM>()) {
-                const auto& actnumData = deck.getKeyword<ParserKeywords::ACTNUM>().getIntData();
-                if (actnumData.size() == getCartesianSize())
-                    resetACTNUM( actnumData.data());
-                else {
-                    const std::string msg = "The ACTNUM keyword has " + std::to_string( actnumData.size() ) + " elements - expected : " + std::to_string( getCartesianSize()) + " - ignored.";
-                    m_messages.warning(msg);
-                }
+        if (actnum == nullptr && deck.hasKeyword<ParserKeywords::ACTNUM>()) {
+            const auto& actnumData = deck.getKeyword<ParserKeywords::ACTNUM>().getIntData();
+            if (actnumData.size() == getCartesianSize())
+                actnum = actnumData.data();
+            else {
+                const std::string msg = "The ACTNUM keyword has " + std::to_string( actnumData.size() ) + " elements - expected : " + std::to_string( getCartesianSize()) + " - ignored.";
+                m_messages.warning(msg);
             }
         }
+
+        if (actnum != nullptr)
+            resetACTNUM(actnum);
+        else
+            initIndexMaps();
     }
 
     bool EclipseGrid::circle( ) const{
@@ -210,6 +291,10 @@ namespace Opm {
 
             auto multzString = record.getItem<ParserKeywords::PINCH::MULTZ_OPTION>().get< std::string >(0);
             m_multzMode = PinchMode::PinchModeFromString(multzString);
+
+            auto gapString = record.getItem<ParserKeywords::PINCH::CONTROL_OPTION>().get< std::string >(0);
+            m_pinchGapMode = PinchMode::PinchModeFromString(gapString);
+            m_pinchMaxEmptyGap = record.getItem<ParserKeywords::PINCH::MAX_EMPTY_GAP>().getSIDouble(0);
         }
 
         if (deck.hasKeyword<ParserKeywords::MINPV>() && deck.hasKeyword<ParserKeywords::MINPVFIL>()) {
@@ -238,10 +323,9 @@ namespace Opm {
     }
 
     size_t EclipseGrid::activeIndex(size_t globalIndex) const {
-        int active_index = ecl_grid_get_active_index1( m_grid.get() , globalIndex );
-        if (active_index < 0)
+        if (globalIndex >= m_globalMap.size() || m_globalMap[globalIndex] < 0)
             throw std::invalid_argument("Input argument does not correspond to an active cell");
-        return static_cast<size_t>( active_index );
+        return static_cast<size_t>( m_globalMap[globalIndex] );
     }
 
     /**
@@ -249,8 +333,7 @@ namespace Opm {
        [0,num_active).
     */
     size_t EclipseGrid::getGlobalIndex(size_t active_index) const {
-        int global_index = ecl_grid_get_global_index1A( m_grid.get() , active_index );
-        return static_cast<size_t>(global_index);
+        return static_cast<size_t>( m_activeMap[active_index] );
     }
 
     size_t EclipseGrid::getGlobalIndex(size_t i, size_t j, size_t k) const {
@@ -274,6 +357,14 @@ namespace Opm {
         return m_multzMode;
     }
 
+    PinchMode::ModeEnum EclipseGrid::getPinchGapMode( ) const {
+        return m_pinchGapMode;
+    }
+
+    double EclipseGrid::getPinchMaxEmptyGap( ) const {
+        return m_pinchMaxEmptyGap;
+    }
+
     MinpvMode::ModeEnum EclipseGrid::getMinpvMode() const {
         return m_minpvMode;
     }
@@ -282,6 +373,108 @@ namespace Opm {
         return m_minpvValue;
     }
 
+    std::vector< PinchNNC > EclipseGrid::processPinch( const std::vector<double>& porv,
+                                                       const std::vector<double>& multz ) {
+        const size_t columns = getNX() * getNY();
+        const size_t nz = getNZ();
+        const size_t size = getCartesianSize();
+
+        if (porv.size() != size)
+            throw std::invalid_argument("PORV has " + std::to_string( porv.size() ) + " elements - expected : " + std::to_string( size ));
+
+        if (!multz.empty() && multz.size() != size)
+            throw std::invalid_argument("MULTZ has " + std::to_string( multz.size() ) + " elements - expected : " + std::to_string( size ));
+
+        const auto& thickness = getCellThicknesses();
+        const bool pinch = isPinchActive();
+        const double threshold = pinch ? getPinchThresholdThickness() : 0.0;
+        const bool minpv = m_minpvMode != MinpvMode::ModeEnum::Inactive;
+        const bool fill = m_minpvMode == MinpvMode::ModeEnum::OpmFIL;
+        const bool gap = m_pinchGapMode == PinchMode::ModeEnum::GAP;
+        const bool multz_all = m_multzMode == PinchMode::ModeEnum::ALL;
+        const auto cell_multz = [&multz]( size_t g ) { return multz.empty() ? 1.0 : multz[g]; };
+
+        std::vector<int> actnum( size );
+        std::vector< PinchNNC > nncs;
+        bool changed = false;
+        const int nthreads = GridKernels::threads();
+        (void) nthreads;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+        {
+            std::vector< PinchNNC > column_nncs;
+            bool column_changed = false;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long column = 0; column < long( columns ); column++) {
+                /* The last active cell, and the layers between it and the current cell. */
+                long top = -1;
+                bool has_gap = false;
+                bool pinched_gap = true;
+                bool filled_gap = true;
+                double empty_thickness = 0;
+                double gap_multz = 1;
+
+                for (size_t k = 0; k < nz; k++) {
+                    const size_t g = column + k * columns;
+                    const bool input_active = m_globalMap[g] >= 0;
+                    const bool removed = input_active && minpv && porv[g] < m_minpvValue;
+                    /* a cell which is inactive in the input is never pinched out */
+                    const bool thin = input_active && pinch && thickness[g] < threshold;
+                    const bool active = input_active && !removed && !thin;
+
+                    actnum[g] = active;
+                    column_changed |= (input_active != active);
+
+                    if (!active) {
+                        has_gap = true;
+                        if (!thin && !removed) {
+                            pinched_gap = false;
+                            empty_thickness += thickness[g];
+                        }
+                        filled_gap &= removed;
+                        gap_multz = std::min( gap_multz , cell_multz( g ));
+                        continue;
+                    }
+
+                    if (top >= 0 && has_gap) {
+                        const bool connect = (pinch && (pinched_gap || (gap && empty_thickness <= m_pinchMaxEmptyGap)))
+                                          || (fill && filled_gap);
+                        if (connect)
+                            column_nncs.push_back( { size_t( top ), g, multz_all ? gap_multz : cell_multz( top ) } );
+                    }
+
+                    top = g;
+                    has_gap = false;
+                    pinched_gap = filled_gap = true;
+                    empty_thickness = 0;
+                    gap_multz = cell_multz( g );
+                }
+            }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            {
+                nncs.insert( nncs.end() , column_nncs.begin() , column_nncs.end() );
+                changed |= column_changed;
+            }
+        }
+
+        std::sort( nncs.begin() , nncs.end() , []( const PinchNNC& a , const PinchNNC& b ) {
+                return std::tie( a.cell1 , a.cell2 ) < std::tie( b.cell1 , b.cell2 );
+            });
+
+        if (changed)
+            resetACTNUM( actnum.data() );
+
+        return nncs;
+    }
+
 
     void EclipseGrid::initCartesianGrid(const std::array<int, 3>& dims , const Deck& deck) {
         if (hasDVDEPTHZKeywords( deck ))
@@ -308,12 +501,32 @@ namespace Opm {
     }
 
 
+    /*
+      The DX/DY/DZ/TOPS grids are kept in implicit form; DXV, DYV and
+      DZV are stored with one value per i, j and k, and when TOPS is
+      only given for the top layer - and DZV is used - only the top
+      layer is stored.
+    */
     void EclipseGrid::initDTOPSGrid(const std::array<int, 3>& dims , const Deck& deck) {
-        std::vector<double> DX = createDVector( dims , 0 , "DX" , "DXV" , deck);
-        std::vector<double> DY = createDVector( dims , 1 , "DY" , "DYV" , deck);
-        std::vector<double> DZ = createDVector( dims , 2 , "DZ" , "DZV" , deck);
-        std::vector<double> TOPS = createTOPSVector( dims , DZ , deck );
-        m_grid.reset( ecl_grid_alloc_dx_dy_dz_tops( dims[0] , dims[1] , dims[2] , DX.data() , DY.data() , DZ.data() , TOPS.data() , nullptr ) );
+        std::vector<double> DX = createCompressedDVector( dims , 0 , "DX" , "DXV" , deck);
+        std::vector<double> DY = createCompressedDVector( dims , 1 , "DY" , "DYV" , deck);
+        std::vector<double> DZ = createCompressedDVector( dims , 2 , "DZ" , "DZV" , deck);
+        const size_t area = dims[0] * dims[1];
+        const size_t volume = area * dims[2];
+
+        std::vector<double> TOPS;
+        if (DZ.size() != volume && deck.getKeyword<ParserKeywords::TOPS>().getSIDoubleData().size() == area)
+            TOPS = deck.getKeyword<ParserKeywords::TOPS>().getSIDoubleData();
+        else if (DZ.size() != volume) {
+            std::vector<double> fullDZ( volume );
+            scatterDim( dims , 2 , DZ , fullDZ );
+            TOPS = createTOPSVector( dims , fullDZ , deck );
+        } else
+            TOPS = createTOPSVector( dims , DZ , deck );
+
+        m_cartesian = std::make_shared< const CartesianGeometry >( dims[0] , dims[1] , dims[2] ,
+                                                                   std::move( DX ) , std::move( DY ) ,
+                                                                   std::move( DZ ) , std::move( TOPS ) );
     }
 
 
@@ -682,6 +895,23 @@ namespace Opm {
     }
 
 
+    /*
+      As createDVector(), but when only the DV keyword is present the
+      DV vector is returned as is, with one element per i, j or k.
+    */
+    std::vector<double> EclipseGrid::createCompressedDVector(const std::array<int, 3>& dims, size_t dim, const std::string& DKey,
+            const std::string& DVKey, const Deck& deck)
+    {
+        if (deck.hasKeyword(DKey))
+            return createDVector( dims , dim , DKey , DVKey , deck );
+
+        const std::vector<double>& DV = deck.getKeyword(DVKey).getSIDoubleData();
+        if (DV.size() != (size_t) dims[dim])
+            throw std::invalid_argument(DVKey + " size mismatch");
+        return DV;
+    }
+
+
     void EclipseGrid::scatterDim(const std::array<int, 3>& dims , size_t dim , const std::vector<double>& DV , std::vector<double>& D) {
         int index[3];
         for (index[2] = 0;  index[2] < dims[2]; index[2]++) {
@@ -695,7 +925,92 @@ namespace Opm {
     }
 
     const ecl_grid_type * EclipseGrid::c_ptr() const {
-        return m_grid.get();
+        return m_grid.get( *this );
+    }
+
+    const CartesianGeometry* EclipseGrid::getCartesianGeometry() const {
+        return m_cartesian.get();
+    }
+
+
+    const ecl_grid_type * EclipseGrid::c_geometry_ptr() const {
+        return m_grid.geometry( *this );
+    }
+
+
+    EclipseGrid::ert_grid::ert_grid(const ert_grid& src) {
+        std::lock_guard< std::mutex > lock( src.m_mutex );
+        m_base = src.m_base;
+        m_view = src.m_view;
+        m_ptr.store( m_view.get() );
+    }
+
+    ecl_grid_type * EclipseGrid::ert_grid::get() const {
+        return m_ptr.load( std::memory_order_acquire );
+    }
+
+    void EclipseGrid::ert_grid::reset(ecl_grid_type * grid) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_base.reset( grid, ecl_grid_free );
+        m_view = m_base;
+        m_ptr.store( grid, std::memory_order_release );
+    }
+
+    /*
+      A grid which is not shared with other EclipseGrid instances is
+      updated in place; otherwise the grid with the new ACTNUM is
+      created on request.
+    */
+    void EclipseGrid::ert_grid::resetACTNUM(const int * actnum) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        const bool owned = m_view && (m_view == m_base ? m_base.use_count() == 2 : m_view.use_count() == 1);
+
+        if (owned)
+            ecl_grid_reset_actnum( m_view.get(), actnum );
+        else
+            m_view.reset();
+
+        m_ptr.store( m_view.get(), std::memory_order_release );
+    }
+
+    /*
+      Creates the ERT grid with the current ACTNUM, from the base grid
+      or from the implicit geometry, if it does not exist already.
+    */
+    const ecl_grid_type * EclipseGrid::ert_grid::get(const EclipseGrid& grid) const {
+        if (auto * ptr = this->get())
+            return ptr;
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if (!m_view && (m_base || grid.m_cartesian)) {
+            std::vector<int> actnum;
+            if (m_base || !grid.allActive()) {
+                actnum.resize( grid.getCartesianSize() );
+                for (size_t g = 0; g < actnum.size(); g++)
+                    actnum[g] = grid.m_globalMap[g] >= 0;
+            }
+
+            if (m_base)
+                m_view.reset( ecl_grid_alloc_processed_copy( m_base.get(), nullptr, actnum.data() ), ecl_grid_free );
+            else
+                m_view.reset( grid.m_cartesian->alloc_ecl_grid( actnum.empty() ? nullptr : actnum.data() ), ecl_grid_free );
+
+            m_ptr.store( m_view.get(), std::memory_order_release );
+        }
+
+        return m_view.get();
+    }
+
+    const ecl_grid_type * EclipseGrid::ert_grid::geometry(const EclipseGrid& grid) const {
+        if (m_base)
+            return m_base.get();
+
+        return this->get( grid );
+    }
+
+    size_t EclipseGrid::ert_grid::count() const {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return (m_base ? 1 : 0) + ((m_view && m_view != m_base) ? 1 : 0);
     }
 
 
@@ -703,6 +1018,37 @@ namespace Opm {
         return m_messages;
     }
 
+    void EclipseGrid::memoryUsage( MemoryUsage& usage ) const {
+        /*
+          Approximate size of the libecl ecl_cell_type: center and
+          eight corner points, volume and a handful of indices and
+          pointers.
+        */
+        const size_t ert_cell_bytes = 272;
+
+        usage.add( "EclipseGrid", memory::heap( m_activeMap ) + memory::heap( m_globalMap ) + m_messages.memoryUsage() );
+
+        if (const auto* geometry = m_geometry.get())
+            usage.add( "EclipseGrid/geometry", memory::heap( geometry->volume() )
+                                             + memory::heap( geometry->centerX() )
+                                             + memory::heap( geometry->centerY() )
+                                             + memory::heap( geometry->depth() )
+                                             + memory::heap( geometry->thickness() )
+                                             + memory::heap( geometry->dx() )
+                                             + memory::heap( geometry->dy() ) );
+
+        if( m_cartesian )
+            usage.add( "EclipseGrid/cartesian", m_cartesian->memoryUsage() );
+
+        if (const size_t grids = m_grid.count()) {
+            /* the cells, and the global <-> active index maps */
+            const size_t cells = this->getCartesianSize();
+            const size_t active = this->getNumActive();
+            usage.add( "EclipseGrid/ert", grids * (cells * (ert_cell_bytes + 2 * sizeof( int ))
+                                                   + active * 2 * sizeof( int )) );
+        }
+    }
+
 
     MessageContainer& EclipseGrid::getMessageContainer() {
         return m_messages;
@@ -719,7 +1065,7 @@ namespace Opm {
 
 
     size_t EclipseGrid::getNumActive( ) const {
-        return static_cast<size_t>(ecl_grid_get_nactive( c_ptr() ));
+        return m_activeMap.size();
     }
 
     bool EclipseGrid::allActive( ) const {
@@ -728,43 +1074,89 @@ namespace Opm {
 
     bool EclipseGrid::cellActive( size_t globalIndex ) const {
         assertGlobalIndex( globalIndex );
-        return ecl_grid_cell_active1( c_ptr() , static_cast<int>(globalIndex));
+        return m_globalMap[globalIndex] >= 0;
     }
 
     bool EclipseGrid::cellActive( size_t i , size_t j , size_t k ) const {
         assertIJK(i,j,k);
-        return ecl_grid_cell_active3( c_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
+        return m_globalMap[getGlobalIndex(i,j,k)] >= 0;
+    }
+
+
+    std::array<size_t, 3> EclipseGrid::cellIJK(size_t globalIndex) const {
+        const size_t nx = getNX();
+        const size_t ny = getNY();
+        return {{ globalIndex % nx, (globalIndex / nx) % ny, globalIndex / (nx * ny) }};
     }
 
 
     double EclipseGrid::getCellVolume(size_t globalIndex) const {
         assertGlobalIndex( globalIndex );
-        return ecl_grid_get_cell_volume1( c_ptr() , static_cast<int>(globalIndex));
+        if (m_cartesian) {
+            const auto ijk = cellIJK( globalIndex );
+            return m_cartesian->volume( ijk[0], ijk[1], ijk[2] );
+        }
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->volume()[globalIndex];
+
+        return ecl_grid_get_cell_volume1( c_geometry_ptr() , static_cast<int>(globalIndex));
     }
 
 
     double EclipseGrid::getCellVolume(size_t i , size_t j , size_t k) const {
         assertIJK(i,j,k);
-        return ecl_grid_get_cell_volume3( c_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
+        if (m_cartesian)
+            return m_cartesian->volume( i, j, k );
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->volume()[getGlobalIndex(i,j,k)];
+
+        return ecl_grid_get_cell_volume3( c_geometry_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
     }
 
     double EclipseGrid::getCellThicknes(size_t i , size_t j , size_t k) const {
         assertIJK(i,j,k);
-        return ecl_grid_get_cell_thickness3( c_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
+        if (m_cartesian)
+            return m_cartesian->dz( i, j, k );
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->thickness()[getGlobalIndex(i,j,k)];
+
+        return ecl_grid_get_cell_thickness3( c_geometry_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
     }
 
     double EclipseGrid::getCellThicknes(size_t globalIndex) const {
         assertGlobalIndex( globalIndex );
-        return ecl_grid_get_cell_thickness1( c_ptr() , static_cast<int>(globalIndex));
+        if (m_cartesian) {
+            const auto ijk = cellIJK( globalIndex );
+            return m_cartesian->dz( ijk[0], ijk[1], ijk[2] );
+        }
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->thickness()[globalIndex];
+
+        return ecl_grid_get_cell_thickness1( c_geometry_ptr() , static_cast<int>(globalIndex));
     }
 
 
     std::array<double, 3> EclipseGrid::getCellDims(size_t globalIndex) const {
         assertGlobalIndex( globalIndex );
+        if (m_cartesian) {
+            const auto ijk = cellIJK( globalIndex );
+            return std::array<double,3>{ { m_cartesian->dx( ijk[0], ijk[1], ijk[2] ),
+                                           m_cartesian->dy( ijk[0], ijk[1], ijk[2] ),
+                                           m_cartesian->dz( ijk[0], ijk[1], ijk[2] ) } };
+        }
+
+        if (const auto* geometry = this->cachedGeometry())
+            return std::array<double,3>{ { geometry->dx()[globalIndex],
+                                           geometry->dy()[globalIndex],
+                                           geometry->thickness()[globalIndex] } };
         {
-            double dx = ecl_grid_get_cell_dx1( c_ptr() , globalIndex);
-            double dy = ecl_grid_get_cell_dy1( c_ptr() , globalIndex);
-            double dz = ecl_grid_get_cell_thickness1( c_ptr() , globalIndex);
+            double dx = ecl_grid_get_cell_dx1( c_geometry_ptr() , globalIndex);
+            double dy = ecl_grid_get_cell_dy1( c_geometry_ptr() , globalIndex);
+            double dz = ecl_grid_get_cell_thickness1( c_geometry_ptr() , globalIndex);
 
             return std::array<double,3>{ {dx , dy , dz }};
         }
@@ -772,21 +1164,23 @@ namespace Opm {
 
     std::array<double, 3> EclipseGrid::getCellDims(size_t i , size_t j , size_t k) const {
         assertIJK(i,j,k);
-        {
-            size_t globalIndex = getGlobalIndex( i,j,k );
-            double dx = ecl_grid_get_cell_dx1( c_ptr() , globalIndex);
-            double dy = ecl_grid_get_cell_dy1( c_ptr() , globalIndex);
-            double dz = ecl_grid_get_cell_thickness1( c_ptr() , globalIndex);
-
-            return std::array<double,3>{ {dx , dy , dz }};
-        }
+        return getCellDims( getGlobalIndex( i,j,k ) );
     }
 
     std::array<double, 3> EclipseGrid::getCellCenter(size_t globalIndex) const {
         assertGlobalIndex( globalIndex );
+        if (m_cartesian) {
+            const auto ijk = cellIJK( globalIndex );
+            return m_cartesian->center( ijk[0], ijk[1], ijk[2] );
+        }
+
+        if (const auto* geometry = this->cachedGeometry())
+            return std::array<double, 3>{ { geometry->centerX()[globalIndex],
+                                            geometry->centerY()[globalIndex],
+                                            geometry->depth()[globalIndex] } };
         {
             double x,y,z;
-            ecl_grid_get_xyz1( c_ptr() , static_cast<int>(globalIndex) , &x , &y , &z);
+            ecl_grid_get_xyz1( c_geometry_ptr() , static_cast<int>(globalIndex) , &x , &y , &z);
             return std::array<double, 3>{{x,y,z}};
         }
     }
@@ -811,9 +1205,11 @@ namespace Opm {
         assertIJK(i,j,k);
         if (corner_index >= 8)
             throw std::invalid_argument("Invalid corner position");
+        if (m_cartesian)
+            return m_cartesian->getCornerPos( i , j , k , corner_index );
         {
             double x,y,z;
-            ecl_grid_get_cell_corner_xyz3( c_ptr() ,
+            ecl_grid_get_cell_corner_xyz3( c_geometry_ptr() ,
                                            static_cast<int>(i),
                                            static_cast<int>(j),
                                            static_cast<int>(k),
@@ -826,24 +1222,92 @@ namespace Opm {
 
     std::array<double, 3> EclipseGrid::getCellCenter(size_t i,size_t j, size_t k) const {
         assertIJK(i,j,k);
+        if (m_cartesian)
+            return m_cartesian->center( i, j, k );
+
+        if (this->cachedGeometry())
+            return getCellCenter( getGlobalIndex(i,j,k) );
         {
             double x,y,z;
-            ecl_grid_get_xyz3( c_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k), &x , &y , &z);
+            ecl_grid_get_xyz3( c_geometry_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k), &x , &y , &z);
             return std::array<double, 3>{{x,y,z}};
         }
     }
 
     double EclipseGrid::getCellDepth(size_t globalIndex) const {
         assertGlobalIndex( globalIndex );
-        return ecl_grid_get_cdepth1( c_ptr() , static_cast<int>(globalIndex));
+        if (m_cartesian) {
+            const auto ijk = cellIJK( globalIndex );
+            return getCellDepth( ijk[0], ijk[1], ijk[2] );
+        }
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->depth()[globalIndex];
+
+        return ecl_grid_get_cdepth1( c_geometry_ptr() , static_cast<int>(globalIndex));
     }
 
 
     double EclipseGrid::getCellDepth(size_t i,size_t j, size_t k) const {
         assertIJK(i,j,k);
-        return ecl_grid_get_cdepth3( c_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
+        if (m_cartesian)
+            return m_cartesian->top( i, j, k ) + m_cartesian->dz( i, j, k ) / 2;
+
+        if (const auto* geometry = this->cachedGeometry())
+            return geometry->depth()[getGlobalIndex(i,j,k)];
+
+        return ecl_grid_get_cdepth3( c_geometry_ptr() , static_cast<int>(i),static_cast<int>(j),static_cast<int>(k));
+    }
+
+
+
+    const GridGeometry& EclipseGrid::getGeometry() const {
+        return m_geometry.build( *this );
+    }
+
+    /*
+      The geometry used by the per cell getters of corner point grids;
+      the ERT grid is used until the cache exists. Grids with an implicit
+      geometry compute the per cell values from the CartesianGeometry
+      and never build the full geometry for a single cell.
+    */
+    const GridGeometry* EclipseGrid::cachedGeometry() const {
+        return m_geometry.get();
     }
 
+    const std::vector<double>& EclipseGrid::getCellVolumes() const {
+        return this->getGeometry().volume();
+    }
+
+    const std::vector<double>& EclipseGrid::getCellDepths() const {
+        return this->getGeometry().depth();
+    }
+
+    const std::vector<double>& EclipseGrid::getCellThicknesses() const {
+        return this->getGeometry().thickness();
+    }
+
+
+    EclipseGrid::geometry_cache::geometry_cache() :
+        m_slot( std::make_shared< slot >() )
+    {}
+
+    const GridGeometry* EclipseGrid::geometry_cache::get() const {
+        return m_slot->ptr.load( std::memory_order_acquire );
+    }
+
+    const GridGeometry& EclipseGrid::geometry_cache::build(const EclipseGrid& grid) const {
+        if (const auto* geometry = this->get())
+            return *geometry;
+
+        std::lock_guard< std::mutex > lock( m_slot->mutex );
+        if (!m_slot->geometry) {
+            m_slot->geometry = std::make_shared< const GridGeometry >( grid );
+            m_slot->ptr.store( m_slot->geometry.get(), std::memory_order_release );
+        }
+
+        return *m_slot->geometry;
+    }
 
 
     void EclipseGrid::exportACTNUM( std::vector<int>& actnum) const {
@@ -851,30 +1315,41 @@ namespace Opm {
         if (getNumActive() == volume)
             actnum.resize(0);
         else {
-            actnum.resize( volume );
-            ecl_grid_init_actnum_data( c_ptr() , actnum.data() );
+            GridMemory::resize( actnum, volume );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (size_t g = 0; g < volume; g++)
+                actnum[g] = (m_globalMap[g] >= 0);
         }
     }
 
     void EclipseGrid::exportMAPAXES( std::vector<double>& mapaxes) const {
-        if (ecl_grid_use_mapaxes( c_ptr())) {
+        if (!m_cartesian && ecl_grid_use_mapaxes( c_geometry_ptr())) {
             mapaxes.resize(6);
-            ecl_grid_init_mapaxes_data_double( c_ptr() , mapaxes.data() );
+            ecl_grid_init_mapaxes_data_double( c_geometry_ptr() , mapaxes.data() );
         } else {
             mapaxes.resize(0);
         }
     }
 
     void EclipseGrid::exportCOORD( std::vector<double>& coord) const {
-        coord.resize( ecl_grid_get_coord_size( c_ptr() ));
-        ecl_grid_init_coord_data_double( c_ptr() , coord.data() );
+        if (m_cartesian)
+            return m_cartesian->exportCOORD( coord );
+
+        GridMemory::resize( coord, ecl_grid_get_coord_size( c_geometry_ptr() ));
+        ecl_grid_init_coord_data_double( c_geometry_ptr() , coord.data() );
     }
 
     size_t EclipseGrid::exportZCORN( std::vector<double>& zcorn) const {
         ZcornMapper mapper( getNX(), getNY(), getNZ());
 
-        zcorn.resize( ecl_grid_get_zcorn_size( c_ptr() ));
-        ecl_grid_init_zcorn_data_double( c_ptr() , zcorn.data() );
+        if (m_cartesian)
+            m_cartesian->exportZCORN( zcorn );
+        else {
+            GridMemory::resize( zcorn, ecl_grid_get_zcorn_size( c_geometry_ptr() ));
+            ecl_grid_init_zcorn_data_double( c_geometry_ptr() , zcorn.data() );
+        }
 
         return mapper.fixupZCORN( zcorn );
     }
@@ -882,27 +1357,86 @@ namespace Opm {
 
 
     const std::vector<int>& EclipseGrid::getActiveMap() const {
-        if( !this->activeMap.empty() ) return this->activeMap;
+        return m_activeMap;
+    }
+
+    const std::vector<int>& EclipseGrid::getGlobalMap() const {
+        return m_globalMap;
+    }
 
-        this->activeMap.resize( this->getNumActive() );
-        const auto size = int(this->getCartesianSize());
+    void EclipseGrid::resetACTNUM( const int * actnum) {
+        m_grid.resetACTNUM( actnum );
+        initIndexMaps( actnum );
+    }
 
-        for( int global_index = 0; global_index < size; global_index++) {
-            // Using the low level C function to get the active index, because the C++
-            // version will throw for inactive cells.
-            int active_index = ecl_grid_get_active_index1( m_grid.get() , global_index );
-            if (active_index >= 0)
-                this->activeMap[ active_index ] = global_index;
+    void EclipseGrid::initIndexMaps() {
+        if (m_cartesian && !m_grid.get())
+            initIndexMaps( nullptr );
+        else if (static_cast<size_t>( ecl_grid_get_nactive( c_ptr() )) == getCartesianSize())
+            initIndexMaps( nullptr );
+        else {
+            std::vector<int> actnum( getCartesianSize() );
+            ecl_grid_init_actnum_data( c_ptr() , actnum.data() );
+            initIndexMaps( actnum.data() );
         }
-
-        return this->activeMap;
     }
 
-    void EclipseGrid::resetACTNUM( const int * actnum) {
-        ecl_grid_reset_actnum( m_grid.get() , actnum );
-        /* re-build the active map cache */
-        this->activeMap.clear();
-        this->getActiveMap();
+    /*
+      Builds the active <-> global index maps from the actnum array;
+      a nullptr actnum means that all cells are active. The active
+      index of a cell is the number of active cells before it, i.e. an
+      exclusive prefix sum of the active flags. The sum is done in
+      chunks: first the number of active cells in each chunk is
+      counted, and then - with the chunk offsets known - the chunks are
+      filled independently.
+    */
+    void EclipseGrid::initIndexMaps( const int * actnum) {
+        const size_t size = getCartesianSize();
+        m_globalMap.resize( size );
+
+        if (actnum == nullptr) {
+            m_activeMap.resize( size );
+            for (size_t g = 0; g < size; g++) {
+                m_globalMap[g] = static_cast<int>(g);
+                m_activeMap[g] = static_cast<int>(g);
+            }
+            return;
+        }
+
+        const size_t chunk_size = 1 << 16;
+        const int num_chunks = static_cast<int>( (size + chunk_size - 1) / chunk_size );
+        std::vector<int> offset( num_chunks + 1 , 0 );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            const size_t last = std::min( (chunk + 1) * chunk_size , size );
+            int count = 0;
+            for (size_t g = chunk * chunk_size; g < last; g++)
+                count += (actnum[g] != 0);
+            offset[chunk + 1] = count;
+        }
+
+        for (int chunk = 0; chunk < num_chunks; chunk++)
+            offset[chunk + 1] += offset[chunk];
+
+        m_activeMap.resize( offset.back() );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            const size_t last = std::min( (chunk + 1) * chunk_size , size );
+            int active_index = offset[chunk];
+            for (size_t g = chunk * chunk_size; g < last; g++) {
+                const int active = (actnum[g] != 0);
+                m_globalMap[g] = active ? active_index : -1;
+                if (active)
+                    m_activeMap[active_index] = static_cast<int>(g);
+                active_index += active;
+            }
+        }
     }
 
     ZcornMapper EclipseGrid::zcornMapper() const {
@@ -928,7 +1462,7 @@ namespace Opm {
         if ((i >= dims[0]) || (j >= dims[1]) || (k >= dims[2]) || (c < 0) || (c >= 8))
             throw std::invalid_argument("Invalid cell argument");
 
-        return i*stride[0] + j*stride[1] + k*stride[2] + cell_shift[c];
+        return this->unchecked_index(i,j,k,c);
     }
 
     size_t ZcornMapper::size() const {
@@ -947,67 +1481,93 @@ namespace Opm {
         return index(i,j,k,c);
     }
 
-    bool ZcornMapper::validZCORN( const std::vector<double>& zcorn) const {
-        int sign = zcorn[ this->index(0,0,0,0) ] <= zcorn[this->index(0,0, this->dims[2] - 1,4)] ? 1 : -1;
-        for (size_t j=0; j < this->dims[1]; j++)
-            for (size_t i=0; i < this->dims[0]; i++)
-                for (size_t c=0; c < 4; c++)
-                    for (size_t k=0; k < this->dims[2]; k++) {
-                        /* Between cells */
-                        if (k > 0) {
-                            size_t index1 = this->index(i,j,k-1,c+4);
-                            size_t index2 = this->index(i,j,k,c);
-                            if ((zcorn[index2] - zcorn[index1]) * sign < 0)
-                                return false;
-                        }
 
-                        /* In cell */
-                        {
-                            size_t index1 = this->index(i,j,k,c);
-                            size_t index2 = this->index(i,j,k,c+4);
-                            if ((zcorn[index2] - zcorn[index1]) * sign < 0)
-                                return false;
+namespace {
+
+    inline void assignZ( double& dst, double src, std::true_type ) { dst = src; }
+    inline void assignZ( const double&, double, std::false_type ) {}
+
+    /*
+      Runs through the zcorn vector and counts - and optionally fixes -
+      the points which are not monotone along their pillar. The zcorn
+      layout is such that for layer k the four top corners of all the
+      cells are stored in the block [2k*L, (2k+1)*L), and the bottom
+      corners in [(2k+1)*L, (2k+2)*L), with L = 4*nx*ny. The element m
+      of the top block, the element m of the bottom block and the
+      element m of the top block of layer k + 1 are therefore the same
+      corner of the same pillar, and the vector can be traversed in
+      memory order one layer at a time.
+
+      The corner columns m are independent; they are split in chunks
+      which are processed in parallel. Within a column the checks are
+      done from the top: first top(k) against bottom(k-1), then
+      bottom(k) against top(k). The result - and the count - is
+      therefore independent of the number of threads.
+    */
+
+    template< bool fixup, typename T >
+    size_t scanZCORN( T* zcorn, size_t layer_size, size_t nz, int sign ) {
+        const size_t chunk_size = 4096;
+        const int num_chunks = static_cast< int >( (layer_size + chunk_size - 1) / chunk_size );
+        size_t count = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:count)
+#endif
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            const size_t first = chunk * chunk_size;
+            const size_t last = std::min( first + chunk_size, layer_size );
+
+            for (size_t k = 0; k < nz; k++) {
+                T* top = zcorn + 2 * k * layer_size;
+                T* bottom = top + layer_size;
+
+                /* Cell to cell */
+                if (k > 0) {
+                    const T* above = top - layer_size;
+                    for (size_t m = first; m < last; m++) {
+                        if ((top[m] - above[m]) * sign < 0) {
+                            assignZ( top[m], above[m], std::integral_constant< bool, fixup >() );
+                            count++;
                         }
                     }
+                }
+
+                /* Cell internal */
+                for (size_t m = first; m < last; m++) {
+                    if ((bottom[m] - top[m]) * sign < 0) {
+                        assignZ( bottom[m], top[m], std::integral_constant< bool, fixup >() );
+                        count++;
+                    }
+                }
+            }
+        }
 
-        return true;
+        return count;
     }
 
+}
 
+    int ZcornMapper::sign( const std::vector<double>& zcorn ) const {
+        if (zcorn.size() != this->size())
+            throw std::invalid_argument("ZCORN vector has wrong size");
 
+        return zcorn[ this->index(0,0,0,0) ] <= zcorn[this->index(0,0, this->dims[2] - 1,4)] ? 1 : -1;
+    }
 
-    size_t ZcornMapper::fixupZCORN( std::vector<double>& zcorn) {
-        int sign = zcorn[ this->index(0,0,0,0) ] <= zcorn[this->index(0,0, this->dims[2] - 1,4)] ? 1 : -1;
-        size_t cells_adjusted = 0;
-
-        for (size_t k=0; k < this->dims[2]; k++)
-            for (size_t j=0; j < this->dims[1]; j++)
-                for (size_t i=0; i < this->dims[0]; i++)
-                    for (size_t c=0; c < 4; c++) {
-                        /* Cell to cell */
-                        if (k > 0) {
-                            size_t index1 = this->index(i,j,k-1,c+4);
-                            size_t index2 = this->index(i,j,k,c);
-
-                            if ((zcorn[index2] - zcorn[index1]) * sign < 0 ) {
-                                zcorn[index2] = zcorn[index1];
-                                cells_adjusted++;
-                            }
-                        }
+    bool ZcornMapper::validZCORN( const std::vector<double>& zcorn) const {
+        const int sign = this->sign( zcorn );
+        const size_t layer_size = 4 * this->dims[0] * this->dims[1];
 
+        return scanZCORN< false >( zcorn.data(), layer_size, this->dims[2], sign ) == 0;
+    }
 
-                        /* Cell internal */
-                        {
-                            size_t index1 = this->index(i,j,k,c);
-                            size_t index2 = this->index(i,j,k,c+4);
 
-                            if ((zcorn[index2] - zcorn[index1]) * sign < 0 ) {
-                                zcorn[index2] = zcorn[index1];
-                                cells_adjusted++;
-                            }
-                        }
-                    }
-        return cells_adjusted;
+    size_t ZcornMapper::fixupZCORN( std::vector<double>& zcorn) {
+        const int sign = this->sign( zcorn );
+        const size_t layer_size = 4 * this->dims[0] * this->dims[1];
+
+        return scanZCORN< true >( zcorn.data(), layer_size, this->dims[2], sign );
     }
 
 
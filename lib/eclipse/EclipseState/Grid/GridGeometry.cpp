@@ -0,0 +1,321 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/EclipseState/Grid/CartesianGeometry.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridDims.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridGeometry.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+
+#include <ert/ecl/ecl_grid.h>
+
+namespace Opm {
+
+namespace {
+
+    /*
+      The pillars in structure-of-arrays form; a point at depth z on
+      pillar p is (x0[p] + (z - z0[p]) * sx[p], y0[p] + (z - z0[p]) * sy[p], z).
+    */
+    struct Pillars {
+        Pillars( size_t nx, size_t ny, const std::vector< double >& coord ) {
+            const size_t size = (nx + 1) * (ny + 1);
+            if( coord.size() != 6 * size )
+                throw std::invalid_argument("COORD has wrong size");
+
+            x0.resize( size ); y0.resize( size ); z0.resize( size );
+            sx.resize( size ); sy.resize( size );
+
+            for( size_t p = 0; p < size; p++ ) {
+                const double* c = &coord[ 6 * p ];
+                const double dz = c[5] - c[2];
+
+                x0[p] = c[0];
+                y0[p] = c[1];
+                z0[p] = c[2];
+                sx[p] = dz == 0 ? 0.0 : (c[3] - c[0]) / dz;
+                sy[p] = dz == 0 ? 0.0 : (c[4] - c[1]) / dz;
+            }
+        }
+
+        std::vector< double > x0, y0, z0, sx, sy;
+    };
+
+    inline double tetVolume( const double* x, const double* y, const double* z,
+                             int a, int b, int c, int d ) {
+        const double ux = x[b] - x[a], uy = y[b] - y[a], uz = z[b] - z[a];
+        const double vx = x[c] - x[a], vy = y[c] - y[a], vz = z[c] - z[a];
+        const double wx = x[d] - x[a], wy = y[d] - y[a], wz = z[d] - z[a];
+
+        return ux * (vy * wz - vz * wy)
+             - uy * (vx * wz - vz * wx)
+             + uz * (vx * wy - vy * wx);
+    }
+
+    inline double planeDistance( const double* x, const double* y, int a, int b ) {
+        const double dx = x[b] - x[a];
+        const double dy = y[b] - y[a];
+        return std::sqrt( dx * dx + dy * dy );
+    }
+
+}
+
+    GridGeometry::GridGeometry( const GridDims& dims,
+                                const std::vector< double >& coord,
+                                const std::vector< double >& zcorn ) :
+        GridGeometry( dims, coord, zcorn, 0, dims.getCartesianSize() )
+    {}
+
+    GridGeometry::GridGeometry( const GridDims& dims,
+                                const std::vector< double >& coord,
+                                const std::vector< double >& zcorn,
+                                size_t first, size_t last ) :
+        m_first( first ),
+        m_last( last )
+    {
+        if( first > last || last > dims.getCartesianSize() )
+            throw std::invalid_argument("Invalid cell range");
+
+        this->compute( dims.getNX(), dims.getNY(), dims.getNZ(), coord, zcorn );
+    }
+
+    GridGeometry::GridGeometry( const EclipseGrid& grid ) :
+        GridGeometry( grid, 0, grid.getCartesianSize() )
+    {}
+
+    GridGeometry::GridGeometry( const EclipseGrid& grid, size_t first, size_t last ) :
+        m_first( first ),
+        m_last( last )
+    {
+        if( first > last || last > grid.getCartesianSize() )
+            throw std::invalid_argument("Invalid cell range");
+
+        if( const auto* cartesian = grid.getCartesianGeometry() ) {
+            this->compute( *cartesian );
+            return;
+        }
+
+        /*
+          The raw ZCORN values of the ERT grid are used, i.e. without the
+          fixup applied by EclipseGrid::exportZCORN().
+        */
+        std::vector< double > coord;
+        std::vector< double > zcorn( ecl_grid_get_zcorn_size( grid.c_geometry_ptr() ) );
+        grid.exportCOORD( coord );
+        ecl_grid_init_zcorn_data_double( grid.c_geometry_ptr(), zcorn.data() );
+
+        this->compute( grid.getNX(), grid.getNY(), grid.getNZ(), coord, zcorn );
+    }
+
+    GridGeometry::GridGeometry( const CartesianGeometry& geometry ) :
+        GridGeometry( geometry, 0, geometry.getNX() * geometry.getNY() * geometry.getNZ() )
+    {}
+
+    GridGeometry::GridGeometry( const CartesianGeometry& geometry, size_t first, size_t last ) :
+        m_first( first ),
+        m_last( last )
+    {
+        if( first > last || last > geometry.getNX() * geometry.getNY() * geometry.getNZ() )
+            throw std::invalid_argument("Invalid cell range");
+
+        this->compute( geometry );
+    }
+
+    void GridGeometry::resize( size_t size ) {
+        m_volume.resize( size );
+        m_x.resize( size );
+        m_y.resize( size );
+        m_z.resize( size );
+        m_thickness.resize( size );
+        m_dx.resize( size );
+        m_dy.resize( size );
+    }
+
+    /*
+      Box cells: the cells of one k layer are processed together, with
+      the x offset accumulated along each row and the y offset along
+      each column, in the same way as ERT ecl_grid_alloc_dx_dy_dz_tops().
+    */
+    void GridGeometry::compute( const CartesianGeometry& geometry ) {
+        const size_t size = m_last - m_first;
+        this->resize( size );
+        if( size == 0 ) return;
+
+        const size_t nx = geometry.getNX();
+        const size_t ny = geometry.getNY();
+        const size_t area = nx * ny;
+        const size_t first_layer = m_first / area;
+        const int num_layers = static_cast< int >( (m_last + area - 1) / area - first_layer );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for( int l = 0; l < num_layers; l++ ) {
+            const size_t k = first_layer + l;
+            std::vector< double > y0( nx, 0.0 );
+
+            for( size_t j = 0; j < ny; j++ ) {
+                double x0 = 0;
+                for( size_t i = 0; i < nx; i++ ) {
+                    const size_t g = i + j * nx + k * area;
+                    const double dx = geometry.dx( i, j, k );
+                    const double dy = geometry.dy( i, j, k );
+
+                    if( g >= m_first && g < m_last ) {
+                        const double dz = geometry.dz( i, j, k );
+                        const size_t n = g - m_first;
+
+                        m_volume[n] = dx * dy * dz;
+                        m_x[n] = x0 + dx / 2;
+                        m_y[n] = y0[i] + dy / 2;
+                        m_z[n] = geometry.top( i, j, k ) + dz / 2;
+                        m_thickness[n] = dz;
+                        m_dx[n] = dx;
+                        m_dy[n] = dy;
+                    }
+
+                    x0 += dx;
+                    y0[i] += dy;
+                }
+            }
+        }
+    }
+
+    void GridGeometry::compute( size_t nx, size_t ny, size_t nz,
+                                const std::vector< double >& coord,
+                                const std::vector< double >& zcorn ) {
+        if( zcorn.size() != 8 * nx * ny * nz )
+            throw std::invalid_argument("ZCORN has wrong size");
+
+        const size_t size = m_last - m_first;
+        this->resize( size );
+        if( size == 0 ) return;
+
+        const Pillars pillars( nx, ny, coord );
+
+        /*
+          The cells are processed one (j,k) row at a time; the rows are
+          independent and the cells in a row are contiguous both in the
+          output arrays and in ZCORN.
+        */
+        const size_t first_row = m_first / nx;
+        const size_t last_row = (m_last + nx - 1) / nx;
+        const int num_rows = static_cast< int >( last_row - first_row );
+        const int nthreads = GridKernels::threads();
+        (void) nthreads;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+#endif
+        for( int r = 0; r < num_rows; r++ ) {
+            const size_t row = first_row + r;
+            const size_t j = row % ny;
+            const size_t k = row / ny;
+            const size_t g0 = row * nx;
+            const size_t i_begin = std::max( m_first, g0 ) - g0;
+            const size_t i_end = std::min( m_last, g0 + nx ) - g0;
+
+            /* ZCORN offsets of the top corners of cell (0, j, k) */
+            const size_t z_top = 8 * nx * ny * k + 4 * nx * j;
+            const size_t z_shift[8] = { 0, 1, 2 * nx, 2 * nx + 1,
+                                        4 * nx * ny, 4 * nx * ny + 1,
+                                        4 * nx * ny + 2 * nx, 4 * nx * ny + 2 * nx + 1 };
+
+            for( size_t i = i_begin; i < i_end; i++ ) {
+                double x[8], y[8], z[8];
+
+                for( int c = 0; c < 8; c++ ) {
+                    const size_t p = (i + (c & 1)) + (j + ((c >> 1) & 1)) * (nx + 1);
+                    const double zc = zcorn[ z_top + 2 * i + z_shift[c] ];
+                    const double h = zc - pillars.z0[p];
+
+                    x[c] = pillars.x0[p] + h * pillars.sx[p];
+                    y[c] = pillars.y0[p] + h * pillars.sy[p];
+                    z[c] = zc;
+                }
+
+                double cx = 0, cy = 0, cz = 0;
+                for( int c = 0; c < 8; c++ ) {
+                    cx += x[c];
+                    cy += y[c];
+                    cz += z[c];
+                }
+
+                const double volume = tetVolume( x, y, z, 0, 1, 3, 7 )
+                                    + tetVolume( x, y, z, 0, 3, 2, 7 )
+                                    + tetVolume( x, y, z, 0, 2, 6, 7 )
+                                    + tetVolume( x, y, z, 0, 6, 4, 7 )
+                                    + tetVolume( x, y, z, 0, 4, 5, 7 )
+                                    + tetVolume( x, y, z, 0, 5, 1, 7 );
+
+                const size_t n = g0 + i - m_first;
+                m_volume[n] = std::fabs( volume ) / 6.0;
+                m_x[n] = cx / 8;
+                m_y[n] = cy / 8;
+                m_z[n] = cz / 8;
+                m_thickness[n] = ((z[4] - z[0]) + (z[5] - z[1])
+                                + (z[6] - z[2]) + (z[7] - z[3])) / 4;
+                m_dx[n] = (planeDistance( x, y, 0, 1 ) + planeDistance( x, y, 2, 3 )
+                         + planeDistance( x, y, 4, 5 ) + planeDistance( x, y, 6, 7 )) / 4;
+                m_dy[n] = (planeDistance( x, y, 0, 2 ) + planeDistance( x, y, 1, 3 )
+                         + planeDistance( x, y, 4, 6 ) + planeDistance( x, y, 5, 7 )) / 4;
+            }
+        }
+    }
+
+    size_t GridGeometry::size() const {
+        return m_last - m_first;
+    }
+
+    size_t GridGeometry::first() const {
+        return m_first;
+    }
+
+    const std::vector< double >& GridGeometry::volume() const {
+        return m_volume;
+    }
+
+    const std::vector< double >& GridGeometry::centerX() const {
+        return m_x;
+    }
+
+    const std::vector< double >& GridGeometry::centerY() const {
+        return m_y;
+    }
+
+    const std::vector< double >& GridGeometry::depth() const {
+        return m_z;
+    }
+
+    const std::vector< double >& GridGeometry::thickness() const {
+        return m_thickness;
+    }
+
+    const std::vector< double >& GridGeometry::dx() const {
+        return m_dx;
+    }
+
+    const std::vector< double >& GridGeometry::dy() const {
+        return m_dy;
+    }
+}
@@ -17,10 +17,17 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <map>
+#include <stdexcept>
+#include <utility>
 
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperties.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 #include <opm/parser/eclipse/Utility/String.hpp>
 
 namespace Opm {
@@ -36,6 +43,13 @@ namespace Opm {
         return kw;
     }
 
+    /* true if normalize() would return a copy of the keyword */
+    static bool isNormalized(const std::string& keyword) {
+        return std::none_of( keyword.begin(), keyword.end(), []( char c ) {
+            return c == ' ' || std::islower( static_cast< unsigned char >( c ) );
+        });
+    }
+
     template<typename> bool isFipxxx( const std::string& ) { return false; }
 
     template<>
@@ -58,7 +72,7 @@ namespace Opm {
         m_deckUnitSystem( deckUnitSystem )
     {
         for (auto iter = supportedKeywords.begin(); iter != supportedKeywords.end(); ++iter)
-            m_supportedKeywords.emplace( iter->getKeywordName(), std::move( *iter ) );
+            registerKeyword( std::move( *iter ) );
     }
 
 
@@ -70,7 +84,7 @@ namespace Opm {
         nz( eclipseGrid.getNZ() )
     {
         for (auto iter = supportedKeywords.begin(); iter != supportedKeywords.end(); ++iter)
-            m_supportedKeywords.emplace( iter->getKeywordName(), std::move( *iter ) );
+            registerKeyword( std::move( *iter ) );
     }
 
 
@@ -166,29 +180,102 @@ namespace Opm {
     }
 
     template< typename T >
-    bool GridProperties<T>::supportsKeyword(const std::string& keyword) const {
-        const std::string kw = normalize(keyword);
-        return m_supportedKeywords.count( kw ) > 0 || isFipxxx<T>(kw);
+    void GridProperties<T>::memoryUsage( MemoryUsage& usage, const std::string& prefix ) const {
+        for( const auto& pair : m_properties )
+            usage.add( prefix + "/" + pair.first,
+                       memory::tree_node + sizeof( pair ) + memory::heap( pair.first )
+                       + pair.second.memoryUsage() );
+
+        usage.add( prefix + "/index", memory::heap( m_supportedKeywords )
+                                      + memory::heap( m_handles )
+                                      + memory::heap( m_byHandle )
+                                      + memory::heap( m_autoGeneratedProperties )
+                                      + m_messages.memoryUsage() );
     }
 
     template< typename T >
-    bool GridProperties<T>::hasKeyword(const std::string& keyword) const {
-        const std::string kw = normalize( keyword );
+    GridProperties<T>::GridProperties(const GridProperties& other) :
+        nx( other.nx ),
+        ny( other.ny ),
+        nz( other.nz ),
+        m_deckUnitSystem( other.m_deckUnitSystem ),
+        m_messages( other.m_messages ),
+        m_supportedKeywords( other.m_supportedKeywords ),
+        m_handles( other.m_handles ),
+        m_byHandle( other.m_byHandle.size(), nullptr ),
+        m_properties( other.m_properties ),
+        m_autoGeneratedProperties( other.m_autoGeneratedProperties )
+    {
+        for (auto& pair : m_properties)
+            m_byHandle[ m_handles.at( pair.first ) ] = &pair.second;
+    }
 
-        const auto cnt = m_properties.count( kw );
-        const bool positive = cnt > 0;
+    template< typename T >
+    GridProperties<T>& GridProperties<T>::operator=(const GridProperties& other) {
+        if (this != &other) {
+            GridProperties copy( other );
+            *this = std::move( copy );
+        }
+        return *this;
+    }
 
-        return positive;
+    template< typename T >
+    const size_t* GridProperties<T>::findHandle(const std::string& keyword) const {
+        const auto iter = isNormalized( keyword ) ? m_handles.find( keyword )
+                                                  : m_handles.find( normalize( keyword ) );
+        return iter == m_handles.end() ? nullptr : &iter->second;
     }
 
     template< typename T >
-    bool GridProperties<T>::hasDeckKeyword(const std::string& keyword) const {
+    size_t GridProperties<T>::registerKeyword(SupportedKeywordInfo&& supportedKeyword) const {
+        const auto result = m_handles.emplace( supportedKeyword.getKeywordName(), m_supportedKeywords.size() );
+        if (result.second) {
+            m_supportedKeywords.push_back( std::move( supportedKeyword ) );
+            m_byHandle.push_back( nullptr );
+        }
+        return result.first->second;
+    }
+
+    template< typename T >
+    size_t GridProperties<T>::getHandle(const std::string& keyword) const {
+        if (const size_t* handle = findHandle( keyword ))
+            return *handle;
+
         const std::string kw = normalize( keyword );
+        if (!isFipxxx<T>( kw ))
+            throw std::invalid_argument("The keyword: " + kw + " is not supported in this container");
 
-        const auto cnt = m_properties.count( kw );
-        const bool positive = cnt > 0;
+        return registerKeyword( SupportedKeywordInfo( kw , 1, "1" ) );
+    }
 
-        return positive && !isAutoGenerated_( kw );
+    template< typename T >
+    bool GridProperties<T>::hasKeyword(size_t handle) const {
+        return m_byHandle.at( handle ) != nullptr;
+    }
+
+    template< typename T >
+    const GridProperty<T>& GridProperties<T>::getKeyword(size_t handle) const {
+        GridProperty<T>& property = getOrGenerate( handle );
+        property.runPostProcessor( );
+        return property;
+    }
+
+    template< typename T >
+    bool GridProperties<T>::supportsKeyword(const std::string& keyword) const {
+        return findHandle( keyword ) || isFipxxx<T>( normalize( keyword ) );
+    }
+
+    template< typename T >
+    bool GridProperties<T>::hasKeyword(const std::string& keyword) const {
+        const size_t* handle = findHandle( keyword );
+        return handle && m_byHandle[ *handle ];
+    }
+
+    template< typename T >
+    bool GridProperties<T>::hasDeckKeyword(const std::string& keyword) const {
+        const size_t* handle = findHandle( keyword );
+        return handle && m_byHandle[ *handle ]
+            && !isAutoGenerated_( m_supportedKeywords[ *handle ].getKeywordName() );
     }
 
 
@@ -201,19 +288,13 @@ namespace Opm {
 
     template< typename T >
     void GridProperties<T>::assertKeyword(const std::string& keyword) const {
-        const std::string kw = normalize(keyword);
-        if (m_properties.count( kw ) == 0)
-            addAutoGeneratedKeyword_(kw);
-
-        GridProperty<T>& property = m_properties.at( kw );
-        property.runPostProcessor( );
+        getKeyword( getHandle( keyword ) );
     }
 
 
     template< typename T >
     const GridProperty<T>& GridProperties<T>::getKeyword(const std::string& keyword) const {
-        assertKeyword( keyword );
-        return m_properties.at( keyword );
+        return getKeyword( getHandle( keyword ) );
     }
 
 
@@ -223,7 +304,7 @@ namespace Opm {
         const std::string kw = normalize(keyword);
 
         if (hasDeckKeyword(kw))
-            return m_properties.at( kw );
+            return *m_byHandle[ getHandle( kw ) ];
         else {
             if (supportsKeyword(kw))
                 throw std::invalid_argument("Keyword: " + kw + " is supported - but not initialized.");
@@ -233,9 +314,15 @@ namespace Opm {
     }
 
     template< typename T >
-    void GridProperties<T>::insertKeyword(const SupportedKeywordInfo& supportedKeyword) const {
-        m_properties.emplace( supportedKeyword.getKeywordName(), 
-                GridProperty<T>( this->nx, this->ny , this->nz , supportedKeyword ));
+    void GridProperties<T>::insertKeyword(size_t handle) const {
+        insertProperty( handle, GridProperty<T>( this->nx, this->ny , this->nz , m_supportedKeywords[ handle ] ));
+    }
+
+    template< typename T >
+    void GridProperties<T>::insertProperty(size_t handle, GridProperty<T>&& property) const {
+        const std::string keyword = property.getKeywordName();
+        const auto result = m_properties.emplace( keyword, std::move( property ) );
+        m_byHandle[ handle ] = &result.first->second;
     }
 
 
@@ -261,10 +348,7 @@ namespace Opm {
                 return true;
             }
 
-            if (isFipxxx<T>(kw))
-                m_supportedKeywords.emplace(kw, SupportedKeywordInfo( kw , 1, "1" ));
-
-            insertKeyword( m_supportedKeywords.at( kw ) );
+            insertKeyword( getHandle( kw ) );
             return true;
         }
     }
@@ -299,39 +383,85 @@ namespace Opm {
 
     template< typename T >
     void GridProperties<T>::handleADDRecord( const DeckRecord& record, BoxManager& boxManager) {
+        GridPropertyEdits<T> edits;
+        handleADDRecord( record, boxManager, edits );
+        edits.apply();
+    }
+
+    template< typename T >
+    void GridProperties<T>::handleMULTIPLYRecord( const DeckRecord& record, BoxManager& boxManager) {
+        GridPropertyEdits<T> edits;
+        handleMULTIPLYRecord( record, boxManager, edits );
+        edits.apply();
+    }
+
+    template< typename T >
+    void GridProperties<T>::handleCOPYRecord( const DeckRecord& record, BoxManager& boxManager) {
+        GridPropertyEdits<T> edits;
+        handleCOPYRecord( record, boxManager, edits );
+        edits.apply();
+    }
+
+    template< typename T >
+    void GridProperties<T>::handleEQUALSRecord( const DeckRecord& record, BoxManager& boxManager) {
+        GridPropertyEdits<T> edits;
+        handleEQUALSRecord( record, boxManager, edits );
+        edits.apply();
+    }
+
+    template< typename T >
+    void GridProperties<T>::handleADDRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits) {
         const std::string& field = record.getItem("field").get< std::string >(0);
 
         if (hasKeyword( field )) {
             GridProperty<T>& property = getKeyword( field );
             T shiftValue  = convertInputValue( property , record.getItem("shift").get< double >(0) );
             setKeywordBox(record, boxManager);
-            property.add( shiftValue , boxManager.getActiveBox() );
+            if (property.isSparse())
+                property.add( shiftValue , boxManager.getActiveBox() );
+            else
+                edits.add( property.getData(), shiftValue , boxManager.getActiveBox() );
         } else
             throw std::invalid_argument("Fatal error processing ADD keyword. Tried to shift not defined keyword " + field);
     }
 
     template< typename T >
-    void GridProperties<T>::handleMULTIPLYRecord( const DeckRecord& record, BoxManager& boxManager) {
+    void GridProperties<T>::handleMULTIPLYRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits) {
         const std::string& field = record.getItem("field").get< std::string >(0);
 
         if (hasKeyword( field )) {
             GridProperty<T>& property = getKeyword( field );
             T factor  = convertInputValue( record.getItem("factor").get< double >(0) );
             setKeywordBox(record, boxManager);
-            property.scale( factor , boxManager.getActiveBox() );
+            if (property.isSparse())
+                property.scale( factor , boxManager.getActiveBox() );
+            else
+                edits.multiply( property.getData(), factor , boxManager.getActiveBox() );
         } else
             throw std::invalid_argument("Fatal error processing ADD keyword. Tried to shift not defined keyword " + field);
     }
 
 
     template< typename T >
-    void GridProperties<T>::handleCOPYRecord( const DeckRecord& record, BoxManager& boxManager) {
+    void GridProperties<T>::handleCOPYRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits) {
         const std::string& srcField = record.getItem("src").get< std::string >(0);
         const std::string& targetField = record.getItem("target").get< std::string >(0);
 
         if (hasKeyword( srcField )) {
             setKeywordBox(record, boxManager);
-            copyKeyword( srcField , targetField , boxManager.getActiveBox() );
+            const auto& src = getKeyword( srcField );
+            auto& target = getOrCreateProperty( targetField );
+            /*
+              The pending edits may write to the source. A sparse source
+              is read through a snapshot which a later sparse update of
+              the source frees again, so the copy can not wait for the
+              edits to be applied.
+            */
+            if (target.isSparse() || src.isSparse()) {
+                edits.apply();
+                target.copyFrom( src, boxManager.getActiveBox() );
+            } else
+                edits.copy( target.getData(), src.getData(), boxManager.getActiveBox() );
         } else {
             if (!supportsKeyword( srcField))
                 throw std::invalid_argument("Fatal error processing COPY keyword."
@@ -340,7 +470,7 @@ namespace Opm {
     }
 
     template< typename T >
-    void GridProperties<T>::handleEQUALSRecord( const DeckRecord& record, BoxManager& boxManager) {
+    void GridProperties<T>::handleEQUALSRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits) {
         const std::string& field = record.getItem("field").get< std::string >(0);
         double      value  = record.getItem("value").get< double >(0);
 
@@ -349,12 +479,26 @@ namespace Opm {
             T targetValue = convertInputValue( property , value );
 
             setKeywordBox(record, boxManager);
-            property.setScalar( targetValue , boxManager.getActiveBox() );
+            if (property.isSparse())
+                property.setScalar( targetValue , boxManager.getActiveBox() );
+            else
+                edits.assign( property.getData(), targetValue , boxManager.getActiveBox() );
         } else
             throw std::invalid_argument("Fatal error processing EQUALS keyword. Tried to set not defined keyword " + field);
     }
 
 
+    /*
+      The cells of a region are copied out of the index before the
+      target data is taken: the target can be the region property
+      itself, and the index must not be used once getData() has handed
+      out a reference for writing.
+    */
+    static std::vector< size_t > regionCellList( const GridProperty<int>& regionProperty, int regionValue ) {
+        const auto cells = regionProperty.regionCells().cells( regionValue );
+        return std::vector< size_t >( cells.begin(), cells.end() );
+    }
+
     template< typename T >
     void GridProperties<T>::handleEQUALREGRecord( const DeckRecord& record, const GridProperty<int>& regionProperty ) {
         const std::string& targetArray = record.getItem("ARRAY").get< std::string >(0);
@@ -363,10 +507,11 @@ namespace Opm {
             double inputValue = record.getItem("VALUE").get<double>(0);
             int regionValue = record.getItem("REGION_NUMBER").get<int>(0);
             T targetValue = convertInputValue( targetProperty , inputValue );
-            std::vector<bool> mask;
+            const auto cells = regionCellList( regionProperty, regionValue );
+            auto& data = targetProperty.getData();
 
-            regionProperty.initMask( regionValue , mask);
-            targetProperty.maskedSet( targetValue , mask);
+            for (auto g : cells)
+                data[g] = targetValue;
         } else
             throw std::invalid_argument("Fatal error processing EQUALREG record - invalid/undefined keyword: " + targetArray);
     }
@@ -379,10 +524,11 @@ namespace Opm {
             double inputValue = record.getItem("SHIFT").get<double>(0);
             int regionValue = record.getItem("REGION_NUMBER").get<int>(0);
             T shiftValue = convertInputValue( targetProperty , inputValue );
-            std::vector<bool> mask;
+            const auto cells = regionCellList( regionProperty, regionValue );
+            auto& data = targetProperty.getData();
 
-            regionProperty.initMask( regionValue , mask);
-            targetProperty.maskedAdd( shiftValue , mask);
+            for (auto g : cells)
+                data[g] += shiftValue;
         } else
             throw std::invalid_argument("Fatal error processing ADDREG record - invalid/undefined keyword: " + targetArray);
     }
@@ -395,10 +541,11 @@ namespace Opm {
             double inputValue = record.getItem("FACTOR").get<double>(0);
             int regionValue = record.getItem("REGION_NUMBER").get<int>(0);
             T factor = convertInputValue( inputValue );
-            std::vector<bool> mask;
+            const auto cells = regionCellList( regionProperty, regionValue );
+            auto& data = targetProperty.getData();
 
-            regionProperty.initMask( regionValue , mask);
-            targetProperty.maskedMultiply( factor , mask);
+            for (auto g : cells)
+                data[g] *= factor;
         } else
             throw std::invalid_argument("Fatal error processing MULTIREG record - invalid/undefined keyword: " + targetArray);
     }
@@ -416,106 +563,197 @@ namespace Opm {
 
         {
             int regionValue = record.getItem("REGION_NUMBER").get< int >(0);
-            std::vector<bool> mask;
             GridProperty<T>& targetProperty = getOrCreateProperty( targetArray );
-            GridProperty<T>& srcProperty = getKeyword( srcArray );
+            const auto& srcData = getKeyword( srcArray ).getData();
+            const auto cells = regionCellList( regionProperty, regionValue );
+            auto& data = targetProperty.getData();
 
-            regionProperty.initMask( regionValue , mask);
-            targetProperty.maskedCopy( srcProperty , mask );
+            for (auto g : cells)
+                data[g] = srcData[g];
         }
     }
 
     namespace {
         /*
-          The functions in this namespace are those listed as
-          available operations in the OPERATE keyword.
+          The kernels in this namespace are those listed as available
+          operations in the OPERATE keyword.
         */
 
-        double MULTA(double, double X, double alpha, double beta) {
-            return alpha*X + beta;
+        enum class Operation {
+            MULTA, POLY, SLOG, LOG10, LOGE, INV, MULTX,
+            ADDX, COPY, MAXLIM, MINLIM, MULTP, ABS, MULTIPLY
+        };
+
+        Operation operationFromString( const std::string& operation ) {
+            static const std::map< std::string, Operation > operations = {
+                { "MULTA"    , Operation::MULTA },
+                { "POLY"     , Operation::POLY },
+                { "SLOG"     , Operation::SLOG },
+                { "LOG10"    , Operation::LOG10 },
+                { "LOGE"     , Operation::LOGE },
+                { "INV"      , Operation::INV },
+                { "MULTX"    , Operation::MULTX },
+                { "ADDX"     , Operation::ADDX },
+                { "COPY"     , Operation::COPY },
+                { "MAXLIM"   , Operation::MAXLIM },
+                { "MINLIM"   , Operation::MINLIM },
+                { "MULTP"    , Operation::MULTP },
+                { "ABS"      , Operation::ABS },
+                { "MULTIPLY" , Operation::MULTIPLY } };
+
+            const auto iter = operations.find( operation );
+            if (iter == operations.end())
+                throw std::invalid_argument("Fatal error processing OPERATE record - invalid operation: " + operation);
+
+            return iter->second;
         }
 
+        struct MULTA {
+            static double apply(double, double X, double alpha, double beta) {
+                return alpha*X + beta;
+            }
+        };
+
         // NB: The POLY function and the MULTIPLY function both use
         // the R value in the calculation. That implies that we should
         // ideally check that the R property has already been
         // initialized with a valid value, For all the other
         // operations R only appears on the left side of the equation,
         // and can be fully assigned to.
-        double POLY(double R, double X, double alpha, double beta) {
-            return R + alpha * std::pow(X , beta );
-        }
+        struct POLY {
+            static double apply(double R, double X, double alpha, double beta) {
+                return R + alpha * std::pow(X , beta );
+            }
+        };
 
-        double MULTIPLY(double R, double X, double , double ) {
-            return R * X;
-        }
+        struct MULTIPLY {
+            static double apply(double R, double X, double , double ) {
+                return R * X;
+            }
+        };
 
-        double SLOG(double, double X, double alpha, double beta) {
-            return pow(10 , alpha + beta * X);
-        }
+        struct SLOG {
+            static double apply(double, double X, double alpha, double beta) {
+                return std::pow(10 , alpha + beta * X);
+            }
+        };
 
-        double LOG10(double, double X, double , double ) {
-            return log10(X);
-        }
+        struct LOG10 {
+            static double apply(double, double X, double , double ) {
+                return std::log10(X);
+            }
+        };
 
-        double LOGE(double, double X, double , double ) {
-            return log(X);
-        }
+        struct LOGE {
+            static double apply(double, double X, double , double ) {
+                return std::log(X);
+            }
+        };
 
-        double INV(double, double X, double , double ) {
-            return 1.0/X;
-        }
+        struct INV {
+            static double apply(double, double X, double , double ) {
+                return 1.0/X;
+            }
+        };
 
-        double MULTX(double, double X, double alpha, double ) {
-            return alpha * X;
-        }
+        struct MULTX {
+            static double apply(double, double X, double alpha, double ) {
+                return alpha * X;
+            }
+        };
 
-        double ADDX(double, double X, double alpha, double ) {
-            return alpha + X;
-        }
+        struct ADDX {
+            static double apply(double, double X, double alpha, double ) {
+                return alpha + X;
+            }
+        };
 
-        double COPY(double, double X, double, double ) {
-            return X;
-        }
+        struct COPY {
+            static double apply(double, double X, double, double ) {
+                return X;
+            }
+        };
 
-        double MAXLIM(double, double X, double alpha, double ) {
-            return std::min( alpha , X );
-        }
+        struct MAXLIM {
+            static double apply(double, double X, double alpha, double ) {
+                return std::min( alpha , X );
+            }
+        };
 
-        double MINLIM(double, double X, double alpha, double ) {
-            return std::max( alpha , X );
+        struct MINLIM {
+            static double apply(double, double X, double alpha, double ) {
+                return std::max( alpha , X );
+            }
+        };
+
+        struct MULTP {
+            static double apply(double, double X, double alpha, double beta) {
+                return alpha * std::pow(X, beta );
+            }
+        };
+
+        struct ABS {
+            static double apply(double, double X, double, double) {
+                return std::abs(X);
+            }
+        };
+
+        /* Runs shorter than this are not split over the OpenMP threads. */
+        const size_t parallel_run = 1 << 16;
+
+        /*
+          Apply the operation to one run of consecutive cells. The kernel
+          is inlined into the loop, so the compiler vectorizes the
+          arithmetic operations; the operations calling the math library
+          (POLY, SLOG, LOG10, LOGE and MULTP) still call the scalar
+          function for each element. The results are therefore identical
+          to applying the kernel cell by cell. The target and source may
+          be the same array.
+        */
+        template< typename Op, typename T >
+        void operateRun( T* R, const T* X, size_t length, double alpha, double beta ) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(GridKernels::threads()) if(length >= parallel_run)
+#endif
+            for (size_t i = 0; i < length; i++)
+                R[i] = Op::apply( R[i], X[i], alpha, beta );
         }
 
-        double MULTP(double, double X, double alpha, double beta) {
-            return alpha * pow(X, beta );
+        template< typename Op, typename T >
+        void operateBox( std::vector< T >& R, const std::vector< T >& X, const Box& box, double alpha, double beta ) {
+            box.forEachRun( [&]( size_t start, size_t, size_t length ) {
+                operateRun< Op >( R.data() + start, X.data() + start, length, alpha, beta );
+            });
         }
 
-        double ABS(double, double X, double, double) {
-            return std::abs(X);
+        template< typename T >
+        void operate( Operation operation, std::vector< T >& R, const std::vector< T >& X,
+                      const Box& box, double alpha, double beta ) {
+            switch (operation) {
+                case Operation::MULTA:    return operateBox< MULTA >( R, X, box, alpha, beta );
+                case Operation::POLY:     return operateBox< POLY >( R, X, box, alpha, beta );
+                case Operation::SLOG:     return operateBox< SLOG >( R, X, box, alpha, beta );
+                case Operation::LOG10:    return operateBox< LOG10 >( R, X, box, alpha, beta );
+                case Operation::LOGE:     return operateBox< LOGE >( R, X, box, alpha, beta );
+                case Operation::INV:      return operateBox< INV >( R, X, box, alpha, beta );
+                case Operation::MULTX:    return operateBox< MULTX >( R, X, box, alpha, beta );
+                case Operation::ADDX:     return operateBox< ADDX >( R, X, box, alpha, beta );
+                case Operation::COPY:     return operateBox< COPY >( R, X, box, alpha, beta );
+                case Operation::MAXLIM:   return operateBox< MAXLIM >( R, X, box, alpha, beta );
+                case Operation::MINLIM:   return operateBox< MINLIM >( R, X, box, alpha, beta );
+                case Operation::MULTP:    return operateBox< MULTP >( R, X, box, alpha, beta );
+                case Operation::ABS:      return operateBox< ABS >( R, X, box, alpha, beta );
+                case Operation::MULTIPLY: return operateBox< MULTIPLY >( R, X, box, alpha, beta );
+            }
         }
     }
 
 
     template <typename T>
     void GridProperties<T>::handleOPERATERecord( const DeckRecord& record, BoxManager& boxManager) {
-        using  operate_fptr = decltype( &MULTA );
-        static const std::map<std::string , operate_fptr> operations = {{"MULTA"  , &MULTA},
-                                                                        {"POLY"   , &POLY},
-                                                                        {"SLOG"   , &SLOG},
-                                                                        {"LOG10"  , &LOG10},
-                                                                        {"LOGE"   , &LOGE},
-                                                                        {"INV"    , &INV},
-                                                                        {"MULTX"  , &MULTX},
-                                                                        {"ADDX"   , &ADDX},
-                                                                        {"COPY"   , &COPY},
-                                                                        {"MAXLIM" , &MAXLIM},
-                                                                        {"MINLIM" , &MINLIM},
-                                                                        {"MULTP"  , &MULTP},
-                                                                        {"ABS"    , &ABS},
-                                                                        {"MULTIPLY" , &MULTIPLY}};
-
         const std::string& srcArray    = record.getItem("ARRAY").get< std::string >(0);
         const std::string& targetArray = record.getItem("TARGET_ARRAY").get< std::string >(0);
-        const std::string& operation   = record.getItem("OPERATION").get< std::string >(0);
+        const auto operation           = operationFromString( record.getItem("OPERATION").get< std::string >(0) );
         double alpha = record.getItem("PARAM1").get< double >(0);
         double beta = record.getItem("PARAM2").get< double >(0);
 
@@ -528,11 +766,9 @@ namespace Opm {
         {
             const std::vector<T>& srcData = getKeyword( srcArray ).getData();
             std::vector<T>& targetData = getOrCreateProperty( targetArray ).getData();
-            operate_fptr func = operations.at( operation );
 
             setKeywordBox(record, boxManager);
-            for (auto index : boxManager.getActiveBox())
-                targetData[index] = func( targetData[index] , srcData[index] , alpha, beta );
+            operate( operation, targetData, srcData, boxManager.getActiveBox(), alpha, beta );
         }
     }
 
@@ -541,23 +777,42 @@ namespace Opm {
     void GridProperties<T>::postAddKeyword(const std::string& name,
                                            const T defaultValue,
                                            std::function< void( std::vector< T >& ) > postProcessor,
+                                           std::vector< std::string > dependencies,
                                            const std::string& dimString )
     {
-        m_supportedKeywords.emplace(name,
-                                    SupportedKeywordInfo( name,
-                                                          defaultValue,
-                                                          postProcessor,
-                                                          dimString ));
+        registerKeyword( SupportedKeywordInfo( name,
+                                               defaultValue,
+                                               postProcessor,
+                                               std::move( dependencies ),
+                                               dimString ));
     }
 
     template< typename T >
-    GridProperty<T>& GridProperties<T>::getKeyword(const std::string& keyword) {
-        const std::string kw = normalize(keyword);
+    const typename GridProperties<T>::SupportedKeywordInfo*
+    GridProperties<T>::keywordInfo(const std::string& keyword) const {
+        const size_t* handle = findHandle( keyword );
+        return handle ? &m_supportedKeywords[ *handle ] : nullptr;
+    }
+
+    template< typename T >
+    GridProperty<T> GridProperties<T>::createProperty(const std::string& keyword) const {
+        return GridProperty<T>( this->nx, this->ny, this->nz, m_supportedKeywords[ getHandle( keyword ) ] );
+    }
+
+    template< typename T >
+    void GridProperties<T>::insertAutoGenerated(GridProperty<T>&& property) const {
+        const std::string keyword = property.getKeywordName();
+        const size_t handle = getHandle( keyword );
+        if (m_byHandle[ handle ])
+            throw std::logic_error("The property " + keyword + " already exists");
 
-        if (!hasKeyword(kw))
-            addAutoGeneratedKeyword_(kw);
+        m_autoGeneratedProperties.insert( keyword );
+        insertProperty( handle, std::move( property ) );
+    }
 
-        return m_properties.at( kw );
+    template< typename T >
+    GridProperty<T>& GridProperties<T>::getKeyword(const std::string& keyword) {
+        return getOrGenerate( getHandle( keyword ) );
     }
 
 
@@ -566,20 +821,22 @@ namespace Opm {
     */
     template< typename T >
     bool GridProperties<T>::addAutoGeneratedKeyword_(const std::string& keywordName) const {
-        if (!supportsKeyword( keywordName ))
-            throw std::invalid_argument("The keyword: " + keywordName + " is not supported in this container");
-
-        if (m_properties.count( keywordName ) > 0)
+        const size_t handle = getHandle( keywordName );
+        if (m_byHandle[ handle ])
             return false; // property already exists (if it is auto generated or not doesn't matter)
-        else {
-            m_autoGeneratedProperties.insert(keywordName);
 
-            if (isFipxxx<T>(keywordName))
-                m_supportedKeywords.emplace(keywordName, SupportedKeywordInfo( keywordName , 1, "1" ));
+        getOrGenerate( handle );
+        return true;
+    }
 
-            insertKeyword( m_supportedKeywords.at( keywordName ) );
-            return true;
+    template< typename T >
+    GridProperty<T>& GridProperties<T>::getOrGenerate(size_t handle) const {
+        if (!m_byHandle.at( handle )) {
+            m_autoGeneratedProperties.insert( m_supportedKeywords[ handle ].getKeywordName() );
+            insertKeyword( handle );
         }
+
+        return *m_byHandle[ handle ];
     }
 
     template< typename T >
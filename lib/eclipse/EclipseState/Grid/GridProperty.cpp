@@ -17,10 +17,14 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
@@ -30,12 +34,15 @@
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperties.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/RtempvdTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
     template< typename T >
     static std::function< std::vector< T >( size_t ) > constant( T val ) {
-        return [=]( size_t size ) { return std::vector< T >( size, val ); };
+        return [=]( size_t size ) { return GridMemory::filled( size, val ); };
     }
 
     template< typename T >
@@ -52,7 +59,8 @@ namespace Opm {
         m_keywordName( name ),
         m_initializer( init ),
         m_postProcessor( post ),
-        m_dimensionString( dimString )
+        m_dimensionString( dimString ),
+        m_hasPostProcessor( true )
     {}
 
     template< typename T >
@@ -74,7 +82,9 @@ namespace Opm {
         m_keywordName( name ),
         m_initializer( constant( defaultValue ) ),
         m_postProcessor( noop< T >() ),
-        m_dimensionString( dimString )
+        m_dimensionString( dimString ),
+        m_defaultValue( defaultValue ),
+        m_constantDefault( true )
     {}
 
     template< typename T >
@@ -86,9 +96,35 @@ namespace Opm {
         m_keywordName( name ),
         m_initializer( constant( defaultValue ) ),
         m_postProcessor( post ),
-        m_dimensionString( dimString )
+        m_dimensionString( dimString ),
+        m_defaultValue( defaultValue ),
+        m_constantDefault( true ),
+        m_hasPostProcessor( true )
     {}
 
+    template< typename T >
+    GridPropertySupportedKeywordInfo< T >::GridPropertySupportedKeywordInfo(
+            const std::string& name,
+            std::function< std::vector< T >( size_t ) > init,
+            std::vector< std::string > dependencies,
+            const std::string& dimString ) :
+        GridPropertySupportedKeywordInfo( name, init, dimString )
+    {
+        this->m_dependencies = std::move( dependencies );
+    }
+
+    template< typename T >
+    GridPropertySupportedKeywordInfo< T >::GridPropertySupportedKeywordInfo(
+            const std::string& name,
+            const T defaultValue,
+            std::function< void( std::vector< T >& ) > post,
+            std::vector< std::string > dependencies,
+            const std::string& dimString ) :
+        GridPropertySupportedKeywordInfo( name, defaultValue, post, dimString )
+    {
+        this->m_dependencies = std::move( dependencies );
+    }
+
     template< typename T >
     const std::string& GridPropertySupportedKeywordInfo< T >::getKeywordName() const {
         return this->m_keywordName;
@@ -109,19 +145,50 @@ namespace Opm {
         return this->m_postProcessor;
     }
 
+    template< typename T >
+    bool GridPropertySupportedKeywordInfo< T >::hasPostProcessor() const {
+        return this->m_hasPostProcessor;
+    }
+
+    template< typename T >
+    const std::vector< std::string >& GridPropertySupportedKeywordInfo< T >::dependencies() const {
+        return this->m_dependencies;
+    }
+
+    template< typename T >
+    T GridPropertySupportedKeywordInfo< T >::defaultValue() const {
+        return this->m_defaultValue;
+    }
+
+    template< typename T >
+    bool GridPropertySupportedKeywordInfo< T >::hasConstantDefault() const {
+        return this->m_constantDefault;
+    }
+
+    /* The closures held by the std::function members are not counted. */
+    template< typename T >
+    size_t GridPropertySupportedKeywordInfo< T >::memoryUsage() const {
+        return memory::heap( this->m_keywordName ) + memory::heap( this->m_dimensionString )
+             + memory::heap( this->m_dependencies );
+    }
+
     template< typename T >
     GridProperty< T >::GridProperty( size_t nx, size_t ny, size_t nz, const SupportedKeywordInfo& kwInfo ) :
         m_nx( nx ),
         m_ny( ny ),
         m_nz( nz ),
         m_kwInfo( kwInfo ),
-        m_data( kwInfo.initializer()( nx * ny * nz ) ),
+        m_sparse( kwInfo.hasConstantDefault() ),
+        m_constant( kwInfo.defaultValue() ),
         m_hasRunPostProcessor( false )
-    {}
+    {
+        if( !this->m_sparse )
+            this->m_data = kwInfo.initializer()( nx * ny * nz );
+    }
 
     template< typename T >
     size_t GridProperty< T >::getCartesianSize() const {
-        return m_data.size();
+        return m_nx * m_ny * m_nz;
     }
 
     template< typename T >
@@ -141,7 +208,17 @@ namespace Opm {
 
     template< typename T >
     T GridProperty< T >::iget( size_t index ) const {
-        return this->m_data.at( index );
+        if( this->m_sparse ) {
+            if( index >= getCartesianSize() )
+                throw std::out_of_range("Index out of range in property " + getKeywordName());
+            return this->value( index );
+        }
+
+        if( !this->m_globalMap )
+            return this->m_data.at( index );
+
+        const int active = this->m_globalMap->at( index );
+        return active < 0 ? this->m_kwInfo.defaultValue() : this->m_data[ active ];
     }
 
     template< typename T >
@@ -152,6 +229,14 @@ namespace Opm {
 
     template< typename T >
     void GridProperty< T >::iset(size_t index, T value) {
+        if( this->m_sparse ) {
+            if( index >= getCartesianSize() )
+                throw std::out_of_range("Index out of range in property " + getKeywordName());
+            this->setOverride( index, value );
+            return;
+        }
+
+        this->modified();
         this->m_data.at( index ) = value;
     }
 
@@ -163,79 +248,230 @@ namespace Opm {
 
     template< typename T >
     const std::vector< T >& GridProperty< T >::getData() const {
-        return m_data;
+        return this->full();
     }
 
 
     template< typename T >
     std::vector< T >& GridProperty< T >::getData() {
+        this->modified();
         return m_data;
     }
 
+    /*
+      Call f( begin, end ) for ranges of consecutive global indices which
+      together cover the cells of the box once. The ranges are processed
+      in parallel: a box of whole layers is one run, which is cut in
+      chunks, otherwise the layers of the box are split over the
+      threads.
+    */
+    template< typename F >
+    static void forEachBoxRange( const Box& box, size_t nx, size_t ny, F f ) {
+        if( box.getDim( 0 ) == nx && box.getDim( 1 ) == ny ) {
+            box.forEachRun( [&]( size_t start, size_t, size_t length ) {
+                GridKernels::forEachChunk( length, [&]( size_t begin, size_t end ) {
+                    f( start + begin, start + end );
+                });
+            });
+            return;
+        }
+
+        const long long k0 = box.getOffset( 2 );
+        const long long k1 = k0 + box.getDim( 2 );
+        const bool parallel = box.size() >= 2 * GridKernels::chunk_size;
+        const int nthreads = GridKernels::threads();
+        (void) parallel;
+        (void) nthreads;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads) if(parallel)
+#endif
+        for( long long k = k0; k < k1; k++ ) {
+            box.forEachRunInLayer( k, [&]( size_t start, size_t, size_t length ) {
+                f( start, start + length );
+            });
+        }
+    }
+
+    /* Call f( g ) for the global index g of each cell in the box. */
+    template< typename F >
+    static void forEachBoxCell( const Box& box, F f ) {
+        box.forEachRun( [&]( size_t start, size_t, size_t length ) {
+            for (size_t g = start; g < start + length; g++)
+                f( g );
+        });
+    }
+
     template< typename T >
     void GridProperty< T >::multiplyWith( const GridProperty< T >& other ) {
         if ((m_nx == other.m_nx) && (m_ny == other.m_ny) && (m_nz == other.m_nz)) {
-            for (size_t g=0; g < m_data.size(); g++)
-                m_data[g] *= other.m_data[g];
+            /* a sparse multiplier like MULTX: only the overrides differ from 1 */
+            if (other.m_sparse && other.m_constant == T( 1 ) && &other != this) {
+                for (const auto& pair : other.m_overrides)
+                    this->multiplyValueAtIndex( pair.first, pair.second );
+                return;
+            }
+
+            this->modified();
+            T* data = m_data.data();
+            const T* factor = other.full().data();
+            GridKernels::forEachChunk( m_data.size(), [=]( size_t begin, size_t end ) {
+                for (size_t g = begin; g < end; g++)
+                    data[g] *= factor[g];
+            });
         } else
             throw std::invalid_argument("Size mismatch between properties in mulitplyWith.");
     }
 
     template< typename T >
     void GridProperty< T >::multiplyValueAtIndex(size_t index, T factor) {
+        if( this->m_sparse ) {
+            if( index >= getCartesianSize() )
+                throw std::out_of_range("Index out of range in property " + getKeywordName());
+            this->setOverride( index, this->value( index ) * factor );
+            return;
+        }
+
+        this->modified();
         m_data[index] *= factor;
     }
 
-
-
     template< typename T >
     void GridProperty< T >::maskedSet( T value, const std::vector< bool >& mask ) {
-        for (size_t g = 0; g < getCartesianSize(); g++) {
-            if (mask[g])
-                m_data[g] = value;
-        }
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (mask[g])
+                    data[g] = value;
+        });
     }
 
     template< typename T >
     void GridProperty< T >::maskedMultiply( T value, const std::vector<bool>& mask ) {
-        for (size_t g = 0; g < getCartesianSize(); g++) {
-            if (mask[g])
-                m_data[g] *= value;
-        }
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (mask[g])
+                    data[g] *= value;
+        });
     }
 
-
     template< typename T >
     void GridProperty< T >::maskedAdd( T value, const std::vector<bool>& mask ) {
-        for (size_t g = 0; g < getCartesianSize(); g++) {
-            if (mask[g])
-                m_data[g] += value;
-        }
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (mask[g])
+                    data[g] += value;
+        });
     }
 
     template< typename T >
     void GridProperty< T >::maskedCopy( const GridProperty< T >& other, const std::vector< bool >& mask) {
-        for (size_t g = 0; g < getCartesianSize(); g++) {
-            if (mask[g])
-                m_data[g] = other.m_data[g];
-        }
+        this->modified();
+        T* data = m_data.data();
+        const T* src = other.full().data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (mask[g])
+                    data[g] = src[g];
+        });
     }
 
     template< typename T >
     void GridProperty< T >::initMask( T value, std::vector< bool >& mask ) const {
         mask.resize(getCartesianSize());
-        for (size_t g = 0; g < getCartesianSize(); g++) {
-            if (m_data[g] == value)
-                mask[g] = true;
-            else
-                mask[g] = false;
-        }
+        const T* data = this->full().data();
+        /* the chunks never share a word of the mask */
+        GridKernels::forEachChunk( getCartesianSize(), [&]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                mask[g] = (data[g] == value);
+        });
+    }
+
+    template< typename T >
+    void GridProperty< T >::maskedSet( T value, const ByteMask& mask ) {
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            GridKernels::forEachSet( mask.data(), begin, end, [&]( size_t g ) { data[g] = value; } );
+        });
+    }
+
+    template< typename T >
+    void GridProperty< T >::maskedMultiply( T value, const ByteMask& mask ) {
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            GridKernels::forEachSet( mask.data(), begin, end, [&]( size_t g ) { data[g] *= value; } );
+        });
+    }
+
+    template< typename T >
+    void GridProperty< T >::maskedAdd( T value, const ByteMask& mask ) {
+        this->modified();
+        T* data = m_data.data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            GridKernels::forEachSet( mask.data(), begin, end, [&]( size_t g ) { data[g] += value; } );
+        });
+    }
+
+    template< typename T >
+    void GridProperty< T >::maskedCopy( const GridProperty< T >& other, const ByteMask& mask ) {
+        this->modified();
+        T* data = m_data.data();
+        const T* src = other.full().data();
+        GridKernels::forEachChunk( m_data.size(), [&]( size_t begin, size_t end ) {
+            GridKernels::forEachSet( mask.data(), begin, end, [&]( size_t g ) { data[g] = src[g]; } );
+        });
+    }
+
+    template< typename T >
+    void GridProperty< T >::initMask( T value, ByteMask& mask ) const {
+        GridMemory::resize( mask, getCartesianSize() );
+        const T* data = this->full().data();
+        unsigned char* bytes = mask.data();
+        GridKernels::forEachChunk( getCartesianSize(), [=]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                bytes[g] = (data[g] == value);
+        });
+    }
+
+    /*
+      The values of a deck item as T, in SI units for double. The values
+      are only valid where the item is not defaulted.
+    */
+    template< typename T >
+    static const std::vector< T >& deckItemData( const DeckItem& deckItem );
+
+    template<>
+    const std::vector< int >& deckItemData< int >( const DeckItem& deckItem ) {
+        return deckItem.getData< int >();
+    }
+
+    template<>
+    const std::vector< double >& deckItemData< double >( const DeckItem& deckItem ) {
+        return deckItem.getSIDoubleData();
     }
 
     template< typename T >
     void GridProperty< T >::loadFromDeckKeyword( const DeckKeyword& deckKeyword ) {
+        this->modified();
         const auto& deckItem = getDeckItem(deckKeyword);
         const auto size = deckItem.size();
+
+        if (!deckItem.hasDefaultedValues()) {
+            const T* values = deckItemData< T >( deckItem ).data();
+            T* data = m_data.data();
+            GridKernels::forEachChunk( size, [=]( size_t begin, size_t end ) {
+                std::copy( values + begin, values + end, data + begin );
+            });
+            return;
+        }
+
         for (size_t dataPointIdx = 0; dataPointIdx < size; ++dataPointIdx) {
             if (!deckItem.defaultApplied(dataPointIdx))
                 setDataPoint(dataPointIdx, dataPointIdx, deckItem);
@@ -248,18 +484,36 @@ namespace Opm {
             loadFromDeckKeyword( deckKeyword );
         else {
             const auto& deckItem = getDeckItem(deckKeyword);
-            const std::vector<size_t>& indexList = inputBox.getIndexList();
-            if (indexList.size() == deckItem.size()) {
-                for (size_t sourceIdx = 0; sourceIdx < indexList.size(); sourceIdx++) {
-                    size_t targetIdx = indexList[sourceIdx];
-                    if (sourceIdx < deckItem.size()
-                        && !deckItem.defaultApplied(sourceIdx))
-                        {
-                            setDataPoint(sourceIdx, targetIdx, deckItem);
+            if (inputBox.size() == deckItem.size()) {
+                if (this->keepSparse( inputBox.size() )) {
+                    const auto& values = deckItemData< T >( deckItem );
+                    const bool defaulted = deckItem.hasDefaultedValues();
+                    inputBox.forEachRun( [&]( size_t start, size_t offset, size_t length ) {
+                        for (size_t i = 0; i < length; i++) {
+                            if (!defaulted || !deckItem.defaultApplied(offset + i))
+                                this->setOverride( start + i, values[offset + i] );
                         }
+                    });
+                    return;
                 }
+
+                this->modified();
+                if (!deckItem.hasDefaultedValues()) {
+                    const T* values = deckItemData< T >( deckItem ).data();
+                    inputBox.forEachRun( [&]( size_t start, size_t offset, size_t length ) {
+                        std::copy( values + offset, values + offset + length, m_data.begin() + start );
+                    });
+                    return;
+                }
+
+                inputBox.forEachRun( [&]( size_t start, size_t offset, size_t length ) {
+                    for (size_t i = 0; i < length; i++) {
+                        if (!deckItem.defaultApplied(offset + i))
+                            setDataPoint(offset + i, start + i, deckItem);
+                    }
+                });
             } else {
-                std::string boxSize = std::to_string(static_cast<long long>(indexList.size()));
+                std::string boxSize = std::to_string(static_cast<long long>(inputBox.size()));
                 std::string keywordSize = std::to_string(static_cast<long long>(deckItem.size()));
 
                 throw std::invalid_argument("Size mismatch: Box:" + boxSize + "  DeckKeyword:" + keywordSize);
@@ -269,57 +523,84 @@ namespace Opm {
 
     template< typename T >
     void GridProperty< T >::copyFrom( const GridProperty< T >& src, const Box& inputBox ) {
-        if (inputBox.isGlobal()) {
-            for (size_t i = 0; i < src.getCartesianSize(); ++i)
-                m_data[i] = src.m_data[i];
-        } else {
-            const std::vector<size_t>& indexList = inputBox.getIndexList();
-            for (size_t i = 0; i < indexList.size(); i++) {
-                size_t targetIndex = indexList[i];
-                m_data[targetIndex] = src.m_data[targetIndex];
-            }
+        if (this->keepSparse( inputBox.size() )) {
+            forEachBoxCell( inputBox, [&]( size_t g ) { this->setOverride( g, src.value( g ) ); } );
+            return;
         }
+
+        this->modified();
+        T* data = m_data.data();
+        const T* source = src.full().data();
+        forEachBoxRange( inputBox, m_nx, m_ny, [=]( size_t begin, size_t end ) {
+            std::copy( source + begin, source + end, data + begin );
+        });
     }
 
     template< typename T >
     void GridProperty< T >::scale( T scaleFactor, const Box& inputBox ) {
-        if (inputBox.isGlobal()) {
-            for (size_t i = 0; i < m_data.size(); ++i)
-                m_data[i] *= scaleFactor;
-        } else {
-            const std::vector<size_t>& indexList = inputBox.getIndexList();
-            for (size_t i = 0; i < indexList.size(); i++) {
-                size_t targetIndex = indexList[i];
-                m_data[targetIndex] *= scaleFactor;
-            }
+        if (this->m_sparse && inputBox.size() == getCartesianSize()) {
+            this->invalidate();
+            this->m_constant *= scaleFactor;
+            for (auto& pair : this->m_overrides)
+                pair.second *= scaleFactor;
+            return;
         }
+
+        if (this->keepSparse( inputBox.size() )) {
+            forEachBoxCell( inputBox, [&]( size_t g ) { this->setOverride( g, this->value( g ) * scaleFactor ); } );
+            return;
+        }
+
+        this->modified();
+        T* data = m_data.data();
+        forEachBoxRange( inputBox, m_nx, m_ny, [=]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                data[g] *= scaleFactor;
+        });
     }
 
     template< typename T >
     void GridProperty< T >::add( T shiftValue, const Box& inputBox ) {
-        if (inputBox.isGlobal()) {
-            for (size_t i = 0; i < m_data.size(); ++i)
-                m_data[i] += shiftValue;
-        } else {
-            const std::vector<size_t>& indexList = inputBox.getIndexList();
-            for (size_t i = 0; i < indexList.size(); i++) {
-                size_t targetIndex = indexList[i];
-                m_data[targetIndex] += shiftValue;
-            }
+        if (this->m_sparse && inputBox.size() == getCartesianSize()) {
+            this->invalidate();
+            this->m_constant += shiftValue;
+            for (auto& pair : this->m_overrides)
+                pair.second += shiftValue;
+            return;
+        }
+
+        if (this->keepSparse( inputBox.size() )) {
+            forEachBoxCell( inputBox, [&]( size_t g ) { this->setOverride( g, this->value( g ) + shiftValue ); } );
+            return;
         }
+
+        this->modified();
+        T* data = m_data.data();
+        forEachBoxRange( inputBox, m_nx, m_ny, [=]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                data[g] += shiftValue;
+        });
     }
 
     template< typename T >
     void GridProperty< T >::setScalar( T value, const Box& inputBox ) {
-        if (inputBox.isGlobal()) {
-            std::fill(m_data.begin(), m_data.end(), value);
-        } else {
-            const std::vector<size_t>& indexList = inputBox.getIndexList();
-            for (size_t i = 0; i < indexList.size(); i++) {
-                size_t targetIndex = indexList[i];
-                m_data[targetIndex] = value;
-            }
+        if (this->m_sparse && inputBox.size() == getCartesianSize()) {
+            this->invalidate();
+            this->m_constant = value;
+            std::unordered_map< size_t, T >().swap( this->m_overrides );
+            return;
+        }
+
+        if (this->keepSparse( inputBox.size() )) {
+            forEachBoxCell( inputBox, [&]( size_t g ) { this->setOverride( g, value ); } );
+            return;
         }
+
+        this->modified();
+        T* data = m_data.data();
+        forEachBoxRange( inputBox, m_nx, m_ny, [=]( size_t begin, size_t end ) {
+            std::fill( data + begin, data + end, value );
+        });
     }
 
     template< typename T >
@@ -333,19 +614,215 @@ namespace Opm {
         return m_kwInfo;
     }
 
+    template< typename T >
+    size_t GridProperty< T >::memoryUsage() const {
+        return memory::heap( this->m_data ) + this->m_kwInfo.memoryUsage()
+             + memory::heap( this->m_overrides )
+             + memory::heap( std::atomic_load( &this->m_regionCells ) )
+             + memory::heap( std::atomic_load( &this->m_full ) );
+    }
+
+    template< typename T >
+    void GridProperty< T >::modified() {
+        this->expand();
+        this->invalidate();
+    }
+
+    template< typename T >
+    void GridProperty< T >::invalidate() {
+        if( this->m_regionCells )
+            std::atomic_store( &this->m_regionCells, std::shared_ptr< const RegionCells >() );
+        if( this->m_full )
+            std::atomic_store( &this->m_full, std::shared_ptr< const std::vector< T > >() );
+    }
+
+    /*
+      The override is dropped when the value is bitwise equal to the
+      constant; a -0.0 or NaN override is kept.
+    */
+    template< typename T >
+    void GridProperty< T >::setOverride( size_t index, T value ) {
+        this->invalidate();
+        if( !this->m_sparse ) {
+            this->m_data[ index ] = value;
+            return;
+        }
+
+        if( std::memcmp( &value, &this->m_constant, sizeof( T ) ) == 0 )
+            this->m_overrides.erase( index );
+        else
+            this->m_overrides[ index ] = value;
+
+        if( this->m_overrides.size() > getCartesianSize() / 16 )
+            this->expand();
+    }
+
+    /* Can a sparse property take writes to this many cells and stay sparse? */
+    template< typename T >
+    bool GridProperty< T >::keepSparse( size_t writes ) const {
+        return this->m_sparse && this->m_overrides.size() + writes <= getCartesianSize() / 16;
+    }
+
+    template< typename T >
+    bool GridProperty< T >::isSparse() const {
+        return this->m_sparse;
+    }
+
+    template< typename T >
+    void GridProperty< T >::compress( std::shared_ptr< const std::vector< int > > globalMap ) {
+        if( this->m_globalMap == globalMap ) return;
+        if( globalMap->size() != getCartesianSize() )
+            throw std::invalid_argument("Size mismatch between the global map and property " + getKeywordName());
+        if( this->m_sparse ) return;
+
+        const size_t active = std::count_if( globalMap->begin(), globalMap->end(),
+                                             []( int a ) { return a >= 0; } );
+
+        this->modified();
+        std::vector< T > compressed;
+        GridMemory::resize( compressed, active );
+        const int* map = globalMap->data();
+        const T* data = m_data.data();
+        T* dst = compressed.data();
+        GridKernels::forEachChunk( getCartesianSize(), [=]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (map[g] >= 0)
+                    dst[ map[g] ] = data[g];
+        });
+
+        this->m_data.swap( compressed );
+        this->m_globalMap = std::move( globalMap );
+    }
+
+    /* The full cartesian array of a compressed or sparse property. */
+    template< typename T >
+    std::vector< T > GridProperty< T >::expanded() const {
+        if( this->m_sparse ) {
+            auto full = GridMemory::filled( getCartesianSize(), this->m_constant );
+            for( const auto& pair : this->m_overrides )
+                full[ pair.first ] = pair.second;
+
+            return full;
+        }
+
+        auto full = GridMemory::filled( getCartesianSize(), this->m_kwInfo.defaultValue() );
+        const int* map = this->m_globalMap->data();
+        const T* data = m_data.data();
+        T* dst = full.data();
+        GridKernels::forEachChunk( getCartesianSize(), [=]( size_t begin, size_t end ) {
+            for (size_t g = begin; g < end; g++)
+                if (map[g] >= 0)
+                    dst[g] = data[ map[g] ];
+        });
+
+        return full;
+    }
+
+    template< typename T >
+    void GridProperty< T >::expand() {
+        if( !this->m_sparse && !this->m_globalMap ) return;
+
+        auto full = this->expanded();
+        this->m_data.swap( full );
+        std::unordered_map< size_t, T >().swap( this->m_overrides );
+        this->m_sparse = false;
+        this->m_globalMap.reset();
+        this->invalidate();
+    }
+
+    /*
+      The full array for const readers; the storage of the property is
+      not changed. If another thread built the copy first, its copy is
+      returned.
+    */
+    template< typename T >
+    const std::vector< T >& GridProperty< T >::full() const {
+        if( !this->m_sparse && !this->m_globalMap )
+            return this->m_data;
+
+        auto view = std::atomic_load( &this->m_full );
+        if( !view ) {
+            auto built = std::make_shared< const std::vector< T > >( this->expanded() );
+            if( std::atomic_compare_exchange_strong( &this->m_full, &view, built ) )
+                view = built;
+        }
+
+        return *view;
+    }
+
+    template< typename T >
+    bool GridProperty< T >::isCompressed() const {
+        return bool( this->m_globalMap );
+    }
+
+    template< typename T >
+    const std::vector< T >& GridProperty< T >::getActiveData() const {
+        if( !this->m_globalMap )
+            throw std::logic_error("Property " + getKeywordName() + " is not compressed");
+
+        return this->m_data;
+    }
+
+    template< typename T >
+    T GridProperty< T >::value( size_t index ) const {
+        if( this->m_sparse ) {
+            if( this->m_overrides.empty() ) return this->m_constant;
+
+            const auto iter = this->m_overrides.find( index );
+            return iter == this->m_overrides.end() ? this->m_constant : iter->second;
+        }
+
+        if( !this->m_globalMap ) return this->m_data[ index ];
+
+        const int active = (*this->m_globalMap)[ index ];
+        return active < 0 ? this->m_kwInfo.defaultValue() : this->m_data[ active ];
+    }
+
     template< typename T >
     void GridProperty< T >::runPostProcessor() {
         if( this->m_hasRunPostProcessor ) return;
         this->m_hasRunPostProcessor = true;
+        /* without a post processor a sparse property stays sparse */
+        if( !this->m_kwInfo.hasPostProcessor() ) return;
+
+        this->modified();
         this->m_kwInfo.postProcessor()( m_data );
     }
 
     template< typename T >
     void GridProperty< T >::checkLimits( T min, T max ) const {
-        for (size_t g=0; g < m_data.size(); g++) {
-            T value = m_data[g];
-            if ((value < min) || (value > max))
-                throw std::invalid_argument("Property element " + std::to_string( value) + " in " + getKeywordName() + " outside valid limits: [" + std::to_string(min) + ", " + std::to_string(max) + "]");
+        if (this->m_sparse) {
+            const auto outside = [=]( T value ) { return (value < min) || (value > max); };
+            bool fail = m_overrides.size() < getCartesianSize() && outside( m_constant );
+            for (const auto& pair : m_overrides)
+                fail = fail || outside( pair.second );
+
+            if (!fail) return;
+
+            size_t g = 0;
+            while (!outside( this->value( g ) ))
+                g++;
+
+            throw std::invalid_argument("Property element " + std::to_string( this->value( g )) + " in " + getKeywordName() + " outside valid limits: [" + std::to_string(min) + ", " + std::to_string(max) + "]");
+        }
+
+        /* the first element outside the limits is reported */
+        const T* data = m_data.data();
+        const size_t g = GridKernels::findFirst( m_data.size(), [=]( size_t begin, size_t end ) {
+            for (size_t i = begin; i < end; i++)
+                if ((data[i] < min) || (data[i] > max))
+                    return i;
+            return end;
+        });
+
+        /* the inactive cells of a compressed property have the default value */
+        const T inactive = m_kwInfo.defaultValue();
+        const bool inactiveOutside = m_globalMap && m_data.size() < getCartesianSize()
+                                  && ((inactive < min) || (inactive > max));
+
+        if (g < m_data.size() || inactiveOutside) {
+            T value = g < m_data.size() ? m_data[g] : inactive;
+            throw std::invalid_argument("Property element " + std::to_string( value) + " in " + getKeywordName() + " outside valid limits: [" + std::to_string(min) + ", " + std::to_string(max) + "]");
         }
     }
 
@@ -362,14 +839,27 @@ namespace Opm {
 
         const auto& deckItem = deckKeyword.getRecord(0).getItem(0);
 
-        if (deckItem.size() > m_data.size())
+        if (deckItem.size() > getCartesianSize())
             throw std::invalid_argument("Size mismatch when setting data for:" + getKeywordName()
                                         + " keyword size: " + std::to_string( deckItem.size() )
-                                        + " input size: " + std::to_string( m_data.size()) );
+                                        + " input size: " + std::to_string( getCartesianSize()) );
 
         return deckItem;
     }
 
+template<>
+const RegionCells& GridProperty<int>::regionCells() const {
+    auto cells = std::atomic_load( &this->m_regionCells );
+    if( !cells ) {
+        /* if another thread got there first, its index is returned */
+        auto built = std::make_shared< const RegionCells >( this->full() );
+        if( std::atomic_compare_exchange_strong( &this->m_regionCells, &cells, built ) )
+            cells = built;
+    }
+
+    return *cells;
+}
+
 template<>
 void GridProperty<int>::setDataPoint(size_t sourceIdx, size_t targetIdx, const DeckItem& deckItem) {
     m_data[targetIdx] = deckItem.get< int >(sourceIdx);
@@ -387,20 +877,29 @@ bool GridProperty<int>::containsNaN( ) const {
 
 template<>
 bool GridProperty<double>::containsNaN( ) const {
-    bool return_value = false;
-    size_t size = m_data.size();
-    size_t index = 0;
-    while (true) {
-        if (std::isnan(m_data[index])) {
-            return_value = true;
-            break;
-        }
+    if (m_sparse) {
+        if (m_overrides.size() < getCartesianSize() && std::isnan( m_constant ))
+            return true;
+
+        for (const auto& pair : m_overrides)
+            if (std::isnan( pair.second ))
+                return true;
 
-        index++;
-        if (index == size)
-            break;
+        return false;
     }
-    return return_value;
+
+    const double* data = m_data.data();
+    const size_t index = GridKernels::findFirst( m_data.size(), [=]( size_t begin, size_t end ) {
+        for (size_t i = begin; i < end; i++)
+            if (std::isnan(data[i]))
+                return i;
+        return end;
+    });
+
+    const bool inactiveNaN = m_globalMap && m_data.size() < getCartesianSize()
+                          && std::isnan( m_kwInfo.defaultValue() );
+
+    return index < m_data.size() || inactiveNaN;
 }
 
 template<>
@@ -416,10 +915,24 @@ const std::string& GridProperty<double>::getDimensionString() const {
 
 template<typename T>
 std::vector<T> GridProperty<T>::compressedCopy(const EclipseGrid& grid) const {
+    if (m_sparse) {
+        const auto& globalMap = grid.getGlobalMap();
+        auto active = GridMemory::filled( grid.getNumActive(), m_constant );
+        for (const auto& pair : m_overrides)
+            if (globalMap[ pair.first ] >= 0)
+                active[ globalMap[ pair.first ] ] = pair.second;
+
+        return active;
+    }
+
+    if (m_globalMap && *m_globalMap == grid.getGlobalMap())
+        return GridKernels::copy( m_data );
+
+    const auto& data = this->full();
     if (grid.allActive())
-        return m_data;
+        return GridKernels::copy( data );
     else {
-        return grid.compressedVector( m_data );
+        return grid.compressedVector( data );
     }
 }
 
@@ -430,7 +943,7 @@ std::vector<size_t> GridProperty<T>::cellsEqual(T value, const std::vector<int>&
     std::vector<size_t> cells;
     for (size_t active_index = 0; active_index < activeMap.size(); active_index++) {
         size_t global_index = activeMap[ active_index ];
-        if (m_data[global_index] == value)
+        if (this->value( global_index ) == value)
             cells.push_back( active_index );
     }
     return cells;
@@ -440,8 +953,8 @@ std::vector<size_t> GridProperty<T>::cellsEqual(T value, const std::vector<int>&
 template<typename T>
 std::vector<size_t> GridProperty<T>::indexEqual(T value) const {
     std::vector<size_t> index_list;
-    for (size_t index = 0; index < m_data.size(); index++) {
-        if (m_data[index] == value)
+    for (size_t index = 0; index < getCartesianSize(); index++) {
+        if (this->value( index ) == value)
             index_list.push_back( index );
     }
     return index_list;
@@ -465,12 +978,13 @@ std::vector< double > temperature_lookup( size_t size,
         const std::vector< int >& eqlNum = ig_props->getKeyword("EQLNUM").getData();
 
         const auto& rtempvdTables = tables->getRtempvdTables();
+        const auto& cellDepths = grid->getCellDepths();
         std::vector< double > values( size, 0 );
 
         for (size_t cellIdx = 0; cellIdx < eqlNum.size(); ++ cellIdx) {
             int cellEquilRegionIdx = eqlNum[cellIdx] - 1; // EQLNUM contains fortran-style indices!
             const RtempvdTable& rtempvdTable = rtempvdTables.getTable<RtempvdTable>(cellEquilRegionIdx);
-            double cellDepth = std::get<2>(grid->getCellCenter(cellIdx));
+            double cellDepth = cellDepths[cellIdx];
             values[cellIdx] = rtempvdTable.evaluate("Temperature", cellDepth);
         }
 
@@ -0,0 +1,110 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include <opm/parser/eclipse/EclipseState/Grid/GridPropertyEdits.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+
+namespace Opm {
+
+    template< typename T >
+    void GridPropertyEdits< T >::assign( std::vector< T >& target, T value, const Box& box ) {
+        this->m_edits.push_back( { Kind::ASSIGN, target.data(), nullptr, value, box } );
+    }
+
+    template< typename T >
+    void GridPropertyEdits< T >::add( std::vector< T >& target, T value, const Box& box ) {
+        this->m_edits.push_back( { Kind::ADD, target.data(), nullptr, value, box } );
+    }
+
+    template< typename T >
+    void GridPropertyEdits< T >::multiply( std::vector< T >& target, T value, const Box& box ) {
+        this->m_edits.push_back( { Kind::MULTIPLY, target.data(), nullptr, value, box } );
+    }
+
+    template< typename T >
+    void GridPropertyEdits< T >::copy( std::vector< T >& target, const std::vector< T >& src, const Box& box ) {
+        this->m_edits.push_back( { Kind::COPY, target.data(), src.data(), T(), box } );
+    }
+
+    template< typename T >
+    bool GridPropertyEdits< T >::empty() const {
+        return this->m_edits.empty();
+    }
+
+    template< typename T >
+    size_t GridPropertyEdits< T >::size() const {
+        return this->m_edits.size();
+    }
+
+    template< typename T >
+    void GridPropertyEdits< T >::applyRun( const Edit& edit, size_t start, size_t length ) const {
+        T* target = edit.target + start;
+
+        switch( edit.kind ) {
+            case Kind::ASSIGN:
+                std::fill( target, target + length, edit.value );
+                break;
+
+            case Kind::ADD:
+                for( size_t i = 0; i < length; i++ )
+                    target[i] += edit.value;
+                break;
+
+            case Kind::MULTIPLY:
+                for( size_t i = 0; i < length; i++ )
+                    target[i] *= edit.value;
+                break;
+
+            case Kind::COPY:
+                std::copy( edit.src + start, edit.src + start + length, target );
+                break;
+        }
+    }
+
+    template< typename T >
+    void GridPropertyEdits< T >::apply() {
+        if( this->m_edits.empty() ) return;
+
+        size_t k0 = this->m_edits.front().box.getOffset( 2 );
+        size_t k1 = k0;
+        for( const auto& edit : this->m_edits ) {
+            k0 = std::min( k0, edit.box.getOffset( 2 ) );
+            k1 = std::max( k1, edit.box.getOffset( 2 ) + edit.box.getDim( 2 ) );
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(GridKernels::threads())
+#endif
+        for( size_t k = k0; k < k1; k++ ) {
+            for( const auto& edit : this->m_edits ) {
+                edit.box.forEachRunInLayer( k, [&]( size_t start, size_t, size_t length ) {
+                    this->applyRun( edit, start, length );
+                });
+            }
+        }
+
+        this->m_edits.clear();
+    }
+
+}
+
+template class Opm::GridPropertyEdits< int >;
+template class Opm::GridPropertyEdits< double >;
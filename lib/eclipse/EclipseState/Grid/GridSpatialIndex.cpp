@@ -0,0 +1,442 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <opm/parser/eclipse/EclipseState/Grid/GridDims.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridSpatialIndex.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
+namespace Opm {
+
+namespace {
+
+    /* The six tetrahedra around the 0-7 diagonal, as in GridGeometry. */
+    const int tetrahedra[6][4] = { { 0, 1, 3, 7 }, { 0, 3, 2, 7 }, { 0, 2, 6, 7 },
+                                   { 0, 6, 4, 7 }, { 0, 4, 5, 7 }, { 0, 5, 1, 7 } };
+
+    typedef std::array< double, 3 > Point;
+
+    inline Point sub( const Point& a, const Point& b ) {
+        return {{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }};
+    }
+
+    inline double dot( const Point& a, const Point& b ) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    inline Point cross( const Point& a, const Point& b ) {
+        return {{ a[1] * b[2] - a[2] * b[1],
+                  a[2] * b[0] - a[0] * b[2],
+                  a[0] * b[1] - a[1] * b[0] }};
+    }
+
+    /* Six times the signed volume of the tetrahedron a, b, c, d. */
+    inline double orient( const Point& a, const Point& b, const Point& c, const Point& d ) {
+        return dot( sub( b, a ), cross( sub( c, a ), sub( d, a ) ) );
+    }
+
+    inline bool tetContains( const Point& a, const Point& b, const Point& c, const Point& d, const Point& p ) {
+        const double volume = orient( a, b, c, d );
+        if( volume == 0 ) return false;
+
+        return orient( p, b, c, d ) * volume >= 0
+            && orient( a, p, c, d ) * volume >= 0
+            && orient( a, b, p, d ) * volume >= 0
+            && orient( a, b, c, p ) * volume >= 0;
+    }
+
+    /*
+      Clips the parameter interval [t0, t1] of the line p0 + t * d to
+      the axis aligned box; box holds (min, max) pairs for the first
+      dim axes. Returns false if the clipped interval is empty.
+    */
+    inline bool clipBox( const Point& p0, const Point& d, const double* box, int dim, double& t0, double& t1 ) {
+        for( int a = 0; a < dim; a++ ) {
+            const double lo = box[2 * a], hi = box[2 * a + 1];
+            if( d[a] == 0 ) {
+                if( p0[a] < lo || p0[a] > hi ) return false;
+                continue;
+            }
+
+            double ta = (lo - p0[a]) / d[a];
+            double tb = (hi - p0[a]) / d[a];
+            if( ta > tb ) std::swap( ta, tb );
+            t0 = std::max( t0, ta );
+            t1 = std::min( t1, tb );
+            if( t0 > t1 ) return false;
+        }
+
+        return true;
+    }
+
+    inline bool boxContains( const double* box, int dim, const Point& p ) {
+        for( int a = 0; a < dim; a++ )
+            if( p[a] < box[2 * a] || p[a] > box[2 * a + 1] ) return false;
+
+        return true;
+    }
+
+}
+
+    GridSpatialIndex::GridSpatialIndex( const EclipseGrid& grid ) :
+        nx( grid.getNX() ), ny( grid.getNY() ), nz( grid.getNZ() ),
+        m_mapper( nx, ny, nz )
+    {
+        grid.exportCOORD( m_coord );
+        grid.exportZCORN( m_zcorn );
+        this->build();
+    }
+
+    GridSpatialIndex::GridSpatialIndex( const GridDims& dims,
+                                        std::vector< double > coord,
+                                        std::vector< double > zcorn ) :
+        nx( dims.getNX() ), ny( dims.getNY() ), nz( dims.getNZ() ),
+        m_mapper( nx, ny, nz ),
+        m_coord( std::move( coord ) ),
+        m_zcorn( std::move( zcorn ) )
+    {
+        if( m_coord.size() != 6 * (nx + 1) * (ny + 1) )
+            throw std::invalid_argument("COORD has wrong size");
+
+        m_mapper.fixupZCORN( m_zcorn );
+        this->build();
+    }
+
+    GridSpatialIndex::Corners GridSpatialIndex::cellCorners( size_t g ) const {
+        const size_t i = g % this->nx;
+        const size_t j = (g / this->nx) % this->ny;
+        const size_t k = g / (this->nx * this->ny);
+
+        Corners corners;
+        for( int c = 0; c < 8; c++ ) {
+            const size_t p = (i + (c & 1)) + (j + ((c >> 1) & 1)) * (this->nx + 1);
+            const double* pillar = &m_coord[ 6 * p ];
+            const double z = m_zcorn[ m_mapper.index( i, j, k, c ) ];
+            const double dz = pillar[5] - pillar[2];
+            const double t = dz == 0 ? 0.0 : (z - pillar[2]) / dz;
+
+            corners.x[c] = pillar[0] + t * (pillar[3] - pillar[0]);
+            corners.y[c] = pillar[1] + t * (pillar[4] - pillar[1]);
+            corners.z[c] = z;
+        }
+
+        return corners;
+    }
+
+    void GridSpatialIndex::build() {
+        const size_t columns = this->nx * this->ny;
+        const size_t size = columns * this->nz;
+        if( m_zcorn.size() != m_mapper.size() )
+            throw std::invalid_argument("ZCORN has wrong size");
+
+        if( size == 0 ) {
+            m_bin_offset.assign( 2, 0 );
+            return;
+        }
+
+        m_cell_box.resize( 6 * size );
+        m_column_box.resize( 4 * columns );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for( long g = 0; g < long( size ); g++ ) {
+            const auto corners = this->cellCorners( g );
+            double* box = &m_cell_box[ 6 * g ];
+            const double* coords[3] = { corners.x, corners.y, corners.z };
+
+            for( int a = 0; a < 3; a++ ) {
+                box[2 * a] = *std::min_element( coords[a], coords[a] + 8 );
+                box[2 * a + 1] = *std::max_element( coords[a], coords[a] + 8 );
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for( long column = 0; column < long( columns ); column++ ) {
+            double* column_box = &m_column_box[ 4 * column ];
+            column_box[0] = column_box[2] = std::numeric_limits< double >::max();
+            column_box[1] = column_box[3] = std::numeric_limits< double >::lowest();
+
+            for( size_t k = 0; k < this->nz; k++ ) {
+                double* box = &m_cell_box[ 6 * (column + k * columns) ];
+                column_box[0] = std::min( column_box[0], box[0] );
+                column_box[1] = std::max( column_box[1], box[1] );
+                column_box[2] = std::min( column_box[2], box[2] );
+                column_box[3] = std::max( column_box[3], box[3] );
+
+                if( k > 0 )
+                    box[5] = std::max( box[5], m_cell_box[ 6 * (column + (k - 1) * columns) + 5 ] );
+            }
+
+            for( size_t k = this->nz - 1; k > 0; k-- ) {
+                const double zmin = m_cell_box[ 6 * (column + k * columns) + 4 ];
+                double& above = m_cell_box[ 6 * (column + (k - 1) * columns) + 4 ];
+                above = std::min( above, zmin );
+            }
+        }
+
+        /* One bin per column, laid out over the xy extent of the grid. */
+        double xmax = std::numeric_limits< double >::lowest();
+        double ymax = std::numeric_limits< double >::lowest();
+        m_x0 = m_y0 = std::numeric_limits< double >::max();
+        for( size_t column = 0; column < columns; column++ ) {
+            const double* box = &m_column_box[ 4 * column ];
+            m_x0 = std::min( m_x0, box[0] );
+            xmax = std::max( xmax, box[1] );
+            m_y0 = std::min( m_y0, box[2] );
+            ymax = std::max( ymax, box[3] );
+        }
+
+        m_bins_x = std::max< size_t >( this->nx, 1 );
+        m_bins_y = std::max< size_t >( this->ny, 1 );
+        m_bin_dx = xmax > m_x0 ? (xmax - m_x0) / m_bins_x : 1.0;
+        m_bin_dy = ymax > m_y0 ? (ymax - m_y0) / m_bins_y : 1.0;
+
+        m_bin_offset.assign( m_bins_x * m_bins_y + 1, 0 );
+        for( int pass = 0; pass < 2; pass++ ) {
+            auto cursor = m_bin_offset;
+            for( size_t column = 0; column < columns; column++ ) {
+                const double* box = &m_column_box[ 4 * column ];
+                const auto lo = this->binCoordinates( box[0], box[2] );
+                const auto hi = this->binCoordinates( box[1], box[3] );
+
+                for( size_t by = lo[1]; by <= hi[1]; by++ )
+                    for( size_t bx = lo[0]; bx <= hi[0]; bx++ ) {
+                        const size_t b = this->binIndex( bx, by );
+                        if( pass == 0 )
+                            m_bin_offset[ b + 1 ]++;
+                        else
+                            m_bin_columns[ cursor[b]++ ] = column;
+                    }
+            }
+
+            if( pass == 0 ) {
+                for( size_t b = 0; b + 1 < m_bin_offset.size(); b++ )
+                    m_bin_offset[ b + 1 ] += m_bin_offset[b];
+
+                m_bin_columns.resize( m_bin_offset.back() );
+            }
+        }
+    }
+
+    size_t GridSpatialIndex::binIndex( size_t bx, size_t by ) const {
+        return bx + by * m_bins_x;
+    }
+
+    std::array< size_t, 2 > GridSpatialIndex::binCoordinates( double x, double y ) const {
+        const double fx = std::floor( (x - m_x0) / m_bin_dx );
+        const double fy = std::floor( (y - m_y0) / m_bin_dy );
+
+        return {{ size_t( std::min( std::max( fx, 0.0 ), double( m_bins_x - 1 ) ) ),
+                  size_t( std::min( std::max( fy, 0.0 ), double( m_bins_y - 1 ) ) ) }};
+    }
+
+    /*
+      The layers [k0, k1) of the column which can contain z values in
+      [zmin, zmax]; the running max/min values in the cell boxes are
+      monotone along the column.
+    */
+    std::array< size_t, 2 > GridSpatialIndex::layerRange( size_t column, double zmin, double zmax ) const {
+        const size_t columns = this->nx * this->ny;
+        const auto zvalue = [&]( size_t k, int offset ) {
+            return m_cell_box[ 6 * (column + k * columns) + offset ];
+        };
+
+        size_t lo = 0, hi = this->nz;
+        while( lo < hi ) {
+            const size_t mid = (lo + hi) / 2;
+            if( zvalue( mid, 5 ) < zmin ) lo = mid + 1;
+            else hi = mid;
+        }
+
+        const size_t k0 = lo;
+        hi = this->nz;
+        while( lo < hi ) {
+            const size_t mid = (lo + hi) / 2;
+            if( zvalue( mid, 4 ) <= zmax ) lo = mid + 1;
+            else hi = mid;
+        }
+
+        return {{ k0, lo }};
+    }
+
+    bool GridSpatialIndex::cellContains( size_t g, double x, double y, double z ) const {
+        const auto corners = this->cellCorners( g );
+        const Point p = {{ x, y, z }};
+
+        for( const auto& tet : tetrahedra ) {
+            Point v[4];
+            for( int n = 0; n < 4; n++ )
+                v[n] = {{ corners.x[ tet[n] ], corners.y[ tet[n] ], corners.z[ tet[n] ] }};
+
+            if( tetContains( v[0], v[1], v[2], v[3], p ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    int GridSpatialIndex::findCell( double x, double y, double z ) const {
+        const size_t columns = this->nx * this->ny;
+        const Point p = {{ x, y, z }};
+
+        if( x < m_x0 || x > m_x0 + m_bins_x * m_bin_dx || y < m_y0 || y > m_y0 + m_bins_y * m_bin_dy )
+            return -1;
+
+        const auto bin = this->binCoordinates( x, y );
+        const size_t b = this->binIndex( bin[0], bin[1] );
+        for( size_t n = m_bin_offset[b]; n < m_bin_offset[b + 1]; n++ ) {
+            const size_t column = m_bin_columns[n];
+            if( !boxContains( &m_column_box[ 4 * column ], 2, p ) ) continue;
+
+            const auto layers = this->layerRange( column, z, z );
+            for( size_t k = layers[0]; k < layers[1]; k++ ) {
+                const size_t g = column + k * columns;
+                if( boxContains( &m_cell_box[ 6 * g ], 3, p ) && this->cellContains( g, x, y, z ) )
+                    return int( g );
+            }
+        }
+
+        return -1;
+    }
+
+    std::vector< int > GridSpatialIndex::findCells( const std::vector< std::array< double, 3 > >& points ) const {
+        std::vector< int > cells( points.size() );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+        for( long n = 0; n < long( points.size() ); n++ )
+            cells[n] = this->findCell( points[n][0], points[n][1], points[n][2] );
+
+        return cells;
+    }
+
+    /*
+      Cyrus-Beck clipping of the segment against each of the six
+      tetrahedra; the cell interval spans the union of the nonempty
+      tetrahedron intervals.
+    */
+    bool GridSpatialIndex::clipSegment( size_t g, const Point& p0, const Point& d, double& t0, double& t1 ) const {
+        static const int faces[4][4] = { { 1, 2, 3, 0 }, { 0, 2, 3, 1 }, { 0, 1, 3, 2 }, { 0, 1, 2, 3 } };
+        const auto corners = this->cellCorners( g );
+
+        t0 = std::numeric_limits< double >::max();
+        t1 = std::numeric_limits< double >::lowest();
+
+        for( const auto& tet : tetrahedra ) {
+            Point v[4];
+            for( int n = 0; n < 4; n++ )
+                v[n] = {{ corners.x[ tet[n] ], corners.y[ tet[n] ], corners.z[ tet[n] ] }};
+
+            double ta = 0, tb = 1;
+            bool empty = false;
+            for( const auto& face : faces ) {
+                const Point& a = v[ face[0] ];
+                Point normal = cross( sub( v[ face[1] ], a ), sub( v[ face[2] ], a ) );
+                const double side = dot( normal, sub( v[ face[3] ], a ) );
+                if( side == 0 ) { empty = true; break; }
+                if( side < 0 ) normal = {{ -normal[0], -normal[1], -normal[2] }};
+
+                const double num = dot( normal, sub( p0, a ) );
+                const double den = dot( normal, d );
+                if( den == 0 ) {
+                    if( num < 0 ) { empty = true; break; }
+                } else if( den > 0 )
+                    ta = std::max( ta, -num / den );
+                else
+                    tb = std::min( tb, -num / den );
+
+                if( ta >= tb ) { empty = true; break; }
+            }
+
+            if( !empty ) {
+                t0 = std::min( t0, ta );
+                t1 = std::max( t1, tb );
+            }
+        }
+
+        return t0 < t1;
+    }
+
+    std::vector< GridSpatialIndex::Intersection > GridSpatialIndex::traverse( const Point& p0, const Point& p1 ) const {
+        std::vector< Intersection > cells;
+        const size_t columns = this->nx * this->ny;
+        const Point d = sub( p1, p0 );
+        const double length = std::sqrt( dot( d, d ) );
+        if( length == 0 ) return cells;
+
+        const double grid_box[4] = { m_x0, m_x0 + m_bins_x * m_bin_dx, m_y0, m_y0 + m_bins_y * m_bin_dy };
+        double s0 = 0, s1 = 1;
+        if( !clipBox( p0, d, grid_box, 2, s0, s1 ) ) return cells;
+
+        const auto lo = this->binCoordinates( std::min( p0[0] + s0 * d[0], p0[0] + s1 * d[0] ),
+                                              std::min( p0[1] + s0 * d[1], p0[1] + s1 * d[1] ) );
+        const auto hi = this->binCoordinates( std::max( p0[0] + s0 * d[0], p0[0] + s1 * d[0] ),
+                                              std::max( p0[1] + s0 * d[1], p0[1] + s1 * d[1] ) );
+
+        std::vector< size_t > candidates;
+        for( size_t by = lo[1]; by <= hi[1]; by++ )
+            for( size_t bx = lo[0]; bx <= hi[0]; bx++ ) {
+                const size_t b = this->binIndex( bx, by );
+                candidates.insert( candidates.end(),
+                                   m_bin_columns.begin() + m_bin_offset[b],
+                                   m_bin_columns.begin() + m_bin_offset[b + 1] );
+            }
+
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+        for( const size_t column : candidates ) {
+            double c0 = 0, c1 = 1;
+            if( !clipBox( p0, d, &m_column_box[ 4 * column ], 2, c0, c1 ) ) continue;
+
+            const double za = p0[2] + c0 * d[2];
+            const double zb = p0[2] + c1 * d[2];
+            const auto layers = this->layerRange( column, std::min( za, zb ), std::max( za, zb ) );
+
+            for( size_t k = layers[0]; k < layers[1]; k++ ) {
+                const size_t g = column + k * columns;
+                double b0 = 0, b1 = 1, t0, t1;
+                if( !clipBox( p0, d, &m_cell_box[ 6 * g ], 3, b0, b1 ) ) continue;
+
+                if( this->clipSegment( g, p0, d, t0, t1 ) && (t1 - t0) * length > 1e-12 * (1 + length) )
+                    cells.push_back( { g, t0 * length, t1 * length } );
+            }
+        }
+
+        std::sort( cells.begin(), cells.end(), []( const Intersection& a, const Intersection& b ) {
+            return a.entry < b.entry || (a.entry == b.entry && a.exit < b.exit);
+        } );
+
+        return cells;
+    }
+
+    size_t GridSpatialIndex::memoryUsage() const {
+        return memory::heap( m_coord ) + memory::heap( m_zcorn )
+             + memory::heap( m_cell_box ) + memory::heap( m_column_box )
+             + memory::heap( m_bin_offset ) + memory::heap( m_bin_columns );
+    }
+}
@@ -0,0 +1,93 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include <opm/parser/eclipse/EclipseState/Grid/RegionCells.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
+namespace Opm {
+
+    RegionCells::RegionCells( const std::vector< int >& regions ) {
+        if( regions.empty() ) {
+            this->m_offset.assign( 1, 0 );
+            return;
+        }
+
+        const auto minmax = std::minmax_element( regions.begin(), regions.end() );
+        this->m_min = *minmax.first;
+
+        const auto range = size_t( (long long)( *minmax.second ) - this->m_min + 1 );
+        size_t slots = range;
+        if( range > 2 * regions.size() + 1024 ) {
+            this->m_values = regions;
+            std::sort( this->m_values.begin(), this->m_values.end() );
+            this->m_values.erase( std::unique( this->m_values.begin(), this->m_values.end() ),
+                                  this->m_values.end() );
+            slots = this->m_values.size();
+        }
+
+        std::vector< size_t > cell_slot( regions.size() );
+        this->m_offset.assign( slots + 1, 0 );
+        for( size_t g = 0; g < regions.size(); g++ ) {
+            this->slot( regions[ g ], cell_slot[ g ] );
+            this->m_offset[ cell_slot[ g ] + 1 ]++;
+        }
+
+        for( size_t s = 0; s < slots; s++ )
+            this->m_offset[ s + 1 ] += this->m_offset[ s ];
+
+        /* the cells are visited in order, so each list comes out sorted */
+        std::vector< size_t > next( this->m_offset.begin(), this->m_offset.end() - 1 );
+        this->m_cells.resize( regions.size() );
+        for( size_t g = 0; g < regions.size(); g++ )
+            this->m_cells[ next[ cell_slot[ g ] ]++ ] = g;
+    }
+
+    bool RegionCells::slot( int value, size_t& index ) const {
+        if( this->m_values.empty() ) {
+            if( value < this->m_min ) return false;
+
+            index = size_t( (long long)( value ) - this->m_min );
+            return index + 1 < this->m_offset.size();
+        }
+
+        const auto iter = std::lower_bound( this->m_values.begin(), this->m_values.end(), value );
+        if( iter == this->m_values.end() || *iter != value ) return false;
+
+        index = iter - this->m_values.begin();
+        return true;
+    }
+
+    RegionCells::Range RegionCells::cells( int value ) const {
+        size_t index;
+        if( !this->slot( value, index ) )
+            return Range( nullptr, nullptr );
+
+        const size_t* data = this->m_cells.data();
+        return Range( data + this->m_offset[ index ], data + this->m_offset[ index + 1 ] );
+    }
+
+    size_t RegionCells::memoryUsage() const {
+        return memory::heap( this->m_values )
+             + memory::heap( this->m_offset )
+             + memory::heap( this->m_cells );
+    }
+
+}
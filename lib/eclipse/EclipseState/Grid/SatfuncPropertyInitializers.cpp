@@ -704,11 +704,12 @@ namespace Opm {
         const bool useEnptvd = tableManager->useEnptvd();
         const auto& enptvdTables = tableManager->getEnptvdTables();
 
+        const auto& cellDepths = eclipseGrid->getCellDepths();
         const auto gridsize = eclipseGrid->getCartesianSize();
         for( size_t cellIdx = 0; cellIdx < gridsize; cellIdx++ ) {
             int satTableIdx = satnum.iget( cellIdx ) - 1;
             int endNum = endnum.iget( cellIdx ) - 1;
-            double cellDepth = eclipseGrid->getCellDepth( cellIdx );
+            double cellDepth = cellDepths[ cellIdx ];
 
 
             values[cellIdx] = selectValue(enptvdTables,
@@ -746,11 +747,13 @@ namespace Opm {
         // assign a NaN in this case...
         const bool useImptvd = tableManager->useImptvd();
         const TableContainer& imptvdTables = tableManager->getImptvdTables();
+
+        const auto& cellDepths = eclipseGrid->getCellDepths();
         const auto gridsize = eclipseGrid->getCartesianSize();
         for( size_t cellIdx = 0; cellIdx < gridsize; cellIdx++ ) {
             int imbTableIdx = imbnum.iget( cellIdx ) - 1;
             int endNum = endnum.iget( cellIdx ) - 1;
-            double cellDepth = eclipseGrid->getCellDepth( cellIdx );
+            double cellDepth = cellDepths[ cellIdx ];
 
             values[cellIdx] = selectValue(imptvdTables,
                                                 (useImptvd && endNum >= 0) ? endNum : -1,
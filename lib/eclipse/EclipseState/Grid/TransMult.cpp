@@ -28,6 +28,7 @@
 #include <opm/parser/eclipse/EclipseState/Grid/TransMult.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridDims.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/MULTREGTScanner.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 
 namespace Opm {
@@ -66,10 +67,11 @@ namespace Opm {
     }
 
     double TransMult::getMultiplier__(size_t globalIndex,  FaceDir::DirEnum faceDir) const {
-        if (hasDirectionProperty( faceDir )) {
-            return m_trans.at(faceDir).iget( globalIndex );
-        } else
+        const auto iter = m_trans.find( faceDir );
+        if (iter == m_trans.end())
             return 1.0;
+
+        return iter->second.iget( globalIndex );
     }
 
 
@@ -90,6 +92,12 @@ namespace Opm {
 
     void TransMult::insertNewProperty(FaceDir::DirEnum faceDir) {
         GridPropertySupportedKeywordInfo<double> kwInfo(m_names[faceDir] , 1.0 , "1");
+        /*
+          The direction properties start out sparse; a multiplier which
+          is only set on a few faces never gets full storage. The
+          per-face getMultiplier() lookup then returns the constant as
+          long as no face is set, and costs one hash lookup otherwise.
+        */
         GridProperty< double > prop( m_nx, m_ny, m_nz, kwInfo );
         m_trans.emplace( faceDir, std::move( prop ) );
     }
@@ -105,10 +113,7 @@ namespace Opm {
     void TransMult::applyMULT(const GridProperty<double>& srcProp, FaceDir::DirEnum faceDir)
     {
         auto& dstProp = getDirectionProperty(faceDir);
-
-        const std::vector<double> &srcData = srcProp.getData();
-        for (size_t i = 0; i < srcData.size(); ++i)
-            dstProp.multiplyValueAtIndex(i, srcData[i]);
+        dstProp.multiplyWith( srcProp );
     }
 
 
@@ -127,6 +132,11 @@ namespace Opm {
     }
 
 
+    /* The MULTREGT scanner is not counted. */
+    size_t TransMult::memoryUsage() const {
+        return memory::heap( this->m_trans ) + memory::heap( this->m_names );
+    }
+
     void TransMult::applyMULTFLT(const FaultCollection& faults) {
         for (size_t faultIndex = 0; faultIndex < faults.size(); faultIndex++) {
             auto& fault = faults.getFault(faultIndex);
@@ -333,6 +333,12 @@ namespace Opm {
     bool Completion::operator!=( const Completion& rhs ) const {
         return !( *this == rhs );
     }
+
+    size_t Completion::memoryUsage() const {
+        return m_diameter.memoryUsage()
+             + m_connectionTransmissibilityFactor.memoryUsage()
+             + m_skinFactor.memoryUsage();
+    }
 }
 
 
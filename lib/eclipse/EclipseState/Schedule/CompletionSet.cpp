@@ -25,6 +25,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/ScheduleEnums.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Completion.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/CompletionSet.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -36,6 +37,10 @@ namespace Opm {
         return m_completions.size();
     }
 
+    size_t CompletionSet::memoryUsage() const {
+        return memory::heap( m_completions );
+    }
+
     const Completion& CompletionSet::get(size_t index) const {
         return this->m_completions.at( index );
     }
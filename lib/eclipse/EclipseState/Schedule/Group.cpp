@@ -22,6 +22,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/DynamicState.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Group.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #define INVALID_GROUP_RATE -999e100
 #define INVALID_EFFICIENCY_FACTOR 0.0
@@ -278,6 +279,16 @@ namespace Opm {
         return this->m_wells.at( time_step );
     }
 
+    size_t Group::memoryUsage() const {
+        return memory::heap( this->m_name )
+             + this->m_wells.memoryUsage()
+             + this->m_isProductionGroup.memoryUsage()
+             + this->m_isInjectionGroup.memoryUsage()
+             + this->m_efficiencyFactor.memoryUsage()
+             + this->m_transferEfficiencyFactor.memoryUsage()
+             + this->m_groupNetVFPTable.memoryUsage();
+    }
+
     size_t Group::numWells(size_t time_step) const {
         return this->m_wells.at( time_step ).size();
     }
@@ -53,6 +53,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/WellProductionProperties.hpp>
 #include <opm/parser/eclipse/Units/Dimension.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -259,7 +260,7 @@ namespace Opm {
                     m_events.addEvent( ScheduleEvents::GEO_MODIFIER , currentStep);
                 } else {
                     std::string msg = "OPM does not support grid property modifier " + keyword.name() + " in the Schedule section. Error at report: " + std::to_string( currentStep );
-                    parseContext.handleError( ParseContext::UNSUPPORTED_SCHEDULE_GEO_MODIFIER , m_messages, msg );
+                    parseContext.handleError( ParseContext::ErrorKey::UNSUPPORTED_SCHEDULE_GEO_MODIFIER , m_messages, msg, keyword.name() );
                 }
             }
         }
@@ -302,7 +303,7 @@ namespace Opm {
             if (bhp_terminate == "YES") {
                 std::string msg = "The WHISTCTL keyword does not handle 'YES'. i.e. to terminate the run";
                 m_messages.error(msg);
-                parseContext.handleError( ParseContext::UNSUPPORTED_TERMINATE_IF_BHP , m_messages, msg );
+                parseContext.handleError( ParseContext::ErrorKey::UNSUPPORTED_TERMINATE_IF_BHP , m_messages, msg, keyword.name() );
             }
 
         }
@@ -315,7 +316,7 @@ namespace Opm {
             if ((methodItem.get< std::string >(0) != "TRACK")  && (methodItem.get< std::string >(0) != "INPUT")) {
                 std::string msg = "The COMPORD keyword only handles 'TRACK' or 'INPUT' order.";
                 m_messages.error(msg);
-                parseContext.handleError( ParseContext::UNSUPPORTED_COMPORD_TYPE , m_messages, msg );
+                parseContext.handleError( ParseContext::ErrorKey::UNSUPPORTED_COMPORD_TYPE , m_messages, msg, compordKeyword.name() );
             }
         }
     }
@@ -1675,6 +1676,19 @@ namespace Opm {
         return m_messages;
     }
 
+    void Schedule::memoryUsage( MemoryUsage& usage ) const {
+        /* the OrderedMap itself: the index and the Well objects */
+        usage.add( "Schedule/wells", memory::heap( m_wells ) );
+        for( const auto& well : m_wells )
+            well.memoryUsage( usage );
+
+        usage.add( "Schedule/groups", memory::heap( m_groups ) );
+        usage.add( "Schedule/modifier decks", m_modifierDeck.memoryUsage() );
+        usage.add( "Schedule/other", m_rootGroupTree.memoryUsage()
+                                   + m_oilvaporizationproperties.memoryUsage()
+                                   + m_messages.memoryUsage() );
+    }
+
 
     const Events& Schedule::getEvents() const {
         return this->m_events;
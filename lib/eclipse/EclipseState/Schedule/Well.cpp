@@ -26,6 +26,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/MSW/SegmentSet.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/TimeMap.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <ert/ecl/ecl_grid.h>
 
@@ -243,6 +244,31 @@ namespace Opm {
         return m_messages;
     }
 
+    void Well::memoryUsage( MemoryUsage& usage ) const {
+        usage.add( "Schedule/completions", m_completions.memoryUsage() );
+        usage.add( "Schedule/wells", memory::heap( m_name )
+                                   + m_status.memoryUsage()
+                                   + m_isAvailableForGroupControl.memoryUsage()
+                                   + m_guideRate.memoryUsage()
+                                   + m_guideRatePhase.memoryUsage()
+                                   + m_guideRateScalingFactor.memoryUsage()
+                                   + m_efficiencyFactors.memoryUsage()
+                                   + m_isProducer.memoryUsage()
+                                   + m_productionProperties.memoryUsage()
+                                   + m_injectionProperties.memoryUsage()
+                                   + m_polymerProperties.memoryUsage()
+                                   + m_econproductionlimits.memoryUsage()
+                                   + m_solventFraction.memoryUsage()
+                                   + m_groupName.memoryUsage()
+                                   + m_rft.memoryUsage()
+                                   + m_plt.memoryUsage()
+                                   + m_headI.memoryUsage()
+                                   + m_headJ.memoryUsage()
+                                   + m_refDepth.memoryUsage()
+                                   + m_messages.memoryUsage()
+                                   + m_segmentset.memoryUsage() );
+    }
+
     bool Well::isProducer(size_t timeStep) const {
         return bool( m_isProducer.get(timeStep) );
     }
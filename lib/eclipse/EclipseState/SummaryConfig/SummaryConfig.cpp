@@ -36,6 +36,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/TimeMap.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well.hpp>
 #include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <ert/ecl/Smspec.hpp>
 #include <ert/ecl/ecl_smspec.h>
@@ -148,20 +149,20 @@ namespace {
 void handleMissingWell( const ParseContext& parseContext , const std::string& keyword, const std::string& well) {
     std::string msg = std::string("Error in keyword:") + keyword + std::string(" No such well: ") + well;
     MessageContainer msgContainer;
-    if (parseContext.get( ParseContext::SUMMARY_UNKNOWN_WELL) == InputError::WARN)
+    if (parseContext.get( ParseContext::ErrorKey::SUMMARY_UNKNOWN_WELL ) == InputError::WARN)
         std::cerr << "ERROR: " << msg << std::endl;
 
-    parseContext.handleError( ParseContext::SUMMARY_UNKNOWN_WELL , msgContainer , msg );
+    parseContext.handleError( ParseContext::ErrorKey::SUMMARY_UNKNOWN_WELL , msgContainer , msg, keyword );
 }
 
 
 void handleMissingGroup( const ParseContext& parseContext , const std::string& keyword, const std::string& group) {
     std::string msg = std::string("Error in keyword:") + keyword + std::string(" No such group: ") + group;
     MessageContainer msgContainer;
-    if (parseContext.get( ParseContext::SUMMARY_UNKNOWN_GROUP) == InputError::WARN)
+    if (parseContext.get( ParseContext::ErrorKey::SUMMARY_UNKNOWN_GROUP ) == InputError::WARN)
         std::cerr << "ERROR: " << msg << std::endl;
 
-    parseContext.handleError( ParseContext::SUMMARY_UNKNOWN_GROUP , msgContainer , msg );
+    parseContext.handleError( ParseContext::ErrorKey::SUMMARY_UNKNOWN_GROUP , msgContainer , msg, keyword );
 }
 
 inline void keywordW( std::vector< ERT::smspec_node >& list,
@@ -486,4 +487,10 @@ bool SummaryConfig::requireFIPNUM( ) const {
            this->hasKeyword("RPR");
 }
 
+void SummaryConfig::memoryUsage( MemoryUsage& usage ) const {
+    usage.add( "SummaryConfig", this->keywords.capacity() * sizeof( ERT::smspec_node )
+                              + memory::heap( this->short_keywords )
+                              + memory::heap( this->summary_keywords ) );
+}
+
 }
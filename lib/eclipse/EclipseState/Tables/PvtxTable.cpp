@@ -24,6 +24,7 @@
 #include <opm/parser/eclipse/EclipseState/Tables/PvtxTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/SimpleTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableSchema.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -117,6 +118,13 @@ namespace Opm {
         return m_outerColumn.size();
     }
 
+    size_t PvtxTable::memoryUsage() const
+    {
+        return m_outerColumn.memoryUsage()
+             + memory::heap( m_underSaturatedTables )
+             + m_saturatedTable.memoryUsage();
+    }
+
 
     size_t PvtxTable::numTables( const DeckKeyword& keyword )
     {
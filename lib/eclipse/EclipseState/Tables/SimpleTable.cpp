@@ -22,6 +22,7 @@
 #include <opm/parser/eclipse/EclipseState/Tables/SimpleTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableSchema.hpp>
 #include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -157,4 +158,10 @@ namespace Opm {
         else
             std::cerr << "Developer warning: Raw values from JFUNC column is read, but JFUNC not provided in deck." << std::endl;
     }
+
+    size_t SimpleTable::memoryUsage() const {
+        return memory::heap( m_columnNames )
+             + memory::heap( m_valueDefaulted )
+             + memory::heap( m_columns );
+    }
 }
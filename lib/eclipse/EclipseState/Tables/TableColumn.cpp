@@ -21,6 +21,7 @@
 
 #include <opm/parser/eclipse/EclipseState/Tables/ColumnSchema.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableColumn.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <ert/util/ssize_t.h>
 
@@ -34,6 +35,12 @@ namespace Opm {
 
 
 
+    size_t TableColumn::memoryUsage() const {
+        return memory::heap( m_name )
+             + memory::heap( m_values )
+             + memory::heap( m_default );
+    }
+
     size_t TableColumn::size() const {
         return m_values.size();
     }
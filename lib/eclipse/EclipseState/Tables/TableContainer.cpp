@@ -21,6 +21,8 @@
 #include <iostream>
 
 #include <opm/parser/eclipse/EclipseState/Tables/TableContainer.hpp>
+#include <opm/parser/eclipse/EclipseState/Tables/SimpleTable.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -39,6 +41,10 @@ namespace Opm {
         return m_tables.size();
     }
 
+    size_t TableContainer::memoryUsage() const {
+        return memory::heap( m_tables );
+    }
+
 
     size_t TableContainer::hasTable(size_t tableNumber) const {
         if (m_tables.find( tableNumber ) == m_tables.end())
@@ -23,6 +23,7 @@
 #include <opm/parser/eclipse/Parser/ParserKeywords/T.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeywords/E.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeywords/M.hpp>
 #include <opm/parser/eclipse/Parser/ParserKeywords/P.hpp>
@@ -781,6 +782,54 @@ namespace Opm {
         return m_messages;
     }
 
+    void TableManager::memoryUsage( MemoryUsage& usage ) const {
+        for( const auto& pair : m_simpleTables ) {
+            if( !pair.second.empty() )
+                usage.add( "Tables/" + pair.first, pair.second.memoryUsage() );
+        }
+
+        if( !m_pvtgTables.empty() )
+            usage.add( "Tables/PVTG", memory::heap( m_pvtgTables ) );
+
+        if( !m_pvtoTables.empty() )
+            usage.add( "Tables/PVTO", memory::heap( m_pvtoTables ) );
+
+        const auto flat = [&usage]( const char* name, size_t capacity, size_t record ) {
+            if( capacity > 0 ) usage.add( std::string( "Tables/" ) + name, capacity * record );
+        };
+
+        flat( "PVTW", m_pvtwTable.capacity(), sizeof( PVTWRecord ) );
+        flat( "PVCDO", m_pvcdoTable.capacity(), sizeof( PVCDORecord ) );
+        flat( "DENSITY", m_densityTable.capacity(), sizeof( DENSITYRecord ) );
+        flat( "ROCK", m_rockTable.capacity(), sizeof( ROCKRecord ) );
+        flat( "VISCREF", m_viscrefTable.capacity(), sizeof( VISCREFRecord ) );
+        flat( "WATDENT", m_watdentTable.capacity(), sizeof( WATDENTRecord ) );
+
+        size_t vfp = 0;
+        for( const auto& pair : m_vfpprodTables ) {
+            const auto& table = pair.second;
+            vfp += memory::tree_node + sizeof( pair )
+                 + table.getTable().num_elements() * sizeof( double )
+                 + memory::heap( table.getFloAxis() ) + memory::heap( table.getTHPAxis() )
+                 + memory::heap( table.getWFRAxis() ) + memory::heap( table.getGFRAxis() )
+                 + memory::heap( table.getALQAxis() );
+        }
+
+        if( vfp > 0 ) usage.add( "Tables/VFPPROD", vfp );
+
+        vfp = 0;
+        for( const auto& pair : m_vfpinjTables ) {
+            const auto& table = pair.second;
+            vfp += memory::tree_node + sizeof( pair )
+                 + table.getTable().num_elements() * sizeof( double )
+                 + memory::heap( table.getFloAxis() ) + memory::heap( table.getTHPAxis() );
+        }
+
+        if( vfp > 0 ) usage.add( "Tables/VFPINJ", vfp );
+
+        usage.add( "Tables/messages", m_messages.memoryUsage() );
+    }
+
 
     MessageContainer& TableManager::getMessageContainer() {
         return m_messages;
@@ -18,8 +18,10 @@
 */
 
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <memory>
+#include <stdexcept>
 
 
 namespace Opm {
@@ -143,11 +145,101 @@ namespace Opm {
     }
 
 
+    size_t MessageContainer::countIndex( const std::string& key,
+                                         const std::string& keyword,
+                                         const std::string& filename,
+                                         Message::type mtype ) {
+        std::string id;
+        id.reserve( key.size() + keyword.size() + filename.size() + 2 );
+        id.append( key ).append( 1, '\0' )
+          .append( keyword ).append( 1, '\0' )
+          .append( filename );
+
+        const auto pos = this->m_count_index.emplace( std::move( id ), this->m_counts.size() );
+        if( !pos.second )
+            return pos.first->second;
+
+        MessageCount mc;
+        mc.key = key;
+        mc.keyword = keyword;
+        mc.filename = filename;
+        mc.mtype = mtype;
+        this->m_counts.push_back( std::move( mc ) );
+        return this->m_counts.size() - 1;
+    }
+
+    void MessageContainer::add( Message&& msg,
+                                const std::string& key,
+                                const std::string& keyword ) {
+        const auto index = this->countIndex( key, keyword, msg.location.filename, msg.mtype );
+        auto& mc = this->m_counts[ index ];
+
+        if( mc.count == 0 )
+            mc.first = msg.location;
+
+        mc.last = msg.location;
+        mc.count++;
+
+        if( mc.count > this->m_limit ) {
+            this->m_suppressed++;
+            return;
+        }
+
+        this->m_aggregated.emplace_back( this->m_messages.size(), index );
+        this->m_messages.push_back( std::move( msg ) );
+    }
+
+
+    /*
+      The aggregated messages of other count against the limit of this
+      container; for every (key, keyword, filename) triplet only as many
+      of them are stored as this container still has room for, and the
+      rest are counted as suppressed.
+    */
     void MessageContainer::appendMessages(const MessageContainer& other)
     {
-        for(const auto& msg : other) {
-            this->add(msg);
+        std::vector< size_t > target( other.m_counts.size() );
+        std::vector< size_t > room( other.m_counts.size() );
+        for( size_t n = 0; n < other.m_counts.size(); ++n ) {
+            const auto& other_count = other.m_counts[ n ];
+            target[ n ] = this->countIndex( other_count.key, other_count.keyword,
+                                            other_count.filename, other_count.mtype );
+
+            const auto count = this->m_counts[ target[ n ] ].count;
+            room[ n ] = count < this->m_limit ? this->m_limit - count : 0;
+        }
+
+        auto aggregated = other.m_aggregated.begin();
+        for( size_t pos = 0; pos < other.m_messages.size(); ++pos ) {
+            const auto& msg = other.m_messages[ pos ];
+            if( aggregated == other.m_aggregated.end() || aggregated->first != pos ) {
+                this->add( msg );
+                continue;
+            }
+
+            const auto n = (aggregated++)->second;
+            if( room[ n ] == 0 ) {
+                this->m_suppressed++;
+                continue;
+            }
+
+            room[ n ]--;
+            this->m_aggregated.emplace_back( this->m_messages.size(), target[ n ] );
+            this->m_messages.push_back( msg );
+        }
+
+        for( size_t n = 0; n < other.m_counts.size(); ++n ) {
+            const auto& other_count = other.m_counts[ n ];
+            auto& mc = this->m_counts[ target[ n ] ];
+
+            if( mc.count == 0 )
+                mc.first = other_count.first;
+
+            mc.last = other_count.last;
+            mc.count += other_count.count;
         }
+
+        this->m_suppressed += other.m_suppressed;
     }
 
 
@@ -162,6 +254,43 @@ namespace Opm {
     std::size_t MessageContainer::size() const {
         return m_messages.size();
     }
-    
+
+    std::size_t MessageContainer::memoryUsage() const {
+        std::size_t bytes = this->m_messages.capacity() * sizeof( Message )
+                          + this->m_counts.capacity() * sizeof( MessageCount )
+                          + this->m_aggregated.capacity() * sizeof( std::pair< size_t, size_t > )
+                          + memory::heap( this->m_count_index );
+
+        for( const auto& msg : this->m_messages )
+            bytes += memory::heap( msg.message ) + memory::heap( msg.location.filename );
+
+        for( const auto& mc : this->m_counts )
+            bytes += memory::heap( mc.key ) + memory::heap( mc.keyword )
+                   + memory::heap( mc.filename )
+                   + memory::heap( mc.first.filename ) + memory::heap( mc.last.filename );
+
+        return bytes;
+    }
+
+    void MessageContainer::setMessageLimit( std::size_t limit ) {
+        this->m_limit = limit;
+    }
+
+    std::size_t MessageContainer::messageLimit() const {
+        return this->m_limit;
+    }
+
+    /*
+      The number of messages which have been counted, but not stored,
+      because the message limit for their key was exceeded.
+    */
+    std::size_t MessageContainer::suppressed() const {
+        return this->m_suppressed;
+    }
+
+    const std::vector< MessageCount >& MessageContainer::counts() const {
+        return this->m_counts;
+    }
+
 
 } // namespace Opm
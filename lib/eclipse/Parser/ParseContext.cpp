@@ -19,6 +19,7 @@
 
 #include <ert/util/util.h>
 #include <cstdlib>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 
@@ -27,6 +28,50 @@
 
 namespace Opm {
 
+namespace {
+
+    const std::string& error_key_name( ParseContext::ErrorKey key ) {
+        static const std::array< const std::string*,
+                                 static_cast< size_t >( ParseContext::ErrorKey::COUNT ) > names = {{
+            &ParseContext::PARSE_UNKNOWN_KEYWORD,
+            &ParseContext::PARSE_RANDOM_TEXT,
+            &ParseContext::PARSE_RANDOM_SLASH,
+            &ParseContext::PARSE_MISSING_DIMS_KEYWORD,
+            &ParseContext::PARSE_EXTRA_DATA,
+            &ParseContext::PARSE_MISSING_INCLUDE,
+            &ParseContext::UNSUPPORTED_SCHEDULE_GEO_MODIFIER,
+            &ParseContext::UNSUPPORTED_COMPORD_TYPE,
+            &ParseContext::UNSUPPORTED_INITIAL_THPRES,
+            &ParseContext::UNSUPPORTED_TERMINATE_IF_BHP,
+            &ParseContext::INTERNAL_ERROR_UNINITIALIZED_THPRES,
+            &ParseContext::SUMMARY_UNKNOWN_WELL,
+            &ParseContext::SUMMARY_UNKNOWN_GROUP
+        }};
+
+        return *names.at( static_cast< size_t >( key ) );
+    }
+
+    /*
+      Returns ErrorKey::COUNT if @key is not one of the predefined keys.
+      The name to id table is built once, on first use.
+    */
+    ParseContext::ErrorKey error_key_id( const std::string& key ) {
+        static const auto ids = [] {
+            std::unordered_map< std::string, ParseContext::ErrorKey > table;
+            const auto count = static_cast< size_t >( ParseContext::ErrorKey::COUNT );
+            for( size_t id = 0; id < count; ++id ) {
+                const auto error_key = static_cast< ParseContext::ErrorKey >( id );
+                table.emplace( error_key_name( error_key ), error_key );
+            }
+            return table;
+        }();
+
+        const auto iter = ids.find( key );
+        return iter == ids.end() ? ParseContext::ErrorKey::COUNT : iter->second;
+    }
+
+}
+
 
     /*
       A set of predefined error modes are added, with the default
@@ -68,6 +113,8 @@ namespace Opm {
     }
 
     void ParseContext::initDefault() {
+        this->m_actions.fill( InputError::THROW_EXCEPTION );
+
         addKey(PARSE_UNKNOWN_KEYWORD);
         addKey(PARSE_RANDOM_TEXT);
         addKey(PARSE_RANDOM_SLASH);
@@ -98,6 +145,10 @@ namespace Opm {
             MessageContainer& msgContainer,
             const std::string& msg ) const {
 
+        const auto id = error_key_id( errorKey );
+        if( id != ErrorKey::COUNT )
+            return this->handleError( id, msgContainer, msg );
+
         InputError::Action action = get( errorKey );
 
         if (action == InputError::WARN) {
@@ -114,6 +165,35 @@ namespace Opm {
 
     }
 
+    Message::type ParseContext::handleError(
+            ErrorKey errorKey,
+            MessageContainer& msgContainer,
+            const std::string& msg,
+            const std::string& keyword,
+            const Location& location ) const {
+
+        InputError::Action action = get( errorKey );
+
+        if (action == InputError::WARN) {
+            msgContainer.add( Message( Message::Warning, msg, Location( location ) ),
+                              keyName( errorKey ), keyword );
+            return Message::Warning;
+        }
+
+        else if (action == InputError::THROW_EXCEPTION) {
+            msgContainer.add( Message( Message::Error, msg, Location( location ) ),
+                              keyName( errorKey ), keyword );
+            throw std::invalid_argument(keyName( errorKey ) + ": " + msg);
+        }
+
+        return Message::Debug;
+
+    }
+
+    const std::string& ParseContext::keyName( ErrorKey errorKey ) {
+        return error_key_name( errorKey );
+    }
+
     std::map<std::string,InputError::Action>::const_iterator ParseContext::begin() const {
         return m_errorContexts.begin();
     }
@@ -160,6 +240,18 @@ namespace Opm {
             throw std::invalid_argument("The errormode key: " + key + " has not been registered");
     }
 
+    InputError::Action ParseContext::get(ErrorKey key) const {
+        return this->m_actions.at( static_cast< size_t >( key ) );
+    }
+
+    void ParseContext::setMessageLimit( std::size_t limit ) {
+        this->m_messageLimit = limit;
+    }
+
+    std::size_t ParseContext::messageLimit() const {
+        return this->m_messageLimit;
+    }
+
     /*****************************************************************/
 
     /*
@@ -175,9 +267,13 @@ namespace Opm {
     */
 
     void ParseContext::updateKey(const std::string& key , InputError::Action action) {
-        if (hasKey(key))
+        if (hasKey(key)) {
             m_errorContexts[key] = action;
-        else
+
+            const auto id = error_key_id( key );
+            if( id != ErrorKey::COUNT )
+                this->m_actions[ static_cast< size_t >( id ) ] = action;
+        } else
             throw std::invalid_argument("The errormode key: " + key + " has not been registered");
     }
 
@@ -216,6 +216,7 @@ class ParserState {
 
         const boost::filesystem::path& current_path() const;
         size_t line() const;
+        Location location() const;
 
         bool done() const;
         string_view getline();
@@ -244,6 +245,11 @@ size_t ParserState::line() const {
     return this->input_stack.top().lineNR;
 }
 
+Location ParserState::location() const {
+    if( this->line() == 0 ) return {};
+    return { this->current_path().string(), this->line() };
+}
+
 bool ParserState::done() const {
 
     while( !this->input_stack.empty() &&
@@ -268,13 +274,16 @@ void ParserState::closeFile() {
 
 ParserState::ParserState(const ParseContext& __parseContext) :
     parseContext( __parseContext )
-{}
+{
+    this->deck.getMessageContainer().setMessageLimit( __parseContext.messageLimit() );
+}
 
 ParserState::ParserState( const ParseContext& context,
                           boost::filesystem::path p ) :
     rootPath( boost::filesystem::canonical( p ).parent_path() ),
     parseContext( context )
 {
+    this->deck.getMessageContainer().setMessageLimit( context.messageLimit() );
     openRootFile( p );
 }
 
@@ -289,7 +298,7 @@ void ParserState::loadFile(const boost::filesystem::path& inputFile) {
         inputFileCanonical = boost::filesystem::canonical(inputFile);
     } catch (boost::filesystem::filesystem_error fs_error) {
         std::string msg = "Could not open file: " + inputFile.string();
-        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
+        parseContext.handleError( ParseContext::ErrorKey::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
         return;
     }
 
@@ -302,7 +311,7 @@ void ParserState::loadFile(const boost::filesystem::path& inputFile) {
     // make sure the file we'd like to parse is readable
     if( !ufp ) {
         std::string msg = "Could not read from file: " + inputFile.string();
-        parseContext.handleError( ParseContext::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
+        parseContext.handleError( ParseContext::ErrorKey::PARSE_MISSING_INCLUDE , deck.getMessageContainer() , msg);
         return;
     }
 
@@ -333,23 +342,23 @@ void ParserState::loadFile(const boost::filesystem::path& inputFile) {
  */
 
 void ParserState::handleRandomText(const string_view& keywordString ) const {
-    std::string errorKey;
+    ParseContext::ErrorKey errorKey;
     std::stringstream msg;
     std::string trimmedCopy = keywordString.string();
 
     if (trimmedCopy == "/") {
-        errorKey = ParseContext::PARSE_RANDOM_SLASH;
+        errorKey = ParseContext::ErrorKey::PARSE_RANDOM_SLASH;
         msg << "Extra '/' detected at: "
             << this->current_path()
             << ":" << this->line();
     } else {
-        errorKey = ParseContext::PARSE_RANDOM_TEXT;
+        errorKey = ParseContext::ErrorKey::PARSE_RANDOM_TEXT;
         msg << "String \'" << keywordString
             << "\' not formatted/recognized as valid keyword at: "
             << this->current_path()
             << ":" << this->line();
     }
-    parseContext.handleError( errorKey , deck.getMessageContainer() , msg.str() );
+    parseContext.handleError( errorKey , deck.getMessageContainer() , msg.str(), "", this->location() );
 }
 
 void ParserState::openRootFile( const boost::filesystem::path& inputFile) {
@@ -399,7 +408,8 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
         if( ParserKeyword::validDeckName( keywordString ) ) {
             std::string msg = "Keyword " + keywordString + " not recognized.";
             auto& msgContainer = parserState.deck.getMessageContainer();
-            parserState.parseContext.handleError( ParseContext::PARSE_UNKNOWN_KEYWORD, msgContainer, msg );
+            parserState.parseContext.handleError( ParseContext::ErrorKey::PARSE_UNKNOWN_KEYWORD, msgContainer, msg,
+                                                  keywordString.string(), parserState.location() );
             parserState.unknown_keyword = true;
             return {};
         }
@@ -450,7 +460,8 @@ std::shared_ptr< RawKeyword > createRawKeyword( const string_view& kw, ParserSta
     std::string msg = "Expected the kewyord: " +keyword_size.keyword 
                     + " to infer the number of records in: " + keywordString;
     auto& msgContainer = parserState.deck.getMessageContainer();
-    parserState.parseContext.handleError(ParseContext::PARSE_MISSING_DIMS_KEYWORD , msgContainer, msg );
+    parserState.parseContext.handleError(ParseContext::ErrorKey::PARSE_MISSING_DIMS_KEYWORD , msgContainer, msg,
+                                         keywordString.string(), parserState.location() );
 
     const auto* keyword = parser.getKeyword( keyword_size.keyword );
     const auto& record = keyword->getRecord(0);
@@ -134,7 +134,11 @@ namespace {
             std::string msg = "The RawRecord for keyword \""  + rawRecord.getKeywordName() + "\" in file\"" + rawRecord.getFileName() + "\" contained " +
                 std::to_string(rawRecord.size()) +
                 " too many items according to the spec. RawRecord was: " + rawRecord.getRecordString();
-            parseContext.handleError(ParseContext::PARSE_EXTRA_DATA , msgContainer, msg);
+            /* The raw record does not know its line number, only the file. */
+            Location location;
+            location.filename = rawRecord.getFileName();
+            parseContext.handleError(ParseContext::ErrorKey::PARSE_EXTRA_DATA , msgContainer, msg,
+                                     rawRecord.getKeywordName(), location );
         }
 
         return { std::move( items ) };
@@ -18,6 +18,7 @@
 */
 
 #include <opm/parser/eclipse/Units/Dimension.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <string>
 #include <stdexcept>
@@ -95,6 +96,10 @@ namespace Opm {
     bool Dimension::operator!=( const Dimension& rhs ) const {
         return !(*this == rhs );
     }
+
+    size_t Dimension::memoryUsage() const {
+        return memory::heap( this->m_name );
+    }
 }
 
 
@@ -25,6 +25,7 @@
 #include <opm/parser/eclipse/Units/Dimension.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 #include <vector>
 #include <limits>
@@ -547,6 +548,10 @@ namespace {
         return *this == other;
     }
 
+    size_t UnitSystem::memoryUsage() const {
+        return memory::heap( this->m_name ) + memory::heap( this->m_dimensions );
+    }
+
     bool UnitSystem::operator==( const UnitSystem& rhs ) const {
         return this->m_name == rhs.m_name
             && this->m_unittype == rhs.m_unittype
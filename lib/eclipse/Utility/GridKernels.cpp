@@ -0,0 +1,46 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
+
+namespace Opm {
+namespace GridKernels {
+
+    static int configured_threads = 0;
+
+    void setThreads( int threads ) {
+        configured_threads = std::max( threads, 0 );
+    }
+
+    int threads() {
+        if( configured_threads > 0 ) return configured_threads;
+
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+}
+}
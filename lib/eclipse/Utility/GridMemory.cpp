@@ -0,0 +1,47 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+
+namespace Opm {
+namespace GridMemory {
+
+#ifdef MADV_HUGEPAGE
+    void adviseHugePages( void* data, size_t bytes ) {
+        const auto page = uintptr_t( sysconf( _SC_PAGESIZE ) );
+        const auto first = (uintptr_t( data ) + page - 1) / page * page;
+        const auto last = (uintptr_t( data ) + bytes) / page * page;
+
+        /* the advice is a hint only, a failure is not an error */
+        if( last > first )
+            madvise( reinterpret_cast< void* >( first ), last - first, MADV_HUGEPAGE );
+    }
+#else
+    void adviseHugePages( void*, size_t ) {}
+#endif
+
+}
+}
@@ -0,0 +1,75 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <iomanip>
+
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
+namespace Opm {
+
+    void MemoryUsage::add( const std::string& component, size_t bytes ) {
+        this->components[ component ] += bytes;
+    }
+
+    size_t MemoryUsage::total() const {
+        size_t sum = 0;
+        for( const auto& pair : this->components )
+            sum += pair.second;
+
+        return sum;
+    }
+
+    size_t MemoryUsage::get( const std::string& component ) const {
+        const auto iter = this->components.find( component );
+        if( iter == this->components.end() )
+            return 0;
+
+        return iter->second;
+    }
+
+    std::vector< std::pair< std::string, size_t > > MemoryUsage::sorted() const {
+        std::vector< std::pair< std::string, size_t > > list( this->components.begin(),
+                                                              this->components.end() );
+
+        std::stable_sort( list.begin(), list.end(),
+                          []( const std::pair< std::string, size_t >& a,
+                              const std::pair< std::string, size_t >& b ) {
+                              return a.second > b.second;
+                          } );
+
+        return list;
+    }
+
+    void MemoryUsage::report( std::ostream& os, size_t limit ) const {
+        const auto list = this->sorted();
+        const auto count = limit == 0 ? list.size() : std::min( limit, list.size() );
+
+        for( size_t index = 0; index < count; ++index )
+            os << std::setw( 16 ) << list[ index ].second << "  "
+               << list[ index ].first << std::endl;
+
+        if( count < list.size() )
+            os << std::setw( 16 ) << "..." << "  "
+               << list.size() - count << " smaller components" << std::endl;
+
+        os << std::setw( 16 ) << this->total() << "  Total" << std::endl;
+    }
+
+}
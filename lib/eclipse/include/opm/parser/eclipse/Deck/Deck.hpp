@@ -56,6 +56,7 @@ namespace Opm {
      * use-after-free.
      */
     class DeckOutput;
+    class MemoryUsage;
 
     class DeckView {
         public:
@@ -103,6 +104,7 @@ namespace Opm {
             explicit DeckView( std::pair< const_iterator, const_iterator > );
 
             void reinit( const_iterator, const_iterator );
+            size_t indexMemoryUsage() const;
 
         private:
             const_iterator first;
@@ -150,6 +152,15 @@ namespace Opm {
             iterator end();
             void write( DeckOutput& output ) const ;
             friend std::ostream& operator<<(std::ostream& os, const Deck& deck);
+
+            /*
+              Adds the memory of every keyword as "Deck/keywords/NAME",
+              summed over all occurences of the keyword, and the
+              bookkeeping of the deck itself as "Deck/index",
+              "Deck/messages" and "Deck/units".
+            */
+            void memoryUsage( MemoryUsage& usage ) const;
+            size_t memoryUsage() const;
         private:
             Deck( std::vector< DeckKeyword >&& );
 
@@ -0,0 +1,83 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECKDIFF_HPP
+#define DECKDIFF_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+    class Deck;
+
+    /*
+     * Structural difference between two decks. The keywords are aligned by
+     * (name, occurrence), i.e. the second EQUIL keyword in the first deck is
+     * compared with the second EQUIL keyword in the second deck, and within
+     * a keyword the records are aligned by index. The cached content hashes
+     * of the deck items rule out most of the unchanged data quickly, and
+     * matching hashes are confirmed by comparing the values. Values are
+     * compared exactly and the defaulted status of the items is not
+     * considered.
+     */
+
+    class DeckDiff {
+    public:
+        enum class Status {
+            added,
+            removed,
+            changed
+        };
+
+        struct KeywordDiff {
+            std::string name;
+            size_t occurrence;
+            Status status;
+
+            /*
+              Only filled in for changed keywords; the added records are
+              indices into the keyword of the second deck, and the
+              removed and changed records are indices into the keyword of
+              the first deck.
+            */
+            std::vector< size_t > added_records;
+            std::vector< size_t > removed_records;
+            std::vector< size_t > changed_records;
+        };
+
+        typedef std::vector< KeywordDiff >::const_iterator const_iterator;
+
+        DeckDiff( const Deck& first, const Deck& second );
+
+        bool empty() const;
+        size_t size() const;
+        const KeywordDiff& operator[]( size_t index ) const;
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        friend std::ostream& operator<<( std::ostream& os, const DeckDiff& diff );
+
+    private:
+        std::vector< KeywordDiff > keywords;
+    };
+}
+
+#endif  /* DECKDIFF_HPP */
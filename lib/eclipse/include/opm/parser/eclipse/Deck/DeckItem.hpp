@@ -20,6 +20,7 @@
 #ifndef DECKITEM_HPP
 #define DECKITEM_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -45,6 +46,11 @@ namespace Opm {
         // return true if the default value was used for a given data point
         bool defaultApplied( size_t ) const;
 
+        // return true if the default value was used for any data point;
+        // the defaulted values are counted as they are added, so bulk
+        // consumers can skip the per element defaultApplied() check.
+        bool hasDefaultedValues() const;
+
         // Return true if the item has a value for the current index;
         // does not differentiate between default values from the
         // config and values which have been set in the deck.
@@ -106,6 +112,23 @@ namespace Opm {
         bool operator==(const DeckItem& other) const;
         bool operator!=(const DeckItem& other) const;
 
+        /*
+          Content hash over the name, the type and the values of the
+          item; the defaulted status and dimensions are not included.
+          The hash is computed lazily, cached and invalidated when values
+          are added to the item. Two items which compare equal with
+          cmp_numeric == false will always have the same hash.
+
+          Like the SI data, the cache is filled without synchronisation:
+          hash() is not thread safe, and concurrent calls on the same
+          item, including through equal(), must be serialised by the
+          caller.
+        */
+        uint64_t hash() const;
+
+        /* Heap memory owned by the item, including container capacity. */
+        size_t memoryUsage() const;
+
     private:
         std::vector< double > dval;
         std::vector< int > ival;
@@ -115,15 +138,17 @@ namespace Opm {
 
         std::string item_name;
         std::vector< bool > defaulted;
+        size_t num_defaulted = 0;
         std::vector< Dimension > dimensions;
         mutable std::vector< double > SIdata;
+        mutable uint64_t content_hash = 0;
+        mutable bool hash_valid = false;
 
         template< typename T > std::vector< T >& value_ref();
         template< typename T > const std::vector< T >& value_ref() const;
         template< typename T > void push( T );
         template< typename T > void push( T, size_t );
         template< typename T > void push_default( T );
-        template< typename T > void write_vector(DeckOutput& writer, const std::vector<T>& data) const;
     };
 }
 #endif  /* DECKITEM_HPP */
@@ -20,6 +20,7 @@
 #ifndef DECKKEYWORD_HPP
 #define DECKKEYWORD_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -76,6 +77,13 @@ namespace Opm {
         bool operator==(const DeckKeyword& other) const;
         bool operator!=(const DeckKeyword& other) const;
 
+        /*
+          Content hash of the keyword name and all the records; location
+          and the fixed size/slash terminated status are not included.
+        */
+        uint64_t hash() const;
+        size_t memoryUsage() const;
+
         friend std::ostream& operator<<(std::ostream& os, const DeckKeyword& keyword);
     private:
         std::string m_keywordName;
@@ -22,14 +22,27 @@
 
 #include <ostream>
 #include <string>
+#include <vector>
 #include <cstddef>
 
 namespace Opm {
 
+    /*
+      The DeckOutput class formats values into an internal buffer which
+      is flushed to the underlying stream when it grows large, at the
+      end of keywords and decks, by flush() and when the DeckOutput
+      instance goes out of scope. Floating point values are written
+      with the shortest representation which will parse back to the
+      identical value, including the sign of zero, and the formatting
+      does not depend on the locale.
+    */
+
     class DeckOutput {
     public:
         explicit DeckOutput(std::ostream& s);
+        ~DeckOutput();
         void stash_default( );
+        void stash_default( size_t count );
 
         void start_record( );
         void end_record( );
@@ -42,17 +55,39 @@ namespace Opm {
         void write_string(const std::string& s);
         template <typename T> void write(const T& value);
 
+        /*
+          Will write the value 'count' times; for numerical values a
+          run is written in the compressed form 'count*value'.
+        */
+        template <typename T> void write(const T& value, size_t count);
+
+        /*
+          Write all the values of an item; runs of equal numerical values
+          are written as 'N*value' and runs of defaulted values as
+          'N*'. When threads > 1 large items are formatted in chunks of
+          whole output lines in parallel, the result is identical to the
+          serial output.
+        */
+        template <typename T> void write_data(const std::vector<T>& data, const std::vector<bool>& defaulted);
+        void flush();
+
         std::string item_sep = " ";        // Separator between items on a row.
         size_t      columns = 16;          // The maximum number of columns on a record.
         std::string record_indent = "   "; // The indentation when starting a new line.
         std::string keyword_sep = "\n\n";  // The separation between keywords;
+        size_t      threads = 1;           // The number of threads used to format large items.
     private:
         std::ostream& os;
+        std::string buffer;
         size_t default_count;
         size_t row_count;
         bool record_on;
 
         template <typename T> void write_value(const T& value);
+        template <typename T> void write_parallel(const std::vector<T>& data, const std::vector<bool>& defaulted);
+        size_t row_count_after(size_t tokens) const;
+        void write_count(size_t count);
+        void write_defaults( );
         void write_sep( );
     };
 }
@@ -20,6 +20,7 @@
 #ifndef DECKRECORD_HPP
 #define DECKRECORD_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -70,6 +71,13 @@ namespace Opm {
         bool operator==(const DeckRecord& other) const;
         bool operator!=(const DeckRecord& other) const;
 
+        /*
+          Combination of the item hashes; the items cache their own
+          hashes, so this is cheap also for large data records.
+        */
+        uint64_t hash() const;
+        size_t memoryUsage() const;
+
     private:
         std::vector< DeckItem > m_items;
 
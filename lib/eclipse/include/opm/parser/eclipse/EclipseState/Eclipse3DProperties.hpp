@@ -19,6 +19,7 @@
 #ifndef OPM_ECLIPSE_PROPERTIES_HPP
 #define OPM_ECLIPSE_PROPERTIES_HPP
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -39,6 +40,7 @@ namespace Opm {
     class DeckKeyword;
     class DeckRecord;
     class EclipseGrid;
+    class MemoryUsage;
     class Section;
     class TableManager;
     class UnitSystem;
@@ -67,8 +69,51 @@ namespace Opm {
         bool hasDeckDoubleGridProperty(const std::string& keyword) const;
         bool supportsGridProperty(const std::string& keyword) const;
         MessageContainer getMessageContainer();
+        void memoryUsage( MemoryUsage& usage ) const;
+
+        /*
+          Evaluate the pending post processors of all the properties,
+          and create the listed keywords, as the get*GridProperty()
+          calls would; the results are identical. The properties are
+          the nodes of a graph whose edges are the dependencies of their
+          keywords, see GridPropertySupportedKeywordInfo, and the nodes
+          of a level - those whose dependencies are all in the levels
+          before - are evaluated concurrently on GridKernels::threads()
+          threads.
+
+          Missing dependencies without a post processor are created
+          first. A node with a missing dependency which has a post
+          processor - ACTNUM before PORV exists - is evaluated lazily,
+          serially, after the levels, since lazy evaluation may decide
+          not to create the dependency at all. Everything not finalized
+          is still evaluated lazily on first access.
+        */
+        void finalize( const std::vector< std::string >& keywords = {} );
+
+        /*
+          Switch all the properties except ACTNUM to active cell storage,
+          see GridProperty::compress(). The properties are finalized
+          first, and all the properties share one copy of the global
+          map of the grid, which must have its final ACTNUM.
+        */
+        void compress( const EclipseGrid& eclipseGrid );
 
     private:
+        /*
+          The pending EQUALS, ADD, MULTIPLY and COPY records of a
+          section; they are applied in fused sweeps when the run of such
+          records ends, or before a record creates a property.
+        */
+        struct SectionEdits {
+            GridPropertyEdits<int> intEdits;
+            GridPropertyEdits<double> doubleEdits;
+
+            void apply() {
+                intEdits.apply();
+                doubleEdits.apply();
+            }
+        };
+
         const GridProperty<int>& getRegion(const DeckItem& regionItem) const;
         void processGridProperties(const Deck& deck,
                                    const EclipseGrid& eclipseGrid);
@@ -76,12 +121,12 @@ namespace Opm {
         void scanSection(const Section& section,
                          const EclipseGrid& eclipseGrid);
 
-        void handleADDKeyword(     const DeckKeyword& deckKeyword, BoxManager& boxManager);
+        void handleADDKeyword(     const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits);
         void handleBOXKeyword(     const DeckKeyword& deckKeyword, BoxManager& boxManager);
-        void handleCOPYKeyword(    const DeckKeyword& deckKeyword, BoxManager& boxManager);
+        void handleCOPYKeyword(    const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits);
         void handleENDBOXKeyword(  BoxManager& boxManager);
-        void handleEQUALSKeyword(  const DeckKeyword& deckKeyword, BoxManager& boxManager);
-        void handleMULTIPLYKeyword(const DeckKeyword& deckKeyword, BoxManager& boxManager);
+        void handleEQUALSKeyword(  const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits);
+        void handleMULTIPLYKeyword(const DeckKeyword& deckKeyword, BoxManager& boxManager, SectionEdits& edits);
 
         void handleADDREGKeyword(  const DeckKeyword& deckKeyword );
         void handleCOPYREGKeyword( const DeckKeyword& deckKeyword );
@@ -98,6 +143,7 @@ namespace Opm {
         UnitSystem             m_deckUnitSystem;
         GridProperties<int>    m_intGridProperties;
         GridProperties<double> m_doubleGridProperties;
+        std::shared_ptr< const std::vector< int > > m_globalMap;
     };
 }
 
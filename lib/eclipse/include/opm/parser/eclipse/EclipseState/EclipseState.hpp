@@ -55,6 +55,7 @@ namespace Opm {
     class SimulationConfig;
     class TableManager;
     class UnitSystem;
+    class MemoryUsage;
 
     class EclipseState {
     public:
@@ -104,8 +105,21 @@ namespace Opm {
 
         void applyModifierDeck(const Deck& deck);
 
+        /*
+          Store the 3D properties for the active cells only; see
+          Eclipse3DProperties::compress(). Opt in, for the simulators
+          which only read the active cells once the state is set up.
+        */
+        void compressProperties();
+
         const Runspec& runspec() const;
 
+        /*
+          Adds the grid, the 3D properties, the tables, the NNCs and the
+          messages; see MemoryUsage for the component names.
+        */
+        void memoryUsage( MemoryUsage& usage ) const;
+
     private:
         void initIOConfigPostSchedule(const Deck& deck);
         void initTransMult();
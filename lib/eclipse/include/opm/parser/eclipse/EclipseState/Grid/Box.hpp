@@ -21,36 +21,145 @@
 #ifndef BOX_HPP_
 #define BOX_HPP_
 
-#include <vector>
 #include <cstddef>
+#include <iterator>
+#include <vector>
 
 namespace Opm {
 
+    /*
+      A Box is a logically cartesian sub volume of the grid. The cells of
+      the box are visited in the natural order, i fastest and k slowest,
+      without materializing the list of global indices:
+
+        - The iterators yield the global index of each cell in turn.
+
+        - forEachRun() exposes the cells as runs of consecutive global
+          indices, i.e. one run for each i-row of the box. Rows spanning
+          the full width of the grid are merged with the following rows,
+          so a box covering whole layers - in particular the global box -
+          is visited as one single run.
+    */
+
     class Box {
     public:
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const size_t*;
+            using reference = const size_t&;
+
+            const_iterator() = default;
+            const_iterator( const Box* box, size_t k );
+
+            const size_t& operator*() const { return this->m_global; }
+            const_iterator& operator++();
+            const_iterator operator++( int );
+            bool operator==( const const_iterator& other ) const;
+            bool operator!=( const const_iterator& other ) const;
+
+        private:
+            void update();
+
+            const Box* m_box = nullptr;
+            size_t m_ijk[3] = { 0, 0, 0 };
+            size_t m_global = 0;
+        };
+
         Box() = default;
         Box(int nx , int ny , int nz);
         Box(const Box& globalBox , int i1 , int i2 , int j1 , int j2 , int k1 , int k2); // Zero offset coordinates.
         size_t size() const;
         bool   isGlobal() const;
         size_t getDim(size_t idim) const;
-        const std::vector<size_t>& getIndexList() const;
+        size_t getOffset(size_t idim) const;
         bool equal(const Box& other) const;
 
+        /*
+          The global indices of all the cells in the box. The list is
+          created on the first call and kept for the lifetime of the box;
+          it is only retained for compatibility, use the iterators or
+          forEachRun() instead.
+        */
+        const std::vector<size_t>& getIndexList() const;
+
         explicit operator bool() const;
-        std::vector<size_t>::const_iterator begin() const;
-        std::vector<size_t>::const_iterator end() const;
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        /*
+          Call f( global_start, box_offset, length ) for each run of
+          consecutive global indices, in the natural order. box_offset is
+          the position of the first cell of the run in the box, i.e. the
+          index into input data given for the box.
+        */
+        template< typename F >
+        void forEachRun( F f ) const;
+
+        /*
+          As forEachRun(), but only the runs in layer k of the grid; rows
+          spanning the full width of the grid are merged within the layer.
+          Nothing is visited if the box does not cover layer k.
+        */
+        template< typename F >
+        void forEachRunInLayer( size_t k, F f ) const;
 
     private:
-        void initIndexList();
         static void assertDims(const Box& globalBox, size_t idim , int l1 , int l2);
         size_t m_dims[3] = { 0, 0, 0 };
-        size_t m_offset[3];
-        size_t m_stride[3];
+        size_t m_offset[3] = { 0, 0, 0 };
+        size_t m_stride[3] = { 0, 0, 0 };
 
-        bool   m_isGlobal;
-        std::vector<size_t> m_indexList;
+        bool   m_isGlobal = false;
+        mutable std::vector<size_t> m_indexList;
     };
+
+    template< typename F >
+    void Box::forEachRun( F f ) const {
+        if( this->size() == 0 ) return;
+
+        /* the number of box dimensions folded into one run */
+        size_t folded = 1;
+        size_t length = this->m_dims[0];
+        while( folded < 3 && length == this->m_stride[ folded ] ) {
+            length *= this->m_dims[ folded ];
+            folded++;
+        }
+
+        const size_t nj = folded > 1 ? 1 : this->m_dims[1];
+        const size_t nk = folded > 2 ? 1 : this->m_dims[2];
+
+        size_t box_offset = 0;
+        for( size_t k = 0; k < nk; k++ ) {
+            for( size_t j = 0; j < nj; j++ ) {
+                const size_t start = this->m_offset[0] * this->m_stride[0]
+                                   + ( this->m_offset[1] + j ) * this->m_stride[1]
+                                   + ( this->m_offset[2] + k ) * this->m_stride[2];
+                f( start, box_offset, length );
+                box_offset += length;
+            }
+        }
+    }
+
+    template< typename F >
+    void Box::forEachRunInLayer( size_t k, F f ) const {
+        if( k < this->m_offset[2] || k >= this->m_offset[2] + this->m_dims[2] ) return;
+
+        const bool full_rows = this->m_dims[0] == this->m_stride[1];
+        const size_t length = full_rows ? this->m_dims[0] * this->m_dims[1] : this->m_dims[0];
+        const size_t rows = full_rows ? 1 : this->m_dims[1];
+
+        size_t box_offset = ( k - this->m_offset[2] ) * this->m_dims[0] * this->m_dims[1];
+        for( size_t j = 0; j < rows; j++ ) {
+            const size_t start = this->m_offset[0] * this->m_stride[0]
+                               + ( this->m_offset[1] + j ) * this->m_stride[1]
+                               + k * this->m_stride[2];
+            f( start, box_offset, length );
+            box_offset += length;
+        }
+    }
 }
 
 
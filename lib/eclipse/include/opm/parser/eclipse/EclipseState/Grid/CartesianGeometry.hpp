@@ -0,0 +1,124 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CARTESIAN_GEOMETRY_HPP
+#define OPM_CARTESIAN_GEOMETRY_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <ert/ecl/ecl_grid.h>
+
+namespace Opm {
+
+    /*
+      The CartesianGeometry class is an implicit representation of a
+      grid where every cell is an axis aligned box, i.e. the grids
+      created from DX/DY/DZ/TOPS or DXV/DYV/DZV/TOPS. Instead of
+      COORD and ZCORN only the cell sizes and the cell tops are
+      stored:
+
+        dx:   nx values (DXV) or nx*ny*nz values (DX)
+        dy:   ny values (DYV) or nx*ny*nz values (DY)
+        dz:   nz values (DZV) or nx*ny*nz values (DZ)
+        tops: nx*ny*nz values, or nx*ny values for the top layer if
+              dz has nz values; the lower layers are then stacked
+              directly below the top layer.
+
+      The cells are laid out as in ERT ecl_grid_alloc_dx_dy_dz_tops():
+      the x coordinate of cell (i,j,k) is the sum of dx over the cells
+      (0..i-1,j,k) and the y coordinate is the sum of dy over the cells
+      (i,0..j-1,k).
+    */
+
+    class CartesianGeometry {
+    public:
+        CartesianGeometry( size_t nx, size_t ny, size_t nz,
+                           std::vector< double > dx,
+                           std::vector< double > dy,
+                           std::vector< double > dz,
+                           std::vector< double > tops );
+
+        size_t getNX() const;
+        size_t getNY() const;
+        size_t getNZ() const;
+
+        double dx( size_t i, size_t j, size_t k ) const;
+        double dy( size_t i, size_t j, size_t k ) const;
+        double dz( size_t i, size_t j, size_t k ) const;
+        double top( size_t i, size_t j, size_t k ) const;
+
+        /* Corner numbering as in EclipseGrid::getCornerPos(). */
+        std::array< double, 3 > getCornerPos( size_t i, size_t j, size_t k, size_t corner ) const;
+
+        /*
+          The cell volume and the cell center, computed directly from the
+          cell sizes; the values are the same as in GridGeometry.
+        */
+        double volume( size_t i, size_t j, size_t k ) const;
+        std::array< double, 3 > center( size_t i, size_t j, size_t k ) const;
+
+        void exportCOORD( std::vector< double >& coord ) const;
+        void exportZCORN( std::vector< double >& zcorn ) const;
+
+        /*
+          Creates the equivalent ERT grid; actnum can be nullptr for
+          all cells active.
+        */
+        ecl_grid_type* alloc_ecl_grid( const int* actnum ) const;
+
+        size_t memoryUsage() const;
+
+    private:
+        /*
+          The x and y coordinates of the low corner of every cell, for
+          cellwise dx and dy respectively; an empty vector for axis
+          compressed values, which use m_xv and m_yv instead.
+        */
+        struct CellOffsets {
+            std::vector< double > x;
+            std::vector< double > y;
+        };
+
+        size_t globalIndex( size_t i, size_t j, size_t k ) const;
+        std::array< double, 2 > origin( size_t i, size_t j, size_t k ) const;
+        const CellOffsets& cellOffsets() const;
+        std::vector< double > expand( const std::vector< double >& v, size_t dim ) const;
+        std::vector< double > expandTops() const;
+        void pillarOffsets( size_t k, std::vector< double >& x, std::vector< double >& y ) const;
+
+        size_t nx, ny, nz;
+        std::vector< double > m_dx;
+        std::vector< double > m_dy;
+        std::vector< double > m_dz;
+        std::vector< double > m_tops;
+
+        /* Offsets for axis compressed dx, dy and dz: nx + 1, ny + 1 and nz + 1 values. */
+        std::vector< double > m_xv;
+        std::vector< double > m_yv;
+        std::vector< double > m_zv;
+
+        /* Built on first use, and shared by the copies of the geometry. */
+        mutable std::shared_ptr< const CellOffsets > m_offsets;
+    };
+}
+
+#endif
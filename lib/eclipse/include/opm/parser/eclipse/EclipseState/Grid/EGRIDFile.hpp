@@ -0,0 +1,91 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_EGRID_FILE_HPP
+#define OPM_EGRID_FILE_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+    /*
+      Reader for the main grid of an unformatted, big-endian EGRID
+      file. The file is memory mapped - or read into memory where mmap()
+      is not available - and the keywords up to the first ENDGRID are
+      indexed when the file is opened; the data of a keyword is only
+      converted when it is requested.
+
+      Each keyword is stored as a header record with the eight character
+      name, the number of elements and the four character type, followed
+      by the data in records of at most 1000 elements (105 for CHAR).
+      Every record is enclosed in Fortran record markers, i.e. the byte
+      size of the record as a 32 bit integer before and after the data.
+    */
+
+    class EGRIDFile {
+    public:
+        explicit EGRIDFile( const std::string& filename );
+        ~EGRIDFile();
+
+        EGRIDFile( const EGRIDFile& ) = delete;
+        EGRIDFile& operator=( const EGRIDFile& ) = delete;
+
+        /*
+          Checks, without indexing the file, if the file starts with an
+          unformatted FILEHEAD keyword.
+        */
+        static bool isEGRID( const std::string& filename );
+
+        bool hasKeyword( const std::string& keyword ) const;
+        size_t size( const std::string& keyword ) const;
+
+        /* INTE and LOGI keywords. */
+        std::vector< int > getIntData( const std::string& keyword ) const;
+        /* REAL and DOUB keywords. */
+        std::vector< double > getDoubleData( const std::string& keyword ) const;
+
+        /* Keywords after the main grid, i.e. there are LGRs */
+        bool hasLGR() const;
+
+    private:
+        struct Entry {
+            std::string type;
+            size_t count;
+            size_t offset;
+        };
+
+        const Entry& entry( const std::string& keyword ) const;
+        template< typename Convert >
+        void readBlocks( const Entry& entry, size_t element_size, Convert convert ) const;
+        void release();
+
+        std::string m_filename;
+        const unsigned char* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_mapped = false;
+        std::vector< unsigned char > m_buffer;
+        std::map< std::string, Entry > m_keywords;
+        bool m_lgr = false;
+    };
+}
+
+#endif
@@ -28,19 +28,35 @@
 #include <opm/parser/eclipse/EclipseState/Grid/GridDims.hpp>
 
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
 
 #include <ert/ecl/ecl_grid.h>
-#include <ert/util/ert_unique_ptr.hpp>
 
 #include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Opm {
 
+    class CartesianGeometry;
     class Deck;
+    class GridGeometry;
+    class MemoryUsage;
     class ZcornMapper;
 
+    /*
+      A vertical connection between two active cells in the same column
+      which are not neighbours; cell1 is the upper cell. See
+      EclipseGrid::processPinch().
+    */
+    struct PinchNNC {
+        size_t cell1;
+        size_t cell2;
+        double multz;
+    };
+
     /**
        About cell information and dimension: The actual grid
        information is held in a pointer to an ERT ecl_grid_type
@@ -50,6 +66,13 @@ namespace Opm {
          - Size of cells
          - Real world position of cells
          - Active/inactive status of cells
+
+       The exception is grids where all cells are boxes - i.e. grids
+       created from DX/DY/DZ/TOPS or with the (nx,ny,nz,dx,dy,dz)
+       constructor. These grids keep only the cell sizes in a
+       CartesianGeometry instance, and compute the cell properties
+       from those; the ERT grid is first created when c_ptr() is
+       called.
     */
 
     class EclipseGrid : public GridDims {
@@ -107,10 +130,50 @@ namespace Opm {
         double getPinchThresholdThickness( ) const;
         PinchMode::ModeEnum getPinchOption( ) const;
         PinchMode::ModeEnum getMultzOption( ) const;
+        PinchMode::ModeEnum getPinchGapMode( ) const;
+        double getPinchMaxEmptyGap( ) const;
 
         MinpvMode::ModeEnum getMinpvMode() const;
         double getMinpvValue( ) const;
 
+        /*
+          Applies MINPV and PINCH to the current ACTNUM, and returns the
+          vertical connections between active cells which are separated
+          by pinched out or inactive layers, sorted on (cell1, cell2).
+          The porv and multz vectors have one value per cell in the
+          cartesian grid; an empty multz is treated as all ones.
+
+          The columns are processed in parallel, walking down from the
+          top layer:
+
+            - Cells with pore volume below MINPV are deactivated.
+
+            - With PINCH, active cells thinner than the threshold
+              thickness are deactivated; they and the MINPV cells are
+              pinched out. Two active cells separated only by pinched
+              out cells are connected. With the GAP option the cells
+              may also be separated by cells which are inactive in the
+              input, as long as the total thickness of those is less
+              than the max empty gap; with NOGAP they are not
+              connected, whatever the thickness of the inactive cells.
+
+            - With MINPVFIL, cells separated only by cells removed by
+              MINPV are connected also without PINCH.
+
+          The multz value of a connection is the MULTZ of the upper cell
+          with the MULTZ option TOP, and the minimum MULTZ of the upper
+          cell and the cells in between with the option ALL. The PINCH
+          pinchout option, TOPBOT or ALL, only affects how the
+          transmissibility is computed, and is left to the caller.
+
+          The columns are distributed over GridKernels::threads()
+          threads. EclipseState does not call processPinch(); the active
+          cells of the state are those of the input, and the simulator
+          decides when to apply MINPV and PINCH.
+        */
+        std::vector< PinchNNC > processPinch( const std::vector<double>& porv,
+                                              const std::vector<double>& multz = {} );
+
 
         /*
           Will return a vector of nactive elements. The method will
@@ -135,19 +198,74 @@ namespace Opm {
 
             {
                 std::vector<T> compressed_vector( this->getNumActive() );
-                const auto& active_map = this->getActiveMap( );
-
-                for (size_t i = 0; i < this->getNumActive(); ++i)
-                    compressed_vector[i] = input_vector[ active_map[i] ];
-
+                gatherActive( input_vector.data(), compressed_vector.data() );
                 return compressed_vector;
             }
         }
 
+        /*
+          The inverse of compressedVector(): will return a vector of
+          nx*ny*nz elements where the active cells are taken from the
+          input vector of nactive elements, and the inactive cells are
+          set to default_value.
+        */
+        template<typename T>
+        std::vector<T> expandedVector(const std::vector<T>& input_vector, const T& default_value) const {
+            if (input_vector.size() != this->getNumActive())
+                throw std::invalid_argument("Input vector must have nactive elements");
+
+            std::vector<T> expanded_vector( this->getCartesianSize(), default_value );
+            scatterActive( input_vector.data(), expanded_vector.data() );
+            return expanded_vector;
+        }
+
+        /*
+          Raw gather and scatter between a global array of nx*ny*nz
+          elements and an active array of nactive elements:
+
+             gatherActive:  active[a] = global[ getActiveMap()[a] ]
+             scatterActive: global[ getActiveMap()[a] ] = active[a]
+
+          The inactive elements of the global array are not touched by
+          scatterActive().
+        */
+        template<typename T>
+        void gatherActive(const T* global, T* active) const {
+            const int* active_map = this->m_activeMap.data();
+            const int num_active = static_cast<int>( this->m_activeMap.size() );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(GridKernels::threads()) if(num_active > 100000)
+#endif
+            for (int a = 0; a < num_active; ++a)
+                active[a] = global[ active_map[a] ];
+        }
+
+        template<typename T>
+        void scatterActive(const T* active, T* global) const {
+            const int* active_map = this->m_activeMap.data();
+            const int num_active = static_cast<int>( this->m_activeMap.size() );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(GridKernels::threads()) if(num_active > 100000)
+#endif
+            for (int a = 0; a < num_active; ++a)
+                global[ active_map[a] ] = active[a];
+        }
+
 
-        /// Will return a vector a length num_active; where the value
-        /// of each element is the corresponding global index.
+        /*
+          The index maps between global and active cells are computed
+          from ACTNUM in one pass when the grid is created, and again
+          when resetACTNUM() is called; they can be used concurrently
+          from several threads.
+
+            getActiveMap(): nactive elements, the global index of each
+                active cell.
+
+            getGlobalMap(): nx*ny*nz elements, the active index of each
+                cell, or -1 for inactive cells.
+        */
         const std::vector<int>& getActiveMap() const;
+        const std::vector<int>& getGlobalMap() const;
         std::array<double, 3> getCellCenter(size_t i,size_t j, size_t k) const;
         std::array<double, 3> getCellCenter(size_t globalIndex) const;
         std::array<double, 3> getCornerPos(size_t i,size_t j, size_t k, size_t corner_index) const;
@@ -163,6 +281,22 @@ namespace Opm {
         double getCellDepth(size_t globalIndex) const;
         ZcornMapper zcornMapper() const;
 
+        /*
+          Cell geometry for all cells, indexed with global index. The
+          geometry is computed for the complete grid in one pass the
+          first time one of these methods is called, and is cached from
+          then on; the per cell getters getCellVolume(), getCellCenter(),
+          getCellDepth(), getCellThicknes() and getCellDims() will use
+          the cached values when they are available. The geometry does
+          not depend on ACTNUM, so resetACTNUM() keeps the cache.
+
+          The methods can be called concurrently from several threads.
+        */
+        const GridGeometry& getGeometry() const;
+        const std::vector<double>& getCellVolumes() const;
+        const std::vector<double>& getCellDepths() const;
+        const std::vector<double>& getCellThicknesses() const;
+
         /*
           The exportZCORN method will adjust the z coordinates to ensure that cells do not
           overlap. The return value is the number of points which have been adjusted.
@@ -176,8 +310,34 @@ namespace Opm {
         void resetACTNUM( const int * actnum);
         bool equal(const EclipseGrid& other) const;
         const ecl_grid_type * c_ptr() const;
+
+        /*
+          The ERT grid with the cell geometry. Copies of a grid which
+          only differ in ACTNUM share this ERT grid, so its ACTNUM can
+          differ from the ACTNUM of this grid; c_ptr() returns an ERT
+          grid with the right ACTNUM, creating it if necessary.
+        */
+        const ecl_grid_type * c_geometry_ptr() const;
+
+        /*
+          The implicit geometry of a grid of box cells, or nullptr if
+          the grid is a general corner point grid.
+        */
+        const CartesianGeometry* getCartesianGeometry() const;
         const MessageContainer& getMessageContainer() const;
         MessageContainer& getMessageContainer();
+
+        /*
+          Adds "EclipseGrid" for the memory owned directly by this
+          object, and "EclipseGrid/ert" for the ERT grids. The ERT grid
+          does not expose its memory consumption, so the latter is an
+          estimate based on the size of the libecl cell structure. The
+          cached cell geometry, if it has been built, is added as
+          "EclipseGrid/geometry". The ERT grid and the cached geometry
+          can be shared with copies of the grid, and are then counted
+          by each of them.
+        */
+        void memoryUsage( MemoryUsage& usage ) const;
     private:
         MessageContainer m_messages;
 
@@ -186,25 +346,74 @@ namespace Opm {
         Value<double> m_pinch;
         PinchMode::ModeEnum m_pinchoutMode;
         PinchMode::ModeEnum m_multzMode;
-        mutable std::vector< int > activeMap;
+        PinchMode::ModeEnum m_pinchGapMode = PinchMode::ModeEnum::GAP;
+        double m_pinchMaxEmptyGap = 1e20;
+        std::vector< int > m_activeMap;
+        std::vector< int > m_globalMap;
         bool m_circle = false;
 
         /*
-          The internal class grid_ptr is a a std::unique_ptr with
-          special copy semantics. The purpose of implementing this is
-          that the EclipseGrid class can now use the default
-          implementation for the copy and move constructors.
+          The ert_grid class holds the ERT grid. The base grid, with the
+          cell geometry, is immutable and shared between copies of the
+          EclipseGrid, so grids which only differ in ACTNUM reference the
+          same geometry. The ACTNUM of each EclipseGrid is in its index
+          maps, and the ERT grid returned by c_ptr() is the base grid as
+          long as that has the same ACTNUM; otherwise a copy of the base
+          with the right ACTNUM is created the first time it is
+          requested. For grids with an implicit geometry there is no
+          base grid, and the ERT grid is created from the
+          CartesianGeometry when it is requested. The grids can be
+          requested from several threads at once.
+        */
+        class ert_grid {
+        public:
+            ert_grid() = default;
+            ert_grid(const ert_grid& src);
+
+            /* The ERT grid with the ACTNUM of the EclipseGrid, or nullptr if it has not been created. */
+            ecl_grid_type * get() const;
+            const ecl_grid_type * get(const EclipseGrid& grid) const;
+            /* The base grid if there is one; the ACTNUM can differ from the EclipseGrid. */
+            const ecl_grid_type * geometry(const EclipseGrid& grid) const;
+            void reset(ecl_grid_type * grid);
+            void resetACTNUM(const int * actnum);
+            /* The number of distinct ERT grids held. */
+            size_t count() const;
+        private:
+            mutable std::mutex m_mutex;
+            std::shared_ptr<ecl_grid_type> m_base;
+            mutable std::shared_ptr<ecl_grid_type> m_view;
+            mutable std::atomic<ecl_grid_type*> m_ptr{ nullptr };
+        };
+        ert_grid m_grid;
+        std::shared_ptr<const CartesianGeometry> m_cartesian;
+
+        /*
+          The geometry_cache holds the lazily computed GridGeometry. The
+          geometry is immutable once built, and copies of the cache share
+          the slot it is built in - also if the copy is made before the
+          geometry is built.
         */
-        using ert_ptr = ERT::ert_unique_ptr<ecl_grid_type , ecl_grid_free>;
-        class grid_ptr : public ert_ptr {
+        class geometry_cache {
         public:
-            using ert_ptr::unique_ptr;
-            grid_ptr() = default;
-            grid_ptr(grid_ptr&&) = default;
-            grid_ptr(const grid_ptr& src) :
-                ert_ptr( ecl_grid_alloc_copy( src.get() ) ) {}
+            geometry_cache();
+
+            const GridGeometry* get() const;
+            const GridGeometry& build(const EclipseGrid& grid) const;
+        private:
+            struct slot {
+                std::mutex mutex;
+                std::shared_ptr<const GridGeometry> geometry;
+                std::atomic<const GridGeometry*> ptr{ nullptr };
+            };
+            std::shared_ptr<slot> m_slot;
         };
-        grid_ptr m_grid;
+        geometry_cache m_geometry;
+
+        void initIndexMaps();
+        void initIndexMaps(const int * actnum);
+        const GridGeometry* cachedGeometry() const;
+        std::array<size_t, 3> cellIJK(size_t globalIndex) const;
 
         void initCornerPointGrid(const std::array<int,3>& dims ,
                                  const std::vector<double>& coord ,
@@ -227,6 +436,8 @@ namespace Opm {
                 const Deck&);
         static std::vector<double> createDVector(const std::array<int, 3>& dims, size_t dim, const std::string& DKey,
                 const std::string& DVKey, const Deck&);
+        static std::vector<double> createCompressedDVector(const std::array<int, 3>& dims, size_t dim, const std::string& DKey,
+                const std::string& DVKey, const Deck&);
         static void scatterDim(const std::array<int, 3>& dims , size_t dim , const std::vector<double>& DV , std::vector<double>& D);
    };
 
@@ -274,6 +485,11 @@ namespace Opm {
         size_t fixupZCORN( std::vector<double>& zcorn);
         bool validZCORN( const std::vector<double>& zcorn) const;
     private:
+        size_t unchecked_index(size_t i, size_t j, size_t k, int c) const {
+            return i*stride[0] + j*stride[1] + k*stride[2] + cell_shift[c];
+        }
+        int sign( const std::vector<double>& zcorn ) const;
+
         std::array<size_t,3> dims;
         std::array<size_t,3> stride;
         std::array<size_t,8> cell_shift;
@@ -0,0 +1,113 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRID_GEOMETRY_HPP
+#define OPM_GRID_GEOMETRY_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+    class CartesianGeometry;
+    class EclipseGrid;
+    class GridDims;
+
+    /*
+      The GridGeometry class computes the cell geometry of a corner point
+      grid in bulk, directly from the COORD and ZCORN arrays, instead of
+      asking the ERT grid one cell at a time. The cells [first, last) are
+      evaluated - the default is the complete grid - and the results are
+      stored in contiguous arrays, i.e. volume()[n] is the volume of the
+      cell with global index first + n.
+
+      The cell quantities are defined as:
+
+        volume:     sum of six tetrahedra sharing the 0-7 diagonal. The
+                    value is exact for cells with planar faces; for a
+                    warped cell it depends on the choice of diagonal.
+        center:     mean of the eight corner points.
+        depth:      z coordinate of the center.
+        thickness:  mean of the four pillar-wise distances bottom - top.
+        dx, dy:     mean length of the four cell edges in the i (j)
+                    direction, measured in the xy plane.
+
+      The x and y coordinates are in the COORD coordinate system,
+      i.e. MAPAXES is not applied.
+
+      For grids with an implicit CartesianGeometry the cells are boxes,
+      and the geometry is computed analytically from the cell sizes.
+
+      The tests compare the values with analytic values for sheared and
+      warped cells, and with the per-cell getters of the ERT library in
+      the build; other ERT/libecl versions have not been compared.
+
+      The EclipseGrid constructors export the complete COORD and ZCORN
+      arrays of the grid, also when only a span of cells is evaluated.
+    */
+
+    class GridGeometry {
+    public:
+        GridGeometry( const GridDims& dims,
+                      const std::vector< double >& coord,
+                      const std::vector< double >& zcorn );
+
+        GridGeometry( const GridDims& dims,
+                      const std::vector< double >& coord,
+                      const std::vector< double >& zcorn,
+                      size_t first, size_t last );
+
+        explicit GridGeometry( const EclipseGrid& grid );
+        GridGeometry( const EclipseGrid& grid, size_t first, size_t last );
+
+        explicit GridGeometry( const CartesianGeometry& geometry );
+        GridGeometry( const CartesianGeometry& geometry, size_t first, size_t last );
+
+        size_t size() const;
+        size_t first() const;
+
+        const std::vector< double >& volume() const;
+        const std::vector< double >& centerX() const;
+        const std::vector< double >& centerY() const;
+        const std::vector< double >& depth() const;
+        const std::vector< double >& thickness() const;
+        const std::vector< double >& dx() const;
+        const std::vector< double >& dy() const;
+
+    private:
+        void compute( size_t nx, size_t ny, size_t nz,
+                      const std::vector< double >& coord,
+                      const std::vector< double >& zcorn );
+        void compute( const CartesianGeometry& geometry );
+        void resize( size_t size );
+
+        size_t m_first;
+        size_t m_last;
+
+        std::vector< double > m_volume;
+        std::vector< double > m_x;
+        std::vector< double > m_y;
+        std::vector< double > m_z;
+        std::vector< double > m_thickness;
+        std::vector< double > m_dx;
+        std::vector< double > m_dy;
+    };
+}
+
+#endif
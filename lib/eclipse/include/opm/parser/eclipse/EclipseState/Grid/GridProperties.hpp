@@ -30,6 +30,7 @@
 
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridPropertyEdits.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/BoxManager.hpp>
 #include <opm/parser/eclipse/Parser/MessageContainer.hpp>
 #include <opm/parser/eclipse/Units/Dimension.hpp>
@@ -50,6 +51,15 @@
        getKeyword() method it will automatically create a new
        GridProperty object if the container does not have this
        property.
+
+  Every supported keyword has an integer handle, its position in the
+  list passed to the constructor; keywords registered later - PORV,
+  ACTNUM and the FIPxxx region sets - are numbered after those. Code
+  which looks up the same property repeatedly can resolve the handle
+  once with getHandle(), and then use the handle overloads, which
+  index a flat table. The string overloads resolve the handle through
+  a hash map; a keyword which is already upper case and trimmed is
+  looked up without making a normalized copy.
 */
 
 
@@ -59,6 +69,7 @@ namespace Opm {
                         BoxManager& boxManager);
 
     class Eclipse3DProperties;
+    class MemoryUsage;
 
     template <typename T>
     class GridProperties {
@@ -75,6 +86,12 @@ namespace Opm {
         explicit GridProperties(const EclipseGrid& eclipseGrid,
                        std::vector< SupportedKeywordInfo >&& supportedKeywords);
 
+        /* A copy points its handle table into its own properties. */
+        GridProperties(const GridProperties& other);
+        GridProperties(GridProperties&& other) = default;
+        GridProperties& operator=(const GridProperties& other);
+        GridProperties& operator=(GridProperties&& other) = default;
+
         T convertInputValue(  const GridProperty<T>& property , double doubleValue) const;
         T convertInputValue( double doubleValue ) const;
 
@@ -90,6 +107,17 @@ namespace Opm {
         bool hasKeyword(const std::string& keyword) const;
         bool hasDeckKeyword(const std::string& keyword) const;
 
+        /*
+          The handle of a supported keyword; throws std::invalid_argument
+          for an unsupported keyword. The handles of a keyword are the
+          same in all the containers constructed from the same list of
+          supported keywords. The handle overloads throw
+          std::out_of_range for an unknown handle.
+        */
+        size_t getHandle(const std::string& keyword) const;
+        bool hasKeyword(size_t handle) const;
+        const GridProperty<T>& getKeyword(size_t handle) const;
+
 
         size_t size() const;
         void assertKeyword(const std::string& keyword) const;
@@ -115,6 +143,12 @@ namespace Opm {
         const MessageContainer& getMessageContainer() const;
         MessageContainer& getMessageContainer();
 
+        /*
+          Adds every property as "@prefix/NAME", and the keyword
+          bookkeeping as "@prefix/index".
+        */
+        void memoryUsage( MemoryUsage& usage, const std::string& prefix ) const;
+
 
         template <class Keyword>
         bool hasKeyword() const {
@@ -144,6 +178,19 @@ namespace Opm {
         void handleCOPYRecord( const DeckRecord& record, BoxManager& boxManager);
         void handleEQUALSRecord( const DeckRecord& record, BoxManager& boxManager);
 
+        /*
+          The overloads taking a GridPropertyEdits instance only add the
+          operation to the edits; it is applied by edits.apply(). The
+          caller must apply the edits before a record which creates a
+          property, see GridPropertyEdits. A sparse target property is
+          updated directly instead, and so is the target of a COPY from
+          a sparse source; the edits never refer to sparse storage.
+        */
+        void handleADDRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits);
+        void handleMULTIPLYRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits);
+        void handleCOPYRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits);
+        void handleEQUALSRecord( const DeckRecord& record, BoxManager& boxManager, GridPropertyEdits<T>& edits);
+
         void handleEQUALREGRecord( const DeckRecord& record, const GridProperty<int>& regionProperty );
         void handleADDREGRecord( const DeckRecord& record, const GridProperty<int>& regionProperty );
         void handleMULTIREGRecord( const DeckRecord& record, const GridProperty<int>& regionProperty );
@@ -183,12 +230,29 @@ namespace Opm {
         void postAddKeyword(const std::string& name,
                             const T defaultValue,
                             std::function< void( std::vector< T >& ) > postProcessor,
+                            std::vector< std::string > dependencies,
                             const std::string& dimString );
         GridProperty<T>& getKeyword(const std::string& keyword);
+
+        /*
+          For Eclipse3DProperties::finalize(): the registered info of a
+          supported keyword, or nullptr for a FIPxxx keyword which has
+          not been registered yet, and the creation of an auto generated
+          property split in two, so the initializer can run on another
+          thread than the insertion into the container.
+        */
+        const SupportedKeywordInfo* keywordInfo(const std::string& keyword) const;
+        GridProperty<T> createProperty(const std::string& keyword) const;
+        void insertAutoGenerated(GridProperty<T>&& property) const;
         bool addAutoGeneratedKeyword_(const std::string& keywordName) const;
-        void insertKeyword(const SupportedKeywordInfo& supportedKeyword) const;
+        GridProperty<T>& getOrGenerate(size_t handle) const;
+        void insertKeyword(size_t handle) const;
+        void insertProperty(size_t handle, GridProperty<T>&& property) const;
         bool isAutoGenerated_(const std::string& keyword) const;
 
+        const size_t* findHandle(const std::string& keyword) const;
+        size_t registerKeyword(SupportedKeywordInfo&& supportedKeyword) const;
+
         friend class Eclipse3DProperties; // needed for PORV keyword entanglement
         size_t nx = 0;
         size_t ny = 0;
@@ -196,7 +260,13 @@ namespace Opm {
         const UnitSystem *  m_deckUnitSystem = nullptr;
         MessageContainer m_messages;
 
-        mutable std::unordered_map<std::string, SupportedKeywordInfo> m_supportedKeywords;
+        /*
+          The info, and the property or nullptr, of each handle; the
+          pointers go into m_properties, whose nodes never move.
+        */
+        mutable std::vector<SupportedKeywordInfo> m_supportedKeywords;
+        mutable std::unordered_map<std::string, size_t> m_handles;
+        mutable std::vector<GridProperty<T>*> m_byHandle;
         mutable storage m_properties;
         mutable std::set<std::string> m_autoGeneratedProperties;
     };
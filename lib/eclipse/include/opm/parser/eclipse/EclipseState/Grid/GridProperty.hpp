@@ -20,9 +20,13 @@
 #define ECLIPSE_GRIDPROPERTY_HPP_
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <opm/parser/eclipse/EclipseState/Grid/RegionCells.hpp>
+
 /*
   This class implemenents a class representing properties which are
   define over an ECLIPSE grid, i.e. with one value for each logical
@@ -72,10 +76,40 @@ class GridPropertySupportedKeywordInfo {
                 post postProcessor,
                 const std::string& dimString );
 
+        /*
+          The dependencies are the other grid properties, int or double,
+          read by the initializer or the post processor; they are the
+          edges of the graph Eclipse3DProperties::finalize() evaluates.
+          A property which is only read when it is already present need
+          not be listed, as long as it is read by one keyword only.
+        */
+        GridPropertySupportedKeywordInfo(
+                const std::string& name,
+                init initializer,
+                std::vector< std::string > dependencies,
+                const std::string& dimString );
+
+        GridPropertySupportedKeywordInfo(
+                const std::string& name,
+                const T defaultValue,
+                post postProcessor,
+                std::vector< std::string > dependencies,
+                const std::string& dimString );
+
         const std::string& getKeywordName() const;
         const std::string& getDimensionString() const;
         const init& initializer() const;
         const post& postProcessor() const;
+        bool hasPostProcessor() const;
+        const std::vector< std::string >& dependencies() const;
+        size_t memoryUsage() const;
+
+        /*
+          The constant default value; T() for keywords with an
+          initializer function.
+        */
+        T defaultValue() const;
+        bool hasConstantDefault() const;
 
     private:
 
@@ -83,6 +117,10 @@ class GridPropertySupportedKeywordInfo {
         init m_initializer;
         post m_postProcessor;
         std::string m_dimensionString;
+        std::vector< std::string > m_dependencies;
+        T m_defaultValue = T();
+        bool m_constantDefault = false;
+        bool m_hasPostProcessor = false;
 };
 
 template< typename T >
@@ -104,9 +142,52 @@ public:
     void iset(size_t i , size_t j , size_t k , T value);
 
 
+    /*
+      The const getData() never changes the storage of a compressed or
+      sparse property: the full cartesian array is then built once, in
+      a separate immutable copy which is kept until the property is
+      modified, and concurrent const reads are safe. Readers which do
+      not need the full array should use iget() or getActiveData(); the
+      non-const getData() and expand() return the property to full
+      storage.
+    */
     const std::vector<T>& getData() const;
     std::vector<T>& getData();
 
+    /*
+      Active cell storage: compress() keeps only the values of the
+      active cells, indexed through globalMap - the active index of
+      each cell, or -1 for inactive cells, as EclipseGrid::getGlobalMap()
+      after the final resetACTNUM(). The map is shared, not copied, so
+      all the properties of a grid can be compressed with one map.
+
+      While compressed, iget() reads through the map, and the inactive
+      cells read as the default value of the keyword; their original
+      values are lost. getActiveData() gives the active values without
+      a copy. The modifying methods and expand() return the property to
+      full storage first; const methods never do.
+    */
+    void compress( std::shared_ptr< const std::vector< int > > globalMap );
+    bool isCompressed() const;
+    const std::vector<T>& getActiveData() const;
+    /* Return a compressed or sparse property to full storage. */
+    void expand();
+
+    /*
+      Sparse storage: a property of a keyword with a constant default
+      value starts out as that constant plus a hash map of the cells
+      which differ from it, like the MULTX property which only has a
+      value different from 1 in a few boxes. Writes to single cells and
+      to small boxes go to the map, and setScalar(), scale() and add()
+      on the whole grid update the constant. The property is promoted
+      to full storage when the map grows beyond 1/16 of the cells, by
+      expand() and by the modifying operations which need the full
+      array, i.e. the non-const getData() and the masked and bulk
+      operations. Sparse properties are not compressed. As for
+      compressed properties the const methods never promote.
+    */
+    bool isSparse() const;
+
     bool containsNaN() const;
     const std::string& getDimensionString() const;
 
@@ -118,6 +199,27 @@ public:
     void maskedCopy( const GridProperty< T >& other, const std::vector< bool >& mask );
     void initMask( T value, std::vector<bool>& mask ) const;
 
+    /*
+      The masked operations also take a byte mask, one byte per cell,
+      non-zero for the cells in the mask. The byte mask is processed a
+      word at a time, and skipping the unmasked cells is cheap.
+    */
+    typedef std::vector< unsigned char > ByteMask;
+    void maskedSet( T value, const ByteMask& mask );
+    void maskedMultiply( T value, const ByteMask& mask );
+    void maskedAdd( T value, const ByteMask& mask );
+    void maskedCopy( const GridProperty< T >& other, const ByteMask& mask );
+    void initMask( T value, ByteMask& mask ) const;
+
+    /*
+      The cells of each value of a region property like MULTNUM or
+      FLUXNUM. The index is built on the first call and kept until the
+      property is modified; a reference obtained from the non-const
+      getData() must not be used to modify the property after the index
+      has been built. Only available for GridProperty<int>.
+    */
+    const RegionCells& regionCells() const;
+
     /**
        Due to the convention where it is only necessary to supply the
        top layer of the petrophysical properties we can unfortunately
@@ -135,6 +237,7 @@ public:
 
     const std::string& getKeywordName() const;
     const SupportedKeywordInfo& getKeywordInfo() const;
+    size_t memoryUsage() const;
 
     /**
        Will check that all elements in the property are in the closed
@@ -179,11 +282,27 @@ public:
 private:
     const DeckItem& getDeckItem( const DeckKeyword& );
     void setDataPoint(size_t sourceIdx, size_t targetIdx, const DeckItem& deckItem);
+    void modified();
+    void invalidate();
+    const std::vector<T>& full() const;
+    std::vector<T> expanded() const;
+    T value( size_t index ) const;
+    void setOverride( size_t index, T value );
+    bool keepSparse( size_t writes ) const;
 
     size_t m_nx, m_ny, m_nz;
     SupportedKeywordInfo m_kwInfo;
+    /* all the cells, or only the active cells when m_globalMap is set */
     std::vector<T> m_data;
+    std::shared_ptr< const std::vector< int > > m_globalMap;
+    /* the sparse representation, m_data is empty while m_sparse is set */
+    bool m_sparse = false;
+    T m_constant = T();
+    std::unordered_map< size_t, T > m_overrides;
+    /* the full array of a compressed or sparse property, for const readers */
+    mutable std::shared_ptr< const std::vector< T > > m_full;
     bool m_hasRunPostProcessor = false;
+    mutable std::shared_ptr< const RegionCells > m_regionCells;
 };
 
 // initialize the TEMPI grid property using the temperature vs depth
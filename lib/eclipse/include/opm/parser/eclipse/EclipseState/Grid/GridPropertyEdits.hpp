@@ -0,0 +1,82 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRID_PROPERTY_EDITS_HPP
+#define OPM_GRID_PROPERTY_EDITS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <opm/parser/eclipse/EclipseState/Grid/Box.hpp>
+
+namespace Opm {
+
+    /*
+      GridPropertyEdits collects a run of box scoped arithmetic records -
+      EQUALS, ADD, MULTIPLY and COPY - and applies them together in one
+      sweep over the grid, instead of one sweep per record.
+
+      All the operations are pointwise: the new value of a cell only
+      depends on the values of the same cell, in the target and for COPY
+      the source property. The only data dependencies between the edits
+      are therefore within a cell, and they are respected by applying
+      the edits which cover a cell in the order they were added. The
+      sweep goes layer by layer; for each layer all the edits are applied
+      in order to their runs in that layer, while the layer is still in
+      cache. The layers are independent and are split over the OpenMP
+      threads. The result is identical to applying the edits one by one.
+
+      The edits keep pointers to the property data, and must be applied
+      before anything else reads or resizes the properties - in
+      particular before a property is created, since the initializer of
+      the new property can depend on the values of other properties.
+    */
+
+    template< typename T >
+    class GridPropertyEdits {
+    public:
+        void assign( std::vector< T >& target, T value, const Box& box );
+        void add( std::vector< T >& target, T value, const Box& box );
+        void multiply( std::vector< T >& target, T value, const Box& box );
+        void copy( std::vector< T >& target, const std::vector< T >& src, const Box& box );
+
+        bool empty() const;
+        size_t size() const;
+
+        /* Apply all the collected edits, and clear the list. */
+        void apply();
+
+    private:
+        enum class Kind { ASSIGN, ADD, MULTIPLY, COPY };
+
+        struct Edit {
+            Kind kind;
+            T* target;
+            const T* src;
+            T value;
+            Box box;
+        };
+
+        void applyRun( const Edit& edit, size_t start, size_t length ) const;
+
+        std::vector< Edit > m_edits;
+    };
+}
+
+#endif
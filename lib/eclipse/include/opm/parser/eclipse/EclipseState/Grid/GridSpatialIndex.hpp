@@ -0,0 +1,119 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRID_SPATIAL_INDEX_HPP
+#define OPM_GRID_SPATIAL_INDEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+namespace Opm {
+
+    class GridDims;
+
+    /*
+      The GridSpatialIndex class answers point location and segment
+      queries on a corner point grid. The index is a uniform 2D bin
+      structure over the xy extent of the pillar columns: each bin lists
+      the columns whose xy bounding box overlaps the bin, and within a
+      column the layers are searched with a binary search on the cell
+      depths.
+
+      A cell is treated as the union of the six tetrahedra sharing the
+      diagonal between corner 0 and corner 7 - the same decomposition
+      as the volume computation in GridGeometry. The decomposition is
+      watertight across the faces of neighbouring cells.
+
+      The coordinates are in the COORD coordinate system, i.e. MAPAXES
+      is not applied, and the ZCORN values are fixed up as in
+      EclipseGrid::exportZCORN(). All cells, active or not, are indexed.
+    */
+
+    class GridSpatialIndex {
+    public:
+        struct Intersection {
+            size_t global_index;
+            /* distance from the start of the segment */
+            double entry;
+            double exit;
+        };
+
+        explicit GridSpatialIndex( const EclipseGrid& grid );
+        GridSpatialIndex( const GridDims& dims,
+                          std::vector< double > coord,
+                          std::vector< double > zcorn );
+
+        /* Global index of the cell containing the point, or -1. */
+        int findCell( double x, double y, double z ) const;
+        std::vector< int > findCells( const std::vector< std::array< double, 3 > >& points ) const;
+
+        /*
+          The cells crossed by the segment p0 -> p1, ordered by the
+          distance from p0 where the segment enters the cell. Cells only
+          touched by the segment are not included.
+        */
+        std::vector< Intersection > traverse( const std::array< double, 3 >& p0,
+                                              const std::array< double, 3 >& p1 ) const;
+
+        bool cellContains( size_t global_index, double x, double y, double z ) const;
+
+        size_t memoryUsage() const;
+
+    private:
+        struct Corners {
+            double x[8], y[8], z[8];
+        };
+
+        void build();
+        Corners cellCorners( size_t global_index ) const;
+        size_t binIndex( size_t bx, size_t by ) const;
+        std::array< size_t, 2 > binCoordinates( double x, double y ) const;
+        std::array< size_t, 2 > layerRange( size_t column, double zmin, double zmax ) const;
+        bool clipSegment( size_t global_index,
+                          const std::array< double, 3 >& p0,
+                          const std::array< double, 3 >& d,
+                          double& t0, double& t1 ) const;
+
+        size_t nx, ny, nz;
+        ZcornMapper m_mapper;
+        std::vector< double > m_coord;
+        std::vector< double > m_zcorn;
+
+        /*
+          Bounding boxes: xmin, xmax, ymin, ymax, zmin, zmax for the cells
+          and xmin, xmax, ymin, ymax for the columns. Along a column the
+          zmax values are replaced with the running maximum, and the zmin
+          values with the running minimum from below, so the layers can
+          be searched with a binary search.
+        */
+        std::vector< double > m_cell_box;
+        std::vector< double > m_column_box;
+
+        /* The columns of bin b are m_bin_columns[m_bin_offset[b] .. m_bin_offset[b + 1]). */
+        size_t m_bins_x = 1, m_bins_y = 1;
+        double m_x0 = 0, m_y0 = 0, m_bin_dx = 1, m_bin_dy = 1;
+        std::vector< size_t > m_bin_offset;
+        std::vector< size_t > m_bin_columns;
+    };
+}
+
+#endif
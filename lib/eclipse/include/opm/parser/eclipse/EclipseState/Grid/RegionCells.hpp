@@ -0,0 +1,77 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REGION_CELLS_HPP
+#define OPM_REGION_CELLS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+    /*
+      The RegionCells class is the inverted index of a region array like
+      MULTNUM or FLUXNUM: for each region value the sorted list of the
+      global indices of the cells with that value. The lists are stored
+      back to back (CSR layout) and built with one counting sort pass
+      over the region array.
+
+      When the region values are spread over a range much larger than
+      the number of cells the offsets are indexed through the sorted list
+      of distinct values instead of directly by value.
+    */
+
+    class RegionCells {
+    public:
+        class Range {
+        public:
+            Range( const size_t* first, const size_t* last ) :
+                m_first( first ), m_last( last )
+            {}
+
+            const size_t* begin() const { return this->m_first; }
+            const size_t* end() const { return this->m_last; }
+            size_t size() const { return this->m_last - this->m_first; }
+            bool empty() const { return this->m_first == this->m_last; }
+
+        private:
+            const size_t* m_first;
+            const size_t* m_last;
+        };
+
+        explicit RegionCells( const std::vector< int >& regions );
+
+        /* The cells with region value @value; empty if there are none. */
+        Range cells( int value ) const;
+
+        size_t memoryUsage() const;
+
+    private:
+        bool slot( int value, size_t& index ) const;
+
+        int m_min = 0;
+        /* distinct values, only used when the value range is sparse */
+        std::vector< int > m_values;
+        /* the cells of slot s are m_cells[m_offset[s] .. m_offset[s + 1]) */
+        std::vector< size_t > m_offset;
+        std::vector< size_t > m_cells;
+    };
+}
+
+#endif
@@ -54,6 +54,7 @@ namespace Opm {
         void applyMULT(const GridProperty<double>& srcMultProp, FaceDir::DirEnum faceDir);
         void applyMULTFLT(const FaultCollection& faults);
         void applyMULTFLT(const Fault& fault);
+        size_t memoryUsage() const;
 
     private:
         size_t getGlobalIndex(size_t i , size_t j , size_t k) const;
@@ -86,6 +86,8 @@ namespace Opm {
         bool operator==( const Completion& ) const;
         bool operator!=( const Completion& ) const;
 
+        size_t memoryUsage() const;
+
     private:
         int m_i, m_j, m_k;
         int m_complnum;
@@ -59,6 +59,8 @@ namespace Opm {
         bool operator==( const CompletionSet& ) const;
         bool operator!=( const CompletionSet& ) const;
 
+        size_t memoryUsage() const;
+
     private:
         std::vector< Completion > m_completions;
         size_t findClosestCompletion(int oi, int oj, double oz, size_t start_pos);
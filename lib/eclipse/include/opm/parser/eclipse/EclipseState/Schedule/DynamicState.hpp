@@ -26,6 +26,7 @@
 #include <algorithm>
 
 #include <opm/parser/eclipse/EclipseState/Schedule/TimeMap.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 
 namespace Opm {
@@ -121,6 +122,10 @@ class DynamicState {
             return std::distance( m_data.begin() , iter );
         }
 
+        size_t memoryUsage() const {
+            return memory::heap( this->m_data );
+        }
+
     private:
         std::vector< T > m_data;
         size_t initial_range;
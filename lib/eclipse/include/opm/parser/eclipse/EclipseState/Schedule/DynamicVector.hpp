@@ -23,6 +23,7 @@
 
 #include <stdexcept>
 #include <opm/parser/eclipse/EclipseState/Schedule/TimeMap.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 namespace Opm {
 
@@ -58,6 +59,10 @@ namespace Opm {
             (*this)[index] = std::move( value );
         }
 
+        size_t memoryUsage() const {
+            return memory::heap( this->m_data );
+        }
+
     private:
         std::vector<T> m_data;
     };
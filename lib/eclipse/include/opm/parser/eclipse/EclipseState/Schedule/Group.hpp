@@ -129,6 +129,8 @@ namespace Opm {
         void addWell(size_t time_step, const Well* well);
         void delWell(size_t time_step, const std::string& wellName );
 
+        size_t memoryUsage() const;
+
     private:
         size_t m_creationTimeStep;
         std::string m_name;
@@ -51,6 +51,7 @@ namespace Opm
     class TimeMap;
     class UnitSystem;
     class EclipseState;
+    class MemoryUsage;
 
     class Schedule {
     public:
@@ -111,6 +112,12 @@ namespace Opm
         const MessageContainer& getMessageContainer() const;
         MessageContainer& getMessageContainer();
 
+        /*
+          Adds "Schedule/wells", "Schedule/completions", "Schedule/groups",
+          "Schedule/modifier decks" and "Schedule/other".
+        */
+        void memoryUsage( MemoryUsage& usage ) const;
+
 
     private:
         TimeMap m_timeMap;
@@ -46,6 +46,7 @@ namespace Opm {
     class Segment;
     class SegmentSet;
     class TimeMap;
+    class MemoryUsage;
 
     class Well {
     public:
@@ -164,6 +165,12 @@ namespace Opm {
         const Events& getEvents() const;
         void addEvent(ScheduleEvents::Events event, size_t reportStep);
         bool hasEvent(uint64_t eventMask, size_t reportStep) const;
+
+        /*
+          Adds the completion history to "Schedule/completions" and
+          everything else to "Schedule/wells".
+        */
+        void memoryUsage( MemoryUsage& usage ) const;
     private:
         size_t m_creationTimeStep;
         std::string m_name;
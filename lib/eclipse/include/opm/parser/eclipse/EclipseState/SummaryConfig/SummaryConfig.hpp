@@ -35,6 +35,7 @@ namespace Opm {
     class Schedule;
     class ParseContext;
     class GridDims;
+    class MemoryUsage;
 
     class SummaryConfig {
         public:
@@ -68,6 +69,12 @@ namespace Opm {
             */
             bool require3DField( const std::string& keyword) const;
             bool requireFIPNUM( ) const;
+
+            /*
+              Adds "SummaryConfig"; the smspec nodes are owned by libecl
+              and only the wrapper objects are counted.
+            */
+            void memoryUsage( MemoryUsage& usage ) const;
         private:
             SummaryConfig( const Deck& deck,
                            const Schedule& schedule,
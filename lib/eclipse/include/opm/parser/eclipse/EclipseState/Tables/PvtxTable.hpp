@@ -119,6 +119,7 @@ The first row actually corresponds to saturated values.
         double evaluate(const std::string& column, double outerArg, double innerArg) const;
         double getArgValue(size_t index) const;
         const SimpleTable& getSaturatedTable() const;
+        size_t memoryUsage() const;
 
         /*
           Will iterate over the internal undersaturated tables; same
@@ -63,6 +63,8 @@ namespace Opm {
         /// throws std::invalid_argument if jf != m_jfunc
         void assertJFuncPressure(const bool jf) const;
 
+        size_t memoryUsage() const;
+
     protected:
         std::map<std::string, size_t> m_columnNames;
         std::vector<std::vector<bool> > m_valueDefaulted;
@@ -60,6 +60,9 @@ namespace Opm {
         std::vector<double> vectorCopy() const;
         std::vector<double>::const_iterator begin() const;
         std::vector<double>::const_iterator end() const;
+
+        /* Heap memory used by the name, values and default flags. */
+        size_t memoryUsage() const;
     private:
         void assertUpdate(size_t index, double value) const;
         void assertPrevious(size_t index , double value) const;
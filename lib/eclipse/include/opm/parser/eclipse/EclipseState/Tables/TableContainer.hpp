@@ -67,6 +67,7 @@ namespace Opm {
         */
         size_t size() const;
         void addTable(size_t tableNumber , std::shared_ptr<const SimpleTable> table);
+        size_t memoryUsage() const;
 
 
         /*
@@ -50,6 +50,7 @@
 namespace Opm {
 
     class Eqldims;
+    class MemoryUsage;
     class Regdims;
     
     class TableManager {
@@ -137,6 +138,12 @@ namespace Opm {
         const MessageContainer& getMessageContainer() const;
         MessageContainer& getMessageContainer();
 
+        /*
+          Adds one "Tables/<KEYWORD>" component for each table family
+          which is present in the deck.
+        */
+        void memoryUsage( MemoryUsage& usage ) const;
+
         double rtemp() const;
     private:
         TableContainer& forceGetTables( const std::string& tableName , size_t numTables);
@@ -25,6 +25,8 @@
 #include <string>
 #include <stdexcept>
 
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
 
 namespace Opm {
 
@@ -113,6 +115,10 @@ public:
         return m_vector.size();
     }
 
+    size_t memoryUsage() const {
+        return memory::heap( m_map ) + memory::heap( m_vector );
+    }
+
 
     typename std::vector<T>::const_iterator begin() const {
         return m_vector.begin();
@@ -23,6 +23,8 @@
 #include <stdexcept>
 #include <string>
 
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
 
 /*
   The simple class Value<T> keeps track of a named scalar variable;
@@ -103,6 +105,10 @@ public:
         return !(*this == rhs );
     }
 
+    size_t memoryUsage() const {
+        return memory::heap( m_name ) + memory::heap( m_value );
+    }
+
 
 };
 }
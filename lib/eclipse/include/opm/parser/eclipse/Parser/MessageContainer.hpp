@@ -20,7 +20,10 @@
 #ifndef MESSAGECONTAINER_H
 #define MESSAGECONTAINER_H
 
+#include <limits>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <memory>
 
@@ -62,6 +65,24 @@ namespace Opm {
     };
 
 
+    /*
+      Aggregated count of the messages which have been added with the same
+      (key, keyword, filename) triplet, where the key is typically one of
+      the ParseContext error keys. The location of the first and the last
+      such message is retained also when the message text itself has been
+      dropped because the message limit was exceeded.
+    */
+    struct MessageCount {
+        std::string key;
+        std::string keyword;
+        std::string filename;
+        Message::type mtype;
+        size_t count = 0;
+        Location first;
+        Location last;
+    };
+
+
     ///Message container is used to replace OpmLog functionalities.
     class MessageContainer {
     public:
@@ -91,16 +112,44 @@ namespace Opm {
 
         void add( const Message& );
         void add( Message&& );
-        
+
+        /*
+          Add a message which is aggregated on (key, keyword, filename);
+          the filename is taken from the location of the message. Only the
+          first messageLimit() messages for every such triplet are stored,
+          the remaining are just counted.
+        */
+        void add( Message&&, const std::string& key, const std::string& keyword );
+
+        /*
+          Append the messages and the counts of other. The message limit
+          of this container applies to the aggregated messages of other
+          as well.
+        */
         void appendMessages(const MessageContainer& other);
-        
+
         const_iterator begin() const;
         const_iterator end() const;
 
         std::size_t size() const;
-        
+        std::size_t memoryUsage() const;
+
+        void setMessageLimit( std::size_t limit );
+        std::size_t messageLimit() const;
+        std::size_t suppressed() const;
+        const std::vector< MessageCount >& counts() const;
+
     private:
         std::vector<Message> m_messages;
+        std::vector< MessageCount > m_counts;
+        std::unordered_map< std::string, size_t > m_count_index;
+        /* (position in m_messages, index in m_counts) of the aggregated messages */
+        std::vector< std::pair< size_t, size_t > > m_aggregated;
+        std::size_t m_limit = std::numeric_limits< std::size_t >::max();
+        std::size_t m_suppressed = 0;
+
+        size_t countIndex( const std::string& key, const std::string& keyword,
+                           const std::string& filename, Message::type mtype );
     };
 
 } // namespace Opm
@@ -21,6 +21,8 @@
 #ifndef OPM_PARSE_CONTEXT_HPP
 #define OPM_PARSE_CONTEXT_HPP
 
+#include <array>
+#include <limits>
 #include <string>
 #include <map>
 #include <vector>
@@ -74,15 +76,49 @@ namespace Opm {
        The update function itself is quite tolerant, and will silently
        ignore unknown keys. If you use the updateKey() function only
        recognizd keys will be allowed.
+
+       The predefined keys also have a numerical id in the ErrorKey
+       enum. The actions for these keys are mirrored in an array indexed
+       by the id, so the handleError() overload taking an ErrorKey does
+       not need a string lookup; this is the overload used by the parser.
     */
 
     class ParseContext {
     public:
+        enum class ErrorKey {
+            PARSE_UNKNOWN_KEYWORD = 0,
+            PARSE_RANDOM_TEXT,
+            PARSE_RANDOM_SLASH,
+            PARSE_MISSING_DIMS_KEYWORD,
+            PARSE_EXTRA_DATA,
+            PARSE_MISSING_INCLUDE,
+            UNSUPPORTED_SCHEDULE_GEO_MODIFIER,
+            UNSUPPORTED_COMPORD_TYPE,
+            UNSUPPORTED_INITIAL_THPRES,
+            UNSUPPORTED_TERMINATE_IF_BHP,
+            INTERNAL_ERROR_UNINITIALIZED_THPRES,
+            SUMMARY_UNKNOWN_WELL,
+            SUMMARY_UNKNOWN_GROUP,
+            COUNT
+        };
+
         ParseContext();
         explicit ParseContext(InputError::Action default_action);
         explicit ParseContext(const std::vector<std::pair<std::string , InputError::Action>>& initial);
 
         Message::type handleError( const std::string& errorKey, MessageContainer& msgContainer, const std::string& msg ) const;
+
+        /*
+          The message is added to the message container aggregated on
+          (errorKey, keyword, location.filename), see
+          MessageContainer::setMessageLimit().
+        */
+        Message::type handleError( ErrorKey errorKey,
+                                   MessageContainer& msgContainer,
+                                   const std::string& msg,
+                                   const std::string& keyword = "",
+                                   const Location& location = Location() ) const;
+        static const std::string& keyName( ErrorKey errorKey );
         bool hasKey(const std::string& key) const;
         ParseContext  withKey(const std::string& key, InputError::Action action = InputError::WARN) const;
         ParseContext& withKey(const std::string& key, InputError::Action action = InputError::WARN);
@@ -90,8 +126,18 @@ namespace Opm {
         void update(InputError::Action action);
         void update(const std::string& keyString , InputError::Action action);
         InputError::Action get(const std::string& key) const;
+        InputError::Action get(ErrorKey key) const;
         std::map<std::string,InputError::Action>::const_iterator begin() const;
         std::map<std::string,InputError::Action>::const_iterator end() const;
+
+        /*
+          Limit on the number of messages stored per (key, keyword,
+          filename) triplet in the message container of a deck parsed
+          with this context, see MessageContainer::setMessageLimit(). The
+          default is unbounded.
+        */
+        void setMessageLimit( std::size_t limit );
+        std::size_t messageLimit() const;
         /*
           When the key is added it is inserted in 'strict mode',
           i.e. with the value 'InputError::THROW_EXCEPTION. If you
@@ -230,6 +276,8 @@ namespace Opm {
         void envUpdate( const std::string& envVariable , InputError::Action action );
         void patternUpdate( const std::string& pattern , InputError::Action action);
         std::map<std::string , InputError::Action> m_errorContexts;
+        std::array< InputError::Action, static_cast< size_t >( ErrorKey::COUNT ) > m_actions;
+        std::size_t m_messageLimit = std::numeric_limits< std::size_t >::max();
 }; }
 
 
@@ -36,6 +36,7 @@ namespace Opm {
         double convertSiToRaw(double siValue) const;
 
         bool equal(const Dimension& other) const;
+        size_t memoryUsage() const;
         const std::string& getName() const;
         bool isCompositable() const;
         static Dimension newComposite(const std::string& dim, double SIfactor, double SIoffset = 0.0);
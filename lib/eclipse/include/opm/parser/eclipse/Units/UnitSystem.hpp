@@ -82,6 +82,7 @@ namespace Opm {
         const Dimension& getDimension(const std::string& dimension) const;
         bool hasDimension(const std::string& dimension) const;
         bool equal(const UnitSystem& other) const;
+        size_t memoryUsage() const;
 
         bool operator==( const UnitSystem& ) const;
         bool operator!=( const UnitSystem& ) const;
@@ -0,0 +1,138 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRID_KERNELS_HPP
+#define OPM_GRID_KERNELS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+
+namespace Opm {
+namespace GridKernels {
+
+    /*
+     * Chunked parallel loops over the cells of grid sized arrays, used
+     * by the bulk GridProperty operations.
+     *
+     * The range [0, size) is cut in chunks of chunk_size cells, and the
+     * chunks are distributed over the OpenMP threads with schedule(
+     * static ), like the other per-cell loops. Each
+     * chunk is processed by a plain serial loop the compiler can
+     * vectorize. The chunk size is a multiple of 64, so two chunks never
+     * share a word of a std::vector< bool > mask, and the chunks can
+     * write to a mask concurrently.
+     *
+     * Ranges of less than two chunks are processed by the calling
+     * thread.
+     */
+
+    constexpr size_t chunk_size = size_t( 1 ) << 14;
+
+    /*
+     * The number of threads used by the kernels. The default, and the
+     * value 0, is the OpenMP default, i.e. omp_get_max_threads(). Without
+     * OpenMP the kernels are always serial.
+     */
+    void setThreads( int threads );
+    int threads();
+
+    /* Call f( begin, end ) for each chunk of [0, size). */
+    template< typename F >
+    void forEachChunk( size_t size, F f ) {
+        const long long chunks = (long long)( (size + chunk_size - 1) / chunk_size );
+        const int nthreads = threads();
+        (void) nthreads;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads) if(chunks > 1)
+#endif
+        for( long long c = 0; c < chunks; c++ ) {
+            const size_t begin = size_t( c ) * chunk_size;
+            f( begin, std::min( begin + chunk_size, size ) );
+        }
+    }
+
+    /*
+     * The first index in [0, size) where the chunk search first( begin,
+     * end ) finds a hit, or size if there is none; first() returns the
+     * first hit in [begin, end), or end. The result is the smallest hit
+     * whatever the number of threads, so a reduction built on it - e.g.
+     * the element reported by a limit check - is deterministic. Chunks
+     * after a hit which is already found are skipped.
+     */
+    template< typename F >
+    size_t findFirst( size_t size, F first ) {
+        std::atomic< size_t > found( size );
+
+        forEachChunk( size, [&]( size_t begin, size_t end ) {
+            if( begin >= found.load( std::memory_order_relaxed ) ) return;
+
+            const size_t hit = first( begin, end );
+            if( hit == end ) return;
+
+            size_t current = found.load();
+            while( hit < current && !found.compare_exchange_weak( current, hit ) )
+                ;
+        });
+
+        return found.load();
+    }
+
+    /*
+     * Call f( i ) for each set element i in [begin, end) of a byte mask,
+     * one byte per cell. The mask is read a 64 bit word at a time, and
+     * words without any set byte are skipped.
+     */
+    template< typename F >
+    void forEachSet( const unsigned char* mask, size_t begin, size_t end, F f ) {
+        size_t i = begin;
+        for( ; i + 8 <= end; i += 8 ) {
+            uint64_t word;
+            std::memcpy( &word, mask + i, sizeof( word ) );
+            if( word == 0 ) continue;
+
+            for( size_t j = i; j < i + 8; j++ )
+                if( mask[ j ] ) f( j );
+        }
+
+        for( ; i < end; i++ )
+            if( mask[ i ] ) f( i );
+    }
+
+    /* Parallel copy of src into a new vector backed by GridMemory. */
+    template< typename T >
+    std::vector< T > copy( const std::vector< T >& src ) {
+        std::vector< T > dst;
+        GridMemory::resize( dst, src.size() );
+        forEachChunk( src.size(), [&]( size_t begin, size_t end ) {
+            std::copy( src.begin() + begin, src.begin() + end, dst.begin() + begin );
+        });
+        return dst;
+    }
+
+}
+}
+
+#endif //OPM_GRID_KERNELS_HPP
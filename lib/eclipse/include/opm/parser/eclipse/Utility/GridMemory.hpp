@@ -0,0 +1,92 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRID_MEMORY_HPP
+#define OPM_GRID_MEMORY_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+namespace GridMemory {
+
+    /*
+     * Huge page backing for the large grid sized arrays, i.e. the
+     * properties and the ZCORN/COORD exports. The arrays are ordinary
+     * std::vectors which own and construct all their elements. For the
+     * large ones the kernel is asked to back the storage with
+     * transparent huge pages, when the platform supports madvise(
+     * MADV_HUGEPAGE ). The advice is given after the buffer is allocated
+     * and before the vector constructs the elements, i.e. before the
+     * pages are touched.
+     *
+     * The pages are first touched by the thread constructing the
+     * vector, so on a NUMA machine they are all placed on its node.
+     * Placing them on the node of the thread using them would need an
+     * allocator leaving the elements uninitialised, and so a different
+     * vector type in the property interfaces.
+     *
+     * Arrays smaller than large_array bytes are allocated as usual.
+     */
+
+    constexpr size_t large_array = size_t( 1 ) << 21;
+
+    /*
+     * Advise the kernel to use huge pages for the whole pages in
+     * [data, data + bytes). A no-op where madvise( MADV_HUGEPAGE ) is
+     * not available.
+     */
+    void adviseHugePages( void* data, size_t bytes );
+
+    /*
+     * Make sure v has capacity for n elements; if a new buffer is needed
+     * for a large array huge pages are advised for it. The current
+     * elements are kept.
+     */
+    template< typename T >
+    void reserve( std::vector< T >& v, size_t n ) {
+        static_assert( std::is_trivially_copyable< T >::value,
+                       "GridMemory is only for arrays of trivial types" );
+
+        if( v.capacity() >= n ) return;
+
+        v.reserve( n );
+        if( n * sizeof( T ) >= large_array )
+            adviseHugePages( v.data(), n * sizeof( T ) );
+    }
+
+    template< typename T >
+    void resize( std::vector< T >& v, size_t n ) {
+        reserve( v, n );
+        v.resize( n );
+    }
+
+    template< typename T >
+    std::vector< T > filled( size_t n, T value ) {
+        std::vector< T > v;
+        reserve( v, n );
+        v.assign( n, value );
+        return v;
+    }
+
+}
+}
+
+#endif //OPM_GRID_MEMORY_HPP
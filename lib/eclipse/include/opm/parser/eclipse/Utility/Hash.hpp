@@ -0,0 +1,103 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_HASH_HPP
+#define OPM_HASH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Opm {
+
+namespace hash {
+
+    /*
+     * Small and fast non-cryptographic 64 bit hashing, used to fingerprint
+     * the content of deck objects. The raw buffer is consumed in 32 byte
+     * blocks by four independent lanes with the xxhash64 round function, and
+     * the lanes and the tail are folded together and run through the murmur3
+     * finalizer. The hashes are only stable within one build, and must not
+     * be persisted.
+     */
+
+    constexpr uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+    constexpr uint64_t prime1 = 0x9e3779b185ebca87ULL;
+    constexpr uint64_t prime2 = 0xc2b2ae3d27d4eb4fULL;
+
+    inline uint64_t rotl( uint64_t x, int r ) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t round( uint64_t acc, uint64_t word ) {
+        return rotl( acc + word * prime2, 31 ) * prime1;
+    }
+
+    inline uint64_t mix( uint64_t h ) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline uint64_t combine( uint64_t h, uint64_t value ) {
+        return round( h ^ (h >> 29), value );
+    }
+
+    inline uint64_t load( const unsigned char* ptr ) {
+        uint64_t word;
+        std::memcpy( &word, ptr, sizeof( word ) );
+        return word;
+    }
+
+    inline uint64_t bytes( const void* data, size_t size, uint64_t h = seed ) {
+        const auto* ptr = static_cast< const unsigned char* >( data );
+        const auto* end = ptr + size;
+
+        uint64_t lane[ 4 ] = { h + prime1, h ^ prime2, h, h - prime1 };
+        for( ; end - ptr >= 32; ptr += 32 ) {
+            lane[ 0 ] = round( lane[ 0 ], load( ptr ) );
+            lane[ 1 ] = round( lane[ 1 ], load( ptr + 8 ) );
+            lane[ 2 ] = round( lane[ 2 ], load( ptr + 16 ) );
+            lane[ 3 ] = round( lane[ 3 ], load( ptr + 24 ) );
+        }
+
+        h = rotl( lane[ 0 ], 1 ) + rotl( lane[ 1 ], 7 )
+          + rotl( lane[ 2 ], 12 ) + rotl( lane[ 3 ], 18 );
+        h = combine( h, size );
+
+        for( ; end - ptr >= 8; ptr += 8 )
+            h = combine( h, load( ptr ) );
+
+        uint64_t tail = 0;
+        std::memcpy( &tail, ptr, end - ptr );
+        return mix( combine( h, tail ) );
+    }
+
+    inline uint64_t string( const std::string& s, uint64_t h = seed ) {
+        return bytes( s.data(), s.size(), h );
+    }
+
+}
+}
+
+#endif //OPM_HASH_HPP
@@ -0,0 +1,175 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MEMORY_USAGE_HPP
+#define OPM_MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+    /*
+     * The MemoryUsage class collects the heap memory used by the different
+     * components of the deck and the EclipseState objects. The objects
+     * report themselves with a memoryUsage( MemoryUsage& ) method, adding
+     * one or more named components; the component names are hierarchical
+     * with '/' as separator, e.g. "GridProperties/double/PORO".
+     *
+     * Only heap memory is counted, i.e. the size of the object itself is
+     * not included, but the capacity of all owned containers is.
+     */
+
+    class MemoryUsage {
+    public:
+        void add( const std::string& component, size_t bytes );
+
+        size_t total() const;
+        size_t get( const std::string& component ) const;
+
+        /* All components, sorted with the largest first. */
+        std::vector< std::pair< std::string, size_t > > sorted() const;
+
+        /* Write the @limit largest components, and the total. */
+        void report( std::ostream& os, size_t limit = 0 ) const;
+
+    private:
+        std::map< std::string, size_t > components;
+    };
+
+
+namespace memory {
+
+    /*
+     * The heap() functions return the number of bytes allocated on the heap
+     * by the argument. For the contiguous containers this is exact; for the
+     * node based containers it is computed from the libstdc++ node layout,
+     * which is a close estimate for the other standard libraries. Classes
+     * which own heap memory report it with a size_t memoryUsage() const
+     * method, which is picked up by the generic heap() function.
+     */
+
+    template< typename T >
+    auto heap_member( const T& x, int ) -> decltype( size_t( x.memoryUsage() ) ) {
+        return x.memoryUsage();
+    }
+
+    template< typename T >
+    size_t heap_member( const T&, long ) {
+        return 0;
+    }
+
+    template< typename T >
+    size_t heap( const T& x ) {
+        return heap_member( x, 0 );
+    }
+
+    inline size_t heap( const std::string& s ) {
+        const auto* first = reinterpret_cast< const char* >( &s );
+        const auto* last = first + sizeof( s );
+
+        /* the small string optimization keeps the data inside the object */
+        if( s.data() >= first && s.data() < last )
+            return 0;
+
+        return s.capacity() + 1;
+    }
+
+    inline size_t heap( const std::vector< bool >& v ) {
+        return (v.capacity() + 63) / 64 * sizeof( unsigned long );
+    }
+
+    template< typename T, typename A >
+    size_t heap( const std::vector< T, A >& v );
+
+    template< typename K, typename V, typename C, typename A >
+    size_t heap( const std::map< K, V, C, A >& m );
+
+    template< typename K, typename C, typename A >
+    size_t heap( const std::set< K, C, A >& s );
+
+    template< typename K, typename V, typename H, typename E, typename A >
+    size_t heap( const std::unordered_map< K, V, H, E, A >& m );
+
+    template< typename T >
+    size_t heap( const std::shared_ptr< T >& ptr );
+
+    template< typename T, typename A >
+    size_t heap( const std::vector< T, A >& v ) {
+        size_t bytes = v.capacity() * sizeof( T );
+        for( const auto& x : v )
+            bytes += heap( x );
+
+        return bytes;
+    }
+
+    /* red-black tree node: colour and three pointers before the value */
+    constexpr size_t tree_node = 4 * sizeof( void* );
+
+    template< typename K, typename V, typename C, typename A >
+    size_t heap( const std::map< K, V, C, A >& m ) {
+        size_t bytes = m.size() * (tree_node + sizeof( std::pair< const K, V > ));
+        for( const auto& pair : m )
+            bytes += heap( pair.first ) + heap( pair.second );
+
+        return bytes;
+    }
+
+    template< typename K, typename C, typename A >
+    size_t heap( const std::set< K, C, A >& s ) {
+        size_t bytes = s.size() * (tree_node + sizeof( K ));
+        for( const auto& x : s )
+            bytes += heap( x );
+
+        return bytes;
+    }
+
+    /*
+     * hash node: next pointer, value and cached hash code; the single
+     * bucket of an empty table is not allocated.
+     */
+    template< typename K, typename V, typename H, typename E, typename A >
+    size_t heap( const std::unordered_map< K, V, H, E, A >& m ) {
+        const auto buckets = m.bucket_count() > 1 ? m.bucket_count() : 0;
+        size_t bytes = buckets * sizeof( void* )
+                     + m.size() * (2 * sizeof( void* ) + sizeof( std::pair< const K, V > ));
+        for( const auto& pair : m )
+            bytes += heap( pair.first ) + heap( pair.second );
+
+        return bytes;
+    }
+
+    /* the shared object is counted, the control block is not */
+    template< typename T >
+    size_t heap( const std::shared_ptr< T >& ptr ) {
+        if( !ptr ) return 0;
+        return sizeof( T ) + heap( *ptr );
+    }
+
+}
+}
+
+#endif //OPM_MEMORY_USAGE_HPP
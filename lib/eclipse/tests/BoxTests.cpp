@@ -17,9 +17,11 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <array>
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #define BOOST_TEST_MODULE BoxManagereTests
 
@@ -101,6 +103,74 @@ BOOST_AUTO_TEST_CASE(CreateSubBox) {
 }
 
 
+static std::vector< std::array< size_t, 3 > > boxRuns( const Opm::Box& box ) {
+    std::vector< std::array< size_t, 3 > > runs;
+    box.forEachRun( [&]( size_t start, size_t offset, size_t length ) {
+        runs.push_back( {{ start, offset, length }} );
+    });
+    return runs;
+}
+
+
+BOOST_AUTO_TEST_CASE(BoxRuns) {
+    Opm::Box globalBox( 4, 3, 2 );
+
+    /* the global box is one run */
+    auto runs = boxRuns( globalBox );
+    BOOST_CHECK_EQUAL( runs.size(), 1U );
+    BOOST_CHECK_EQUAL( runs[0][0], 0U );
+    BOOST_CHECK_EQUAL( runs[0][2], 24U );
+
+    /* one run per row */
+    Opm::Box rows( globalBox, 1, 2, 0, 1, 1, 1 );
+    runs = boxRuns( rows );
+    BOOST_CHECK_EQUAL( runs.size(), 2U );
+    BOOST_CHECK_EQUAL( runs[0][0], 13U );
+    BOOST_CHECK_EQUAL( runs[0][1], 0U );
+    BOOST_CHECK_EQUAL( runs[0][2], 2U );
+    BOOST_CHECK_EQUAL( runs[1][0], 17U );
+    BOOST_CHECK_EQUAL( runs[1][1], 2U );
+    BOOST_CHECK_EQUAL( runs[1][2], 2U );
+
+    /* full width rows are merged within a layer */
+    Opm::Box slab( globalBox, 0, 3, 1, 2, 0, 1 );
+    runs = boxRuns( slab );
+    BOOST_CHECK_EQUAL( runs.size(), 2U );
+    BOOST_CHECK_EQUAL( runs[0][0], 4U );
+    BOOST_CHECK_EQUAL( runs[0][2], 8U );
+    BOOST_CHECK_EQUAL( runs[1][0], 16U );
+    BOOST_CHECK_EQUAL( runs[1][1], 8U );
+
+    /* full layers are merged */
+    Opm::Box layer( globalBox, 0, 3, 0, 2, 1, 1 );
+    runs = boxRuns( layer );
+    BOOST_CHECK_EQUAL( runs.size(), 1U );
+    BOOST_CHECK_EQUAL( runs[0][0], 12U );
+    BOOST_CHECK_EQUAL( runs[0][2], 12U );
+
+    for( const auto& box : { globalBox, rows, slab, layer } ) {
+        std::vector< size_t > expanded;
+        box.forEachRun( [&]( size_t start, size_t offset, size_t length ) {
+            BOOST_CHECK_EQUAL( offset, expanded.size() );
+            for( size_t g = start; g < start + length; g++ )
+                expanded.push_back( g );
+        });
+
+        const std::vector< size_t > iterated( box.begin(), box.end() );
+        const auto& indexList = box.getIndexList();
+        BOOST_CHECK_EQUAL( iterated.size(), box.size() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( iterated.begin(), iterated.end(),
+                                       expanded.begin(), expanded.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( indexList.begin(), indexList.end(),
+                                       expanded.begin(), expanded.end() );
+    }
+
+    Opm::Box empty;
+    BOOST_CHECK( empty.begin() == empty.end() );
+    BOOST_CHECK( boxRuns( empty ).empty() );
+}
+
+
 BOOST_AUTO_TEST_CASE(BoxEqual) {
     Opm::Box globalBox1( 10,10,10 );
     Opm::Box globalBox2( 10,10,10 );
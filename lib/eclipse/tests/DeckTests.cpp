@@ -18,6 +18,8 @@
  */
 
 
+#include <cmath>
+#include <cstdlib>
 #include <stdexcept>
 #include <sstream>
 
@@ -27,11 +29,14 @@
 
 #include <opm/parser/eclipse/Deck/DeckOutput.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckDiff.hpp>
 #include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/ParserItem.hpp>
 #include <opm/parser/eclipse/Parser/ParserRecord.hpp>
 #include <opm/parser/eclipse/RawDeck/RawRecord.hpp>
+#include <opm/parser/eclipse/RawDeck/StarToken.hpp>
 
 using namespace Opm;
 
@@ -269,6 +274,22 @@ BOOST_AUTO_TEST_CASE(SetInDeck) {
     BOOST_CHECK_EQUAL( true , deckDoubleItem.defaultApplied(2) );
 }
 
+BOOST_AUTO_TEST_CASE(HasDefaultedValues) {
+    DeckItem item( "TEST", double() );
+    BOOST_CHECK( !item.hasDefaultedValues() );
+
+    item.push_back( 10.0, 100 );
+    item.push_back( 1.0 );
+    BOOST_CHECK( !item.hasDefaultedValues() );
+
+    item.push_backDefault( 1.0 );
+    BOOST_CHECK( item.hasDefaultedValues() );
+
+    DeckItem dummy( "TEST", int() );
+    dummy.push_backDummyDefault();
+    BOOST_CHECK( dummy.hasDefaultedValues() );
+}
+
 BOOST_AUTO_TEST_CASE(DummyDefaultsDouble) {
     DeckItem deckDoubleItem( "TEST", double() );
     BOOST_CHECK_EQUAL(deckDoubleItem.size(), 0);
@@ -574,6 +595,7 @@ BOOST_AUTO_TEST_CASE(DeckItemWrite) {
     item.push_back(3);
 
     item.write(w);
+    w.flush();
     {
         int v1,v2,v3;
         s >> v1;
@@ -618,6 +640,7 @@ ABC";
     out.end_record();
     out.end_keyword(true);
     out.write_string( out.keyword_sep );
+    out.flush();
 
     BOOST_CHECK_EQUAL( expected, s.str());
 }
@@ -632,6 +655,7 @@ BOOST_AUTO_TEST_CASE(DeckItemWriteDefault) {
         std::stringstream s;
         DeckOutput w(s);
         item.write( w );
+        w.flush();
         BOOST_CHECK_EQUAL( s.str() , "");
     }
 
@@ -640,11 +664,153 @@ BOOST_AUTO_TEST_CASE(DeckItemWriteDefault) {
         std::stringstream s;
         DeckOutput w(s);
         item.write( w );
+        w.flush();
         BOOST_CHECK_EQUAL( s.str() , "3* 13");
     }
 }
 
 
+BOOST_AUTO_TEST_CASE(DeckItemWriteRepeated) {
+    DeckItem item("TEST", int());
+    item.push_back(1, 3);
+    item.push_back(2);
+    item.push_backDefault(7);
+    item.push_backDefault(7);
+    item.push_back(3);
+    item.push_back(3);
+
+    std::stringstream s;
+    DeckOutput w(s);
+    item.write( w );
+    w.flush();
+    BOOST_CHECK_EQUAL( s.str() , "3*1 2 2* 2*3");
+}
+
+
+BOOST_AUTO_TEST_CASE(DeckOutputDoubleRoundTrip) {
+    const std::vector<double> values = { 0.1, 1.0/3, -2.5, 1e-300, 123456.789, 2.5e20, 1e15, 0.30000000000000004, 100, -0.0, 0.0 };
+    DeckItem item("TEST", double());
+    for (double v : values)
+        item.push_back( v );
+
+    std::stringstream s;
+    {
+        DeckOutput w(s);
+        item.write( w );
+    }
+
+    BOOST_CHECK_EQUAL( s.str().find(','), std::string::npos );
+    for (double v : values) {
+        std::string token;
+        s >> token;
+        BOOST_CHECK_EQUAL( std::strtod( token.c_str(), nullptr ), v );
+        BOOST_CHECK_EQUAL( std::signbit( readValueToken< double >( token ) ), std::signbit( v ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(DeckOutputParallelIdentical) {
+    DeckItem item("TEST", double());
+    item.push_backDefault( 1.0 );
+    for (size_t i = 0; i < 300000; i++) {
+        if (i % 1000 == 17)
+            item.push_backDefault( 1.0 );
+        else
+            item.push_back( 0.25 * (i / 3) + 1.0 / (1 + i % 7) );
+    }
+    item.push_backDefault( 1.0 );
+    item.push_backDefault( 1.0 );
+
+    for (size_t columns : { 1, 5, 16 }) {
+        std::stringstream serial;
+        std::stringstream parallel;
+        {
+            DeckOutput w(serial);
+            w.columns = columns;
+            w.start_keyword( "TEST" );
+            w.start_record( );
+            w.stash_default( );
+            item.write( w );
+            w.write<int>( 1 );
+            w.end_record( );
+        }
+        {
+            DeckOutput w(parallel);
+            w.columns = columns;
+            w.threads = 4;
+            w.start_keyword( "TEST" );
+            w.start_record( );
+            w.stash_default( );
+            item.write( w );
+            w.write<int>( 1 );
+            w.end_record( );
+        }
+        BOOST_CHECK( serial.str() == parallel.str() );
+    }
+
+    {
+        std::stringstream serial;
+        std::stringstream parallel;
+        serial << item;
+        {
+            DeckOutput w(parallel);
+            w.threads = 3;
+            item.write( w );
+        }
+        BOOST_CHECK( serial.str() == parallel.str() );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(ParseWriteParseRoundTrip) {
+    const char* input = R"(
+DIMENS
+  2 2 3 /
+
+EQLDIMS
+/
+
+GRID
+
+COORD
+  0 0 0 0 0 10  1 0 0 1 0 10  2 0 0 2 0 10
+  0 1 0 0 1 10  1 1 0 1 1 10  2 1 0 2 1 10
+  0 2 0 0 2 10  1 2 0 1 2 10  2 2 0 2 2 10 /
+
+ZCORN
+  16*1000 16*1000.5 16*1001.125 /
+
+PORO
+  0.25 0.25 0.25 0.1 0.3333333333333333 0.2 0.2 0.2 3*0.15 1e-5 /
+
+ACTNUM
+  11*1 0 /
+
+SOLUTION
+
+EQUIL
+  2000 1* 2100 2* 1.5 /
+)";
+
+    Parser parser;
+    ParseContext parseContext;
+    const auto deck1 = parser.parseString( input, parseContext );
+
+    std::stringstream s;
+    s << deck1;
+    const auto deck2 = parser.parseString( s.str(), parseContext );
+
+    BOOST_CHECK_EQUAL( deck1.size(), deck2.size() );
+    for (size_t index = 0; index < deck1.size(); index++) {
+        const auto& kw1 = deck1.getKeyword( index );
+        const auto& kw2 = deck2.getKeyword( index );
+        BOOST_CHECK_MESSAGE( kw1.equal( kw2, true, false ), "Keyword " + kw1.name() + " differs after round trip" );
+    }
+
+    BOOST_CHECK( s.str().find( "16*1000.5" ) != std::string::npos );
+}
+
+
 BOOST_AUTO_TEST_CASE(DeckItemWriteString) {
     DeckItem item("TEST", std::string());
     item.push_back("NO");
@@ -652,6 +818,7 @@ BOOST_AUTO_TEST_CASE(DeckItemWriteString) {
     std::stringstream s;
     DeckOutput w(s);
     item.write( w );
+    w.flush();
     BOOST_CHECK_EQUAL( s.str() , "'NO' 'YES'");
 }
 
@@ -674,6 +841,7 @@ BOOST_AUTO_TEST_CASE(RecordWrite) {
     std::stringstream s;
     DeckOutput w(s);
     deckRecord.write_data( w );
+    w.flush();
     BOOST_CHECK_EQUAL( s.str() , "123 1* 'VALUE'");
 }
 
@@ -710,3 +878,111 @@ BOOST_AUTO_TEST_CASE(DeckItemEqual) {
     BOOST_CHECK( item3.equal( item5 , false, true ));
     BOOST_CHECK( !item3.equal( item5 , false, false ));
 }
+
+
+BOOST_AUTO_TEST_CASE(DeckItemHash) {
+    DeckItem item1("TEST1" , double());
+    DeckItem item2("TEST1" , double());
+    DeckItem item3("TEST2" , double());
+
+    BOOST_CHECK_EQUAL( item1.hash() , item2.hash() );
+    BOOST_CHECK( item1.hash() != item3.hash() );
+
+    item1.push_back( 1.0 );
+    item1.push_back( 0.0 );
+    BOOST_CHECK( item1.hash() != item2.hash() );
+
+    item2.push_back( 1.0 );
+    item2.push_backDefault( -0.0 );
+    BOOST_CHECK_EQUAL( item1.hash() , item2.hash() );
+    BOOST_CHECK( item1.equal( item2 , false , false ));
+    BOOST_CHECK( !item1.equal( item2 , true , false ));
+
+    const auto h = item1.hash();
+    item1.push_back( 2.0, 3 );
+    BOOST_CHECK( item1.hash() != h );
+
+    DeckItem sitem1("S", std::string());
+    DeckItem sitem2("S", std::string());
+    sitem1.push_back( "AB" );
+    sitem1.push_back( "C" );
+    sitem2.push_back( "A" );
+    sitem2.push_back( "BC" );
+    BOOST_CHECK( sitem1.hash() != sitem2.hash() );
+    BOOST_CHECK( sitem1 != sitem2 );
+}
+
+
+BOOST_AUTO_TEST_CASE(DeckDiffKeywords) {
+    const std::string deck1_string =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 2 2 1 /\n"
+        "GRID\n"
+        "PORO\n"
+        " 4*0.25 /\n"
+        "SCHEDULE\n"
+        "WELSPECS\n"
+        " 'W1' 'G1' 1 1 1* 'OIL' /\n"
+        " 'W2' 'G1' 2 2 1* 'OIL' /\n"
+        "/\n"
+        "TSTEP\n"
+        " 10 /\n"
+        "TSTEP\n"
+        " 20 /\n";
+
+    const std::string deck2_string =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 2 2 1 /\n"
+        "GRID\n"
+        "PERMX\n"
+        " 4*100 /\n"
+        "SCHEDULE\n"
+        "WELSPECS\n"
+        " 'W1' 'G1' 1 1 1* 'OIL' /\n"
+        " 'W2' 'G1' 2 1 1* 'OIL' /\n"
+        " 'W3' 'G1' 1 2 1* 'OIL' /\n"
+        "/\n"
+        "TSTEP\n"
+        " 10 /\n"
+        "TSTEP\n"
+        " 30 /\n"
+        "TSTEP\n"
+        " 40 /\n";
+
+    Parser parser;
+    ParseContext parseContext;
+    auto deck1 = parser.parseString( deck1_string, parseContext );
+    auto deck2 = parser.parseString( deck2_string, parseContext );
+
+    BOOST_CHECK( DeckDiff( deck1, deck1 ).empty() );
+
+    DeckDiff diff( deck1, deck2 );
+    BOOST_REQUIRE_EQUAL( diff.size() , 5U );
+
+    BOOST_CHECK_EQUAL( diff[0].name , "PORO" );
+    BOOST_CHECK( diff[0].status == DeckDiff::Status::removed );
+
+    BOOST_CHECK_EQUAL( diff[1].name , "WELSPECS" );
+    BOOST_CHECK( diff[1].status == DeckDiff::Status::changed );
+    BOOST_CHECK_EQUAL( diff[1].changed_records.size() , 1U );
+    BOOST_CHECK_EQUAL( diff[1].changed_records[0] , 1U );
+    BOOST_CHECK_EQUAL( diff[1].added_records.size() , 1U );
+    BOOST_CHECK_EQUAL( diff[1].added_records[0] , 2U );
+    BOOST_CHECK( diff[1].removed_records.empty() );
+
+    BOOST_CHECK_EQUAL( diff[2].name , "TSTEP" );
+    BOOST_CHECK_EQUAL( diff[2].occurrence , 1U );
+    BOOST_CHECK( diff[2].status == DeckDiff::Status::changed );
+
+    BOOST_CHECK_EQUAL( diff[3].name , "PERMX" );
+    BOOST_CHECK( diff[3].status == DeckDiff::Status::added );
+    BOOST_CHECK_EQUAL( diff[4].name , "TSTEP" );
+    BOOST_CHECK_EQUAL( diff[4].occurrence , 2U );
+    BOOST_CHECK( diff[4].status == DeckDiff::Status::added );
+
+    std::stringstream ss;
+    ss << diff;
+    BOOST_CHECK( ss.str().find( "CHANGED WELSPECS[0] changed records: 1 added records: 2" ) != std::string::npos );
+}
@@ -17,6 +17,8 @@
  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 #include <boost/filesystem.hpp>
@@ -37,6 +39,7 @@
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 
 #include <opm/parser/eclipse/Units/Units.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
 
 static Opm::Deck createDeck() {
     const char *deckData = "RUNSPEC\n"
@@ -476,3 +479,239 @@ BOOST_AUTO_TEST_CASE(TEMPI_TEST) {
     Setup s(createDeck());
     BOOST_CHECK_NO_THROW( s.props.getDoubleGridProperty("TEMPI") );
 }
+
+BOOST_AUTO_TEST_CASE(CompressedProperties) {
+    const char* deckData = "RUNSPEC\n"
+            "DIMENS\n"
+            " 5 5 1 /\n"
+            "GRID\n"
+            "DX\n"
+            "25*0.25 /\n"
+            "DY\n"
+            "25*0.25 /\n"
+            "DZ\n"
+            "25*0.25 /\n"
+            "TOPS\n"
+            "25*0.25 /\n"
+            "ACTNUM\n"
+            " 10*1 5*0 10*1 /\n"
+            "PORO\n"
+            " 25*0.3 /\n"
+            "PERMX\n"
+            " 25*100 /\n"
+            "MULTNUM\n"
+            " 12*1 13*2 /\n"
+            "\n";
+
+    Opm::Parser parser;
+    Setup s( parser.parseString( deckData, Opm::ParseContext() ) );
+    s.grid.resetACTNUM( s.props.getIntGridProperty( "ACTNUM" ).getData().data() );
+
+    const auto permx = s.props.getDoubleGridProperty( "PERMX" ).getData();
+    const auto multnum = s.props.getIntGridProperty( "MULTNUM" ).getData();
+    const auto actnum = s.props.getIntGridProperty( "ACTNUM" ).getData();
+
+    s.props.compress( s.grid );
+
+    const auto& permxProperty = s.props.getDoubleGridProperty( "PERMX" );
+    const auto& multnumProperty = s.props.getIntGridProperty( "MULTNUM" );
+    const auto& actnumProperty = s.props.getIntGridProperty( "ACTNUM" );
+    BOOST_CHECK( permxProperty.isCompressed() );
+    BOOST_CHECK( multnumProperty.isCompressed() );
+    BOOST_CHECK( s.props.getDoubleGridProperty( "PORO" ).isCompressed() );
+    BOOST_CHECK( !actnumProperty.isCompressed() );
+
+    BOOST_CHECK_EQUAL( permxProperty.getActiveData().size(), 20U );
+    BOOST_CHECK_EQUAL( multnumProperty.getActiveData().size(), 20U );
+
+    for (size_t g = 0; g < 25; g++) {
+        BOOST_CHECK_EQUAL( actnumProperty.iget( g ), actnum[g] );
+        if (actnum[g]) {
+            BOOST_CHECK_EQUAL( permxProperty.iget( g ), permx[g] );
+            BOOST_CHECK_EQUAL( multnumProperty.iget( g ), multnum[g] );
+        } else {
+            /* the PERMX default is NaN */
+            BOOST_CHECK( std::isnan( permxProperty.iget( g ) ) );
+            BOOST_CHECK_EQUAL( multnumProperty.iget( g ), 1 );
+        }
+    }
+
+    const auto compressed = permxProperty.compressedCopy( s.grid );
+    BOOST_CHECK( permxProperty.isCompressed() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( compressed.begin(), compressed.end(),
+                                   permxProperty.getActiveData().begin(),
+                                   permxProperty.getActiveData().end() );
+
+    /* the full array is available, with defaulted inactive cells, and
+       the property stays compressed */
+    const auto& expanded = permxProperty.getData();
+    BOOST_CHECK( permxProperty.isCompressed() );
+    BOOST_CHECK_EQUAL( expanded.size(), 25U );
+    for (size_t g = 0; g < 25; g++) {
+        if (actnum[g])
+            BOOST_CHECK_EQUAL( expanded[g], permx[g] );
+        else
+            BOOST_CHECK( std::isnan( expanded[g] ) );
+    }
+
+    const auto regions = s.props.getRegions( "MULTNUM" );
+    BOOST_CHECK_EQUAL( regions.size(), 2U );
+}
+
+BOOST_AUTO_TEST_CASE(FinalizeMatchesLazyEvaluation) {
+    const char* deckData = "RUNSPEC\n"
+            "OIL\n"
+            "GAS\n"
+            "WATER\n"
+            "DIMENS\n"
+            " 4 4 3 /\n"
+            "TABDIMS\n"
+            " 2 /\n"
+            "GRID\n"
+            "DX\n"
+            "48*0.25 /\n"
+            "DY\n"
+            "48*0.25 /\n"
+            "DZ\n"
+            "48*0.25 /\n"
+            "TOPS\n"
+            "16*0.25 /\n"
+            "PORO\n"
+            " 16*0.3 /\n"
+            "PERMX\n"
+            " 8*100 8*200 /\n"
+            "MULTNUM\n"
+            " 24*1 24*2 /\n"
+            "MULTREGP\n"
+            " 2 0.5 M /\n"
+            "/\n"
+            "PROPS\n"
+            "SWOF\n"
+            " .2  .0 1.0 .0\n"
+            " 1.0 1.0 .0 .0 /\n"
+            " .1  .0 1.0 .0\n"
+            " .9 1.0 .0 .0 /\n"
+            "SGOF\n"
+            " .0  .0 1.0 .0\n"
+            " .8 1.0  .0 .0 /\n"
+            " .0  .0 1.0 .0\n"
+            " .7 1.0  .0 .0 /\n"
+            "REGIONS\n"
+            "SATNUM\n"
+            " 20*1 28*2 /\n"
+            "\n";
+
+    const std::vector< std::string > keywords = { "SWL", "SWU", "SWCR", "SGL", "SGU", "SOWCR",
+                                                  "KRW", "PCW", "ISWL", "SWLX", "TEMPI",
+                                                  "PORV", "ACTNUM", "PERMX", "PORO" };
+
+    Opm::Parser parser;
+    Setup lazy( parser.parseString( deckData, Opm::ParseContext() ) );
+    Setup eager( parser.parseString( deckData, Opm::ParseContext() ) );
+
+    Opm::GridKernels::setThreads( 4 );
+    eager.props.finalize( keywords );
+    Opm::GridKernels::setThreads( 0 );
+
+    for (const auto& keyword : keywords) {
+        if (keyword == "ACTNUM") {
+            const auto& expected = lazy.props.getIntGridProperty( keyword ).getData();
+            const auto& actual = eager.props.getIntGridProperty( keyword ).getData();
+            BOOST_CHECK_EQUAL_COLLECTIONS( expected.begin(), expected.end(), actual.begin(), actual.end() );
+        } else {
+            const auto& expected = lazy.props.getDoubleGridProperty( keyword ).getData();
+            const auto& actual = eager.props.getDoubleGridProperty( keyword ).getData();
+            BOOST_CHECK_EQUAL_COLLECTIONS( expected.begin(), expected.end(), actual.begin(), actual.end() );
+        }
+    }
+
+    /* the PORV region multiplier, and the same auto generated properties */
+    BOOST_CHECK_CLOSE( eager.props.getDoubleGridProperty( "PORV" ).iget( 47 ),
+                       0.5 * 0.3 * 0.25 * 0.25 * 0.25, 1e-10 );
+
+    std::vector< std::string > lazyNames, eagerNames;
+    for (const auto& property : lazy.props.getIntProperties())
+        lazyNames.push_back( property.getKeywordName() );
+    for (const auto& property : lazy.props.getDoubleProperties())
+        lazyNames.push_back( property.getKeywordName() );
+    for (const auto& property : eager.props.getIntProperties())
+        eagerNames.push_back( property.getKeywordName() );
+    for (const auto& property : eager.props.getDoubleProperties())
+        eagerNames.push_back( property.getKeywordName() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( lazyNames.begin(), lazyNames.end(), eagerNames.begin(), eagerNames.end() );
+
+    BOOST_CHECK_THROW( eager.props.finalize( { "NOT_A_PROPERTY" } ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(EqualregOnRegionArray) {
+    const char* deckData = "RUNSPEC\n"
+            "DIMENS\n"
+            " 4 1 1 /\n"
+            "GRID\n"
+            "DX\n"
+            "4*0.25 /\n"
+            "DY\n"
+            "4*0.25 /\n"
+            "DZ\n"
+            "4*0.25 /\n"
+            "TOPS\n"
+            "4*0.25 /\n"
+            "MULTNUM\n"
+            " 1 1 2 2 /\n"
+            "EQUALREG\n"
+            " MULTNUM 3 1 M /\n"
+            " MULTNUM 7 3 M /\n"
+            " FLUXNUM 9 3 M /\n"
+            "/\n"
+            "\n";
+
+    Opm::Parser parser;
+    Setup s( parser.parseString( deckData, Opm::ParseContext() ) );
+
+    /* the records see the MULTNUM values written by the records before them */
+    const std::vector< int > multnum = { 7, 7, 2, 2 };
+    const std::vector< int > fluxnum = { 1, 1, 1, 1 };
+    const auto& multnumData = s.props.getIntGridProperty( "MULTNUM" ).getData();
+    const auto& fluxnumData = s.props.getIntGridProperty( "FLUXNUM" ).getData();
+    BOOST_CHECK_EQUAL_COLLECTIONS( multnumData.begin(), multnumData.end(), multnum.begin(), multnum.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( fluxnumData.begin(), fluxnumData.end(), fluxnum.begin(), fluxnum.end() );
+}
+
+BOOST_AUTO_TEST_CASE(CopyFromSparseSourceUpdatedLater) {
+    const char* deckData = "RUNSPEC\n"
+            "DIMENS\n"
+            " 100 10 100 /\n"
+            "GRID\n"
+            "DX\n"
+            "100000*0.25 /\n"
+            "DY\n"
+            "100000*0.25 /\n"
+            "DZ\n"
+            "100000*0.25 /\n"
+            "TOPS\n"
+            "1000*0.25 /\n"
+            "PERMX\n"
+            "100000*7 /\n"
+            "EQUALS\n"
+            " MULTX 2 /\n"
+            "/\n"
+            "COPY\n"
+            " MULTX PERMX /\n"
+            "/\n"
+            "MULTIPLY\n"
+            " MULTX 3 1 1 1 1 1 1 /\n"
+            "/\n"
+            "\n";
+
+    Opm::Parser parser;
+    Setup s( parser.parseString( deckData, Opm::ParseContext() ) );
+
+    /* the COPY sees MULTX before the MULTIPLY of the following record */
+    const auto& multx = s.props.getDoubleGridProperty( "MULTX" );
+    const auto& permx = s.props.getDoubleGridProperty( "PERMX" ).getData();
+    BOOST_CHECK( multx.isSparse() );
+    BOOST_CHECK_EQUAL( multx.iget( 0 ), 6 );
+    BOOST_CHECK_EQUAL( multx.iget( 1 ), 2 );
+    BOOST_CHECK_EQUAL( permx.size(), 100000U );
+    BOOST_CHECK( std::all_of( permx.begin(), permx.end(), []( double v ) { return v == 2; } ) );
+}
@@ -17,10 +17,14 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 #include <boost/filesystem.hpp>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 
 #define BOOST_TEST_MODULE EclipseGridTests
 #include <boost/test/unit_test.hpp>
@@ -33,11 +37,16 @@
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/CartesianGeometry.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EGRIDFile.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridDims.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridGeometry.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridSpatialIndex.hpp>
 
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
 
 
 BOOST_AUTO_TEST_CASE(CreateMissingDIMENS_throws) {
@@ -1087,6 +1096,853 @@ BOOST_AUTO_TEST_CASE(ZcornMapper) {
 }
 
 
+/*
+  Reference implementation of the fixup, one pillar corner at a time
+  with the checked index() method.
+*/
+static size_t referenceFixup( const Opm::ZcornMapper& zmp , size_t nx , size_t ny , size_t nz , std::vector<double>& zcorn) {
+    size_t adjusted = 0;
+    for (size_t k = 0; k < nz; k++)
+        for (size_t j = 0; j < ny; j++)
+            for (size_t i = 0; i < nx; i++)
+                for (int c = 0; c < 4; c++) {
+                    if (k > 0) {
+                        auto index1 = zmp.index(i,j,k-1,c+4);
+                        auto index2 = zmp.index(i,j,k,c);
+                        if (zcorn[index2] < zcorn[index1]) {
+                            zcorn[index2] = zcorn[index1];
+                            adjusted++;
+                        }
+                    }
+
+                    auto index1 = zmp.index(i,j,k,c);
+                    auto index2 = zmp.index(i,j,k,c+4);
+                    if (zcorn[index2] < zcorn[index1]) {
+                        zcorn[index2] = zcorn[index1];
+                        adjusted++;
+                    }
+                }
+    return adjusted;
+}
+
+
+BOOST_AUTO_TEST_CASE(ZcornFixupCrossingLayers) {
+    const size_t nx = 70 , ny = 50 , nz = 30;
+    Opm::ZcornMapper zmp( nx , ny , nz );
+    std::vector<double> zcorn( zmp.size() );
+
+    /* Layers with thickness in [-1.5, 4.5) cross each other frequently. */
+    unsigned int seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<double>((seed >> 16) % 1000) / 1000;
+    };
+
+    for (size_t j = 0; j < ny; j++)
+        for (size_t i = 0; i < nx; i++)
+            for (int c = 0; c < 4; c++) {
+                double z = 1000;
+                for (size_t k = 0; k < nz; k++) {
+                    z += 6 * next() - 1.5;
+                    zcorn[ zmp.index(i,j,k,c) ] = z;
+                    z += 6 * next() - 1.5;
+                    zcorn[ zmp.index(i,j,k,c+4) ] = z;
+                }
+            }
+    zcorn[ zmp.index(0,0,nz-1,4) ] = 2000;
+
+    auto expected = zcorn;
+    const auto expected_adjusted = referenceFixup( zmp , nx , ny , nz , expected );
+    BOOST_CHECK( expected_adjusted > 0 );
+    BOOST_CHECK( !zmp.validZCORN( zcorn ));
+
+    const auto adjusted = zmp.fixupZCORN( zcorn );
+    BOOST_CHECK_EQUAL( adjusted , expected_adjusted );
+    BOOST_CHECK( zcorn == expected );
+    BOOST_CHECK( zmp.validZCORN( zcorn ));
+    BOOST_CHECK_EQUAL( zmp.fixupZCORN( zcorn ) , 0U );
+
+    std::vector<double> short_zcorn( zmp.size() - 1 );
+    BOOST_CHECK_THROW( zmp.fixupZCORN( short_zcorn ) , std::invalid_argument );
+}
+
+
+static Opm::EclipseGrid faultedGrid( int nx, int ny, int nz ) {
+    std::array<int, 3> dims = {{ nx, ny, nz }};
+    std::vector<double> coord;
+    std::vector<double> zcorn( 8 * nx * ny * nz );
+
+    for (int j = 0; j <= ny; j++)
+        for (int i = 0; i <= nx; i++) {
+            std::vector<double> pillar = { 100.0 * i + 3 * j , 80.0 * j , 0,
+                                           100.0 * i + 13 * j + 5 * i, 80.0 * j - 4 * i , 3000 };
+            coord.insert( coord.end() , pillar.begin() , pillar.end() );
+        }
+
+    Opm::ZcornMapper mapper( nx , ny , nz );
+    for (int k = 0; k < nz; k++)
+        for (int j = 0; j < ny; j++)
+            for (int i = 0; i < nx; i++)
+                for (int c = 0; c < 4; c++) {
+                    const int pi = i + (c & 1);
+                    const int pj = j + ((c >> 1) & 1);
+                    const double fault = i >= nx / 2 ? 15 : 0;
+                    const double top = 2000 + 20 * k + 3 * pi + 2 * pj + fault;
+
+                    zcorn[ mapper.index( i , j , k , c ) ] = top;
+                    zcorn[ mapper.index( i , j , k , c + 4 ) ] = top + 20 + 0.5 * pi;
+                }
+
+    return Opm::EclipseGrid( dims , coord , zcorn );
+}
+
+BOOST_AUTO_TEST_CASE(GridGeometryMatchesERT) {
+    const auto grid = faultedGrid( 6 , 5 , 4 );
+    const Opm::GridGeometry geometry( grid );
+
+    BOOST_CHECK_EQUAL( geometry.size() , grid.getCartesianSize() );
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        const auto center = grid.getCellCenter( g );
+        const auto cell_dims = grid.getCellDims( g );
+
+        BOOST_CHECK_CLOSE( geometry.volume()[g] , grid.getCellVolume( g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.centerX()[g] , center[0] , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.centerY()[g] , center[1] , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.depth()[g] , grid.getCellDepth( g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.thickness()[g] , grid.getCellThicknes( g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.dx()[g] , cell_dims[0] , 1e-8 );
+        BOOST_CHECK_CLOSE( geometry.dy()[g] , cell_dims[1] , 1e-8 );
+    }
+}
+
+/*
+  Single cells with hard-coded reference values: a 10 x 10 x 5 cell on
+  pillars sheared 0.5 in x per unit depth, where the tetrahedra are
+  exact, and a 10 x 10 x 10 cell with one top corner raised 2 units.
+  The exact volume of the warped cell is 950; the six tetrahedra around
+  the 0-7 diagonal give 933 1/3 with corner 3 raised and 966 2/3 with
+  corner 1 raised.
+*/
+static Opm::GridGeometry singleCell( double shear, const std::array<double,4>& top, double bottom ) {
+    std::vector<double> coord;
+    for (int pj = 0; pj < 2; pj++)
+        for (int pi = 0; pi < 2; pi++) {
+            const double x = 10 * pi, y = 10 * pj;
+            for (double v : { x , y , 1000.0 , x + 10 * shear , y , 1010.0 })
+                coord.push_back( v );
+        }
+
+    std::vector<double> zcorn( top.begin() , top.end() );
+    zcorn.insert( zcorn.end() , 4 , bottom );
+    return Opm::GridGeometry( Opm::GridDims( 1 , 1 , 1 ) , coord , zcorn );
+}
+
+BOOST_AUTO_TEST_CASE(GridGeometryReferenceCells) {
+    const auto sheared = singleCell( 0.5 , {{ 1000 , 1000 , 1000 , 1000 }} , 1005 );
+    BOOST_CHECK_CLOSE( sheared.volume()[0] , 500 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.centerX()[0] , 6.25 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.centerY()[0] , 5 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.depth()[0] , 1002.5 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.thickness()[0] , 5 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.dx()[0] , 10 , 1e-10 );
+    BOOST_CHECK_CLOSE( sheared.dy()[0] , 10 , 1e-10 );
+
+    const auto warped3 = singleCell( 0 , {{ 1000 , 1000 , 1000 , 1002 }} , 1010 );
+    BOOST_CHECK_CLOSE( warped3.volume()[0] , 2800.0 / 3 , 1e-10 );
+    BOOST_CHECK_CLOSE( warped3.depth()[0] , 1005.25 , 1e-10 );
+    BOOST_CHECK_CLOSE( warped3.thickness()[0] , 9.5 , 1e-10 );
+
+    const auto warped1 = singleCell( 0 , {{ 1000 , 1002 , 1000 , 1000 }} , 1010 );
+    BOOST_CHECK_CLOSE( warped1.volume()[0] , 2900.0 / 3 , 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE(GridGeometrySpan) {
+    const auto grid = faultedGrid( 7 , 3 , 5 );
+    const Opm::GridGeometry all( grid );
+    const Opm::GridGeometry span( grid , 10 , 53 );
+
+    BOOST_CHECK_EQUAL( span.size() , 43U );
+    BOOST_CHECK_EQUAL( span.first() , 10U );
+    for (size_t n = 0; n < span.size(); n++) {
+        BOOST_CHECK_EQUAL( span.volume()[n] , all.volume()[n + 10] );
+        BOOST_CHECK_EQUAL( span.depth()[n] , all.depth()[n + 10] );
+    }
+
+    BOOST_CHECK_THROW( Opm::GridGeometry( grid , 10 , grid.getCartesianSize() + 1 ) , std::invalid_argument );
+
+    const Opm::EclipseGrid box( 4 , 3 , 2 , 10 , 20 , 5 );
+    const Opm::GridGeometry box_geometry( box );
+    for (size_t g = 0; g < box.getCartesianSize(); g++) {
+        BOOST_CHECK_CLOSE( box_geometry.volume()[g] , 1000 , 1e-10 );
+        BOOST_CHECK_CLOSE( box_geometry.thickness()[g] , 5 , 1e-10 );
+    }
+}
+
+static void checkIndexMaps( const Opm::EclipseGrid& grid ) {
+    const ecl_grid_type * ert_grid = grid.c_ptr();
+    const auto& active_map = grid.getActiveMap();
+    const auto& global_map = grid.getGlobalMap();
+
+    BOOST_CHECK_EQUAL( grid.getNumActive() , size_t( ecl_grid_get_nactive( ert_grid )));
+    BOOST_CHECK_EQUAL( active_map.size() , grid.getNumActive() );
+    BOOST_CHECK_EQUAL( global_map.size() , grid.getCartesianSize() );
+
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        const int active_index = ecl_grid_get_active_index1( ert_grid , g );
+        BOOST_CHECK_EQUAL( global_map[g] , active_index );
+        BOOST_CHECK_EQUAL( grid.cellActive( g ) , active_index >= 0 );
+        if (active_index >= 0)
+            BOOST_CHECK_EQUAL( grid.activeIndex( g ) , size_t( active_index ));
+        else
+            BOOST_CHECK_THROW( grid.activeIndex( g ) , std::invalid_argument );
+    }
+
+    for (size_t a = 0; a < grid.getNumActive(); a++) {
+        BOOST_CHECK_EQUAL( active_map[a] , ecl_grid_get_global_index1A( ert_grid , a ));
+        BOOST_CHECK_EQUAL( grid.getGlobalIndex( a ) , size_t( active_map[a] ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ActiveIndexMaps) {
+    const size_t nx = 7, ny = 6, nz = 5;
+    Opm::EclipseGrid grid( nx , ny , nz );
+    checkIndexMaps( grid );
+
+    /* Irregular pattern with the layers k = 0 and k = 3 inactive. */
+    std::vector<int> actnum( grid.getCartesianSize() );
+    for (size_t g = 0; g < actnum.size(); g++) {
+        const size_t k = g / (nx * ny);
+        actnum[g] = (k == 0 || k == 3) ? 0 : ((g * 7) % 5 != 0);
+    }
+    grid.resetACTNUM( actnum.data() );
+    checkIndexMaps( grid );
+
+    std::vector<double> global( grid.getCartesianSize() );
+    for (size_t g = 0; g < global.size(); g++)
+        global[g] = 0.5 * g;
+
+    const auto compressed = grid.compressedVector( global );
+    BOOST_CHECK_EQUAL( compressed.size() , grid.getNumActive() );
+    const auto expanded = grid.expandedVector( compressed , -1.0 );
+    for (size_t g = 0; g < global.size(); g++)
+        BOOST_CHECK_EQUAL( expanded[g] , actnum[g] ? global[g] : -1.0 );
+    BOOST_CHECK_THROW( grid.expandedVector( global , 0.0 ) , std::invalid_argument );
+
+    /* The maps are copied, and follow the actnum of a processed copy. */
+    const Opm::EclipseGrid copy( grid );
+    BOOST_CHECK( copy.getActiveMap() == grid.getActiveMap() );
+    checkIndexMaps( Opm::EclipseGrid( grid , std::vector<int>( grid.getCartesianSize() , 1 )));
+
+    /* All inactive, and back to all active */
+    std::vector<int> inactive( grid.getCartesianSize() , 0 );
+    grid.resetACTNUM( inactive.data() );
+    BOOST_CHECK_EQUAL( grid.getNumActive() , 0U );
+    checkIndexMaps( grid );
+    BOOST_CHECK( grid.compressedVector( global ).empty() );
+
+    grid.resetACTNUM( nullptr );
+    BOOST_CHECK( grid.allActive() );
+    checkIndexMaps( grid );
+}
+
+
+/*
+  Compares the implicit geometry with the ERT grid created from it by
+  c_ptr().
+*/
+static void checkImplicitGeometry( const Opm::EclipseGrid& grid ) {
+    BOOST_CHECK( grid.getCartesianGeometry() != nullptr );
+
+    std::vector<double> zcorn;
+    std::vector<double> coord;
+    grid.exportZCORN( zcorn );
+    grid.exportCOORD( coord );
+
+    const ecl_grid_type * ert_grid = grid.c_ptr();
+    BOOST_CHECK_EQUAL( size_t( ecl_grid_get_nactive( ert_grid )) , grid.getNumActive() );
+
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        double x, y, z;
+        ecl_grid_get_xyz1( ert_grid , g , &x , &y , &z );
+        const auto center = grid.getCellCenter( g );
+        const auto dims = grid.getCellDims( g );
+
+        BOOST_CHECK_CLOSE( grid.getCellVolume( g ) , ecl_grid_get_cell_volume1( ert_grid , g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( grid.getCellDepth( g ) , ecl_grid_get_cdepth1( ert_grid , g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( grid.getCellThicknes( g ) , ecl_grid_get_cell_thickness1( ert_grid , g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( dims[0] , ecl_grid_get_cell_dx1( ert_grid , g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( dims[1] , ecl_grid_get_cell_dy1( ert_grid , g ) , 1e-8 );
+        BOOST_CHECK_CLOSE( center[0] , x , 1e-8 );
+        BOOST_CHECK_CLOSE( center[1] , y , 1e-8 );
+        BOOST_CHECK_CLOSE( center[2] , z , 1e-8 );
+    }
+
+    std::vector<double> ert_zcorn( ecl_grid_get_zcorn_size( ert_grid ));
+    ecl_grid_init_zcorn_data_double( ert_grid , ert_zcorn.data() );
+    BOOST_CHECK( zcorn == ert_zcorn );
+
+    /* The z coordinates of the pillars are not compared. */
+    std::vector<double> ert_coord( ecl_grid_get_coord_size( ert_grid ));
+    ecl_grid_init_coord_data_double( ert_grid , ert_coord.data() );
+    BOOST_CHECK_EQUAL( coord.size() , ert_coord.size() );
+    for (size_t n = 0; n < coord.size(); n++)
+        if (n % 3 != 2)
+            BOOST_CHECK_CLOSE( coord[n] , ert_coord[n] , 1e-8 );
+
+    for (size_t c = 0; c < 8; c++) {
+        const auto pos = grid.getCartesianGeometry()->getCornerPos( 2 , 1 , 3 , c );
+        double x, y, z;
+        ecl_grid_get_cell_corner_xyz3( ert_grid , 2 , 1 , 3 , c , &x , &y , &z );
+        BOOST_CHECK_CLOSE( pos[0] , x , 1e-8 );
+        BOOST_CHECK_CLOSE( pos[1] , y , 1e-8 );
+        BOOST_CHECK_CLOSE( pos[2] , z , 1e-8 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ImplicitCartesianGeometry) {
+    const char* dxv_deck =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 5 4 6 /\n"
+        "GRID\n"
+        "DXV\n"
+        "10 20 30 40 50 /\n"
+        "DYV\n"
+        "5 15 25 35 /\n"
+        "DZV\n"
+        "1 2 3 4 5 6 /\n"
+        "TOPS\n"
+        "20*1000 /\n"
+        "ACTNUM\n"
+        "20*0 100*1 /\n";
+
+    Opm::Parser parser;
+    {
+        Opm::EclipseGrid grid( parser.parseString( dxv_deck , Opm::ParseContext() ));
+        BOOST_CHECK_EQUAL( grid.getNumActive() , 100U );
+        BOOST_CHECK_CLOSE( grid.getCellDepth( 2 , 1 , 3 ) , 1000 + 1 + 2 + 3 + 2 , 1e-10 );
+        checkImplicitGeometry( grid );
+    }
+
+    std::string dx_deck =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 5 4 6 /\n"
+        "GRID\n"
+        "DX\n";
+    for (size_t g = 0; g < 120; g++) dx_deck += std::to_string( 10 + (g % 5) ) + " ";
+    dx_deck += "/\nDY\n";
+    for (size_t g = 0; g < 120; g++) dx_deck += std::to_string( 20 + (g / 5) % 4 ) + " ";
+    dx_deck += "/\nDZ\n";
+    for (size_t g = 0; g < 120; g++) dx_deck += std::to_string( 1 + (g % 7) ) + " ";
+    dx_deck += "/\nTOPS\n";
+    for (size_t g = 0; g < 20; g++) dx_deck += std::to_string( 2000 + g ) + " ";
+    dx_deck += "/\n";
+
+    {
+        Opm::EclipseGrid grid( parser.parseString( dx_deck , Opm::ParseContext() ));
+
+        /* The cellwise x and y offsets are summed once, on first use */
+        Opm::MemoryUsage before;
+        grid.memoryUsage( before );
+        const auto center = grid.getCellCenter( 4 , 3 , 5 );
+        BOOST_CHECK_CLOSE( center[0] , 10 + 11 + 12 + 13 + 14.0 / 2 , 1e-10 );
+        BOOST_CHECK_CLOSE( center[1] , 20 + 21 + 22 + 23.0 / 2 , 1e-10 );
+
+        Opm::MemoryUsage after;
+        grid.memoryUsage( after );
+        BOOST_CHECK( after.get( "EclipseGrid/cartesian" ) > before.get( "EclipseGrid/cartesian" ) );
+
+        checkImplicitGeometry( grid );
+    }
+
+    {
+        Opm::EclipseGrid grid( 5 , 4 , 6 , 10 , 20 , 5 );
+
+        /* The per cell getters do not build the full geometry */
+        BOOST_CHECK_CLOSE( grid.getCellVolume( 37 ) , 10 * 20 * 5 , 1e-10 );
+        BOOST_CHECK_CLOSE( grid.getCellCenter( 2 , 1 , 3 )[0] , 25 , 1e-10 );
+        BOOST_CHECK_CLOSE( grid.getCellDepth( 37 ) , 5 + 2.5 , 1e-10 );
+
+        Opm::MemoryUsage usage;
+        grid.memoryUsage( usage );
+        BOOST_CHECK_EQUAL( usage.get( "EclipseGrid/ert" ) , 0U );
+        BOOST_CHECK_EQUAL( usage.get( "EclipseGrid/geometry" ) , 0U );
+        BOOST_CHECK( usage.get( "EclipseGrid/cartesian" ) > 0 );
+
+        std::vector<int> actnum( 120 , 1 );
+        actnum[7] = 0;
+        grid.resetACTNUM( actnum.data() );
+
+        /* ACTNUM only copies keep the implicit geometry */
+        const Opm::EclipseGrid copy( grid , std::vector<int>( 120 , 1 ));
+        BOOST_CHECK( copy.getCartesianGeometry() == grid.getCartesianGeometry() );
+        BOOST_CHECK( copy.allActive() );
+
+        checkImplicitGeometry( grid );
+        BOOST_CHECK( !ecl_grid_cell_active1( grid.c_ptr() , 7 ));
+
+        Opm::MemoryUsage after;
+        grid.memoryUsage( after );
+        BOOST_CHECK( after.get( "EclipseGrid/ert" ) > 0 );
+    }
+
+    BOOST_CHECK_THROW( Opm::CartesianGeometry( 2 , 2 , 2 , { 1 , 1 , 1 } , { 1 , 1 } , { 1 , 1 } , { 0 , 0 , 0 , 0 } ) , std::invalid_argument );
+}
+
+
+/*
+  Minimal writer for unformatted big-endian EGRID keywords, used to
+  create test input for the native EGRID reader.
+*/
+static void writeBigEndian( std::ofstream& stream , uint32_t value ) {
+    const char bytes[4] = { char( value >> 24 ) , char( value >> 16 ) , char( value >> 8 ) , char( value ) };
+    stream.write( bytes , 4 );
+}
+
+template <typename T>
+static void writeEGRIDKeyword( std::ofstream& stream , const std::string& name , const std::string& type , const std::vector<T>& data ) {
+    std::string padded = name;
+    padded.resize( 8 , ' ' );
+
+    writeBigEndian( stream , 16 );
+    stream.write( padded.data() , 8 );
+    writeBigEndian( stream , data.size() );
+    stream.write( type.data() , 4 );
+    writeBigEndian( stream , 16 );
+
+    for (size_t offset = 0; offset < data.size(); offset += 1000) {
+        const size_t n = std::min( data.size() - offset , size_t( 1000 ));
+        writeBigEndian( stream , 4 * n );
+        for (size_t i = 0; i < n; i++) {
+            uint32_t bits;
+            if (type == "REAL") {
+                const float value = data[offset + i];
+                std::memcpy( &bits , &value , 4 );
+            } else
+                bits = static_cast<uint32_t>( data[offset + i] );
+            writeBigEndian( stream , bits );
+        }
+        writeBigEndian( stream , 4 * n );
+    }
+}
+
+static void writeEGRID( const std::string& filename , const Opm::EclipseGrid& grid , bool lgr ) {
+    std::vector<double> coord , zcorn , mapaxes;
+    std::vector<int> actnum;
+    grid.exportCOORD( coord );
+    grid.exportZCORN( zcorn );
+    grid.exportMAPAXES( mapaxes );
+    grid.exportACTNUM( actnum );
+
+    std::ofstream stream( filename , std::ios::binary );
+    writeEGRIDKeyword( stream , "FILEHEAD" , "INTE" , std::vector<int>( 100 , 0 ));
+    if (mapaxes.size() == 6)
+        writeEGRIDKeyword( stream , "MAPAXES" , "REAL" , mapaxes );
+
+    std::vector<int> gridhead( 100 , 0 );
+    gridhead[0] = 1;
+    gridhead[1] = grid.getNX();
+    gridhead[2] = grid.getNY();
+    gridhead[3] = grid.getNZ();
+    writeEGRIDKeyword( stream , "GRIDHEAD" , "INTE" , gridhead );
+    writeEGRIDKeyword( stream , "COORD" , "REAL" , coord );
+    writeEGRIDKeyword( stream , "ZCORN" , "REAL" , zcorn );
+    if (!actnum.empty())
+        writeEGRIDKeyword( stream , "ACTNUM" , "INTE" , actnum );
+    writeEGRIDKeyword( stream , "ENDGRID" , "INTE" , std::vector<int>() );
+
+    if (lgr) {
+        writeEGRIDKeyword( stream , "LGR" , "INTE" , std::vector<int>( 2 , 1 ));
+        writeEGRIDKeyword( stream , "ENDLGR" , "INTE" , std::vector<int>() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LoadFromEGRID) {
+    const std::string filename = "LoadFromEGRID.EGRID";
+    const auto grid = faultedGrid( 12 , 10 , 6 );
+    std::vector<int> actnum( grid.getCartesianSize() , 1 );
+    for (size_t g = 0; g < actnum.size(); g += 7)
+        actnum[g] = 0;
+
+    std::array<int, 3> dims = {{ 12 , 10 , 6 }};
+    std::vector<double> coord , zcorn;
+    grid.exportCOORD( coord );
+    grid.exportZCORN( zcorn );
+    const std::vector<double> mapaxes = { 0 , 100 , 0 , 0 , 100 , 0 };
+    const Opm::EclipseGrid src( dims , coord , zcorn , actnum.data() , mapaxes.data() );
+
+    writeEGRID( filename , src , false );
+    {
+        Opm::EGRIDFile egrid( filename );
+        BOOST_CHECK( Opm::EGRIDFile::isEGRID( filename ));
+        BOOST_CHECK( !egrid.hasLGR() );
+        BOOST_CHECK_EQUAL( egrid.size( "ZCORN" ) , zcorn.size() );
+        BOOST_CHECK_THROW( egrid.getIntData( "ZCORN" ) , std::invalid_argument );
+        BOOST_CHECK_THROW( egrid.size( "PORO" ) , std::invalid_argument );
+    }
+
+    {
+        const Opm::EclipseGrid loaded( filename );
+        BOOST_CHECK_EQUAL( loaded.getNX() , 12U );
+        BOOST_CHECK_EQUAL( loaded.getNY() , 10U );
+        BOOST_CHECK_EQUAL( loaded.getNZ() , 6U );
+        BOOST_CHECK( loaded.equal( src ));
+        checkIndexMaps( loaded );
+
+        std::vector<double> loaded_coord , loaded_zcorn , loaded_mapaxes;
+        std::vector<int> loaded_actnum;
+        loaded.exportCOORD( loaded_coord );
+        loaded.exportZCORN( loaded_zcorn );
+        loaded.exportMAPAXES( loaded_mapaxes );
+        loaded.exportACTNUM( loaded_actnum );
+        BOOST_CHECK_EQUAL_COLLECTIONS( loaded_coord.begin() , loaded_coord.end() , coord.begin() , coord.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( loaded_zcorn.begin() , loaded_zcorn.end() , zcorn.begin() , zcorn.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( loaded_mapaxes.begin() , loaded_mapaxes.end() , mapaxes.begin() , mapaxes.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( loaded_actnum.begin() , loaded_actnum.end() , actnum.begin() , actnum.end() );
+
+        for (size_t g = 0; g < loaded.getCartesianSize(); g++)
+            BOOST_CHECK_CLOSE( loaded.getCellVolume( g ) , src.getCellVolume( g ) , 1e-8 );
+    }
+
+    /* Files with LGRs are left to ERT */
+    writeEGRID( filename , src , true );
+    BOOST_CHECK( Opm::EGRIDFile( filename ).hasLGR() );
+    BOOST_CHECK_THROW( Opm::EclipseGrid grid( filename ) , std::invalid_argument );
+
+    {
+        std::ofstream stream( filename , std::ios::binary );
+        writeEGRIDKeyword( stream , "FILEHEAD" , "INTE" , std::vector<int>( 100 , 0 ));
+        stream.write( "garbage" , 7 );
+    }
+    BOOST_CHECK( Opm::EGRIDFile::isEGRID( filename ));
+    BOOST_CHECK_THROW( Opm::EGRIDFile egrid( filename ) , std::invalid_argument );
+    BOOST_CHECK( !Opm::EGRIDFile::isEGRID( "No/does/not/exist" ));
+
+    std::remove( filename.c_str() );
+}
+
+
+BOOST_AUTO_TEST_CASE(SharedGeometryVariants) {
+    const auto base = faultedGrid( 6 , 5 , 4 );
+    const size_t size = base.getCartesianSize();
+
+    std::vector<Opm::EclipseGrid> variants;
+    for (size_t v = 0; v < 5; v++) {
+        std::vector<int> actnum( size , 1 );
+        for (size_t g = v; g < size; g += 7)
+            actnum[g] = 0;
+        variants.emplace_back( base , actnum );
+    }
+
+    /* The geometry cache is shared, also when it is built after the copies are made. */
+    const auto& volumes = variants[2].getCellVolumes();
+    BOOST_CHECK_EQUAL( &volumes , &base.getCellVolumes() );
+
+    for (size_t v = 0; v < variants.size(); v++) {
+        const auto& grid = variants[v];
+        BOOST_CHECK_EQUAL( grid.c_geometry_ptr() , base.c_geometry_ptr() );
+        BOOST_CHECK_EQUAL( &grid.getCellVolumes() , &volumes );
+        BOOST_CHECK( !grid.cellActive( v ));
+        BOOST_CHECK( grid.cellActive( v + 1 ));
+        checkIndexMaps( grid );
+
+        /* The ERT grid with the variant ACTNUM is created on request. */
+        BOOST_CHECK( grid.c_ptr() != base.c_ptr() );
+        BOOST_CHECK_EQUAL( size_t( ecl_grid_get_nactive( grid.c_ptr() )) , grid.getNumActive() );
+        BOOST_CHECK( !ecl_grid_cell_active1( grid.c_ptr() , v ));
+    }
+    BOOST_CHECK_EQUAL( size_t( ecl_grid_get_nactive( base.c_ptr() )) , size );
+    BOOST_CHECK( base.allActive() );
+
+    /* Copies share the ERT grid until ACTNUM is changed, without changing the source. */
+    Opm::EclipseGrid copy( base );
+    BOOST_CHECK_EQUAL( copy.c_ptr() , base.c_ptr() );
+
+    std::vector<int> actnum( size , 1 );
+    actnum[3] = 0;
+    copy.resetACTNUM( actnum.data() );
+    BOOST_CHECK_EQUAL( copy.c_geometry_ptr() , base.c_geometry_ptr() );
+    BOOST_CHECK( !ecl_grid_cell_active1( copy.c_ptr() , 3 ));
+    BOOST_CHECK( ecl_grid_cell_active1( base.c_ptr() , 3 ));
+    BOOST_CHECK( base.cellActive( 3 ));
+
+    /* A grid which is not shared is updated in place. */
+    const auto* ert_copy = copy.c_ptr();
+    copy.resetACTNUM( nullptr );
+    BOOST_CHECK_EQUAL( copy.c_ptr() , ert_copy );
+    BOOST_CHECK( ecl_grid_cell_active1( copy.c_ptr() , 3 ));
+
+    Opm::MemoryUsage usage;
+    variants[0].memoryUsage( usage );
+    BOOST_CHECK( usage.get( "EclipseGrid/ert" ) > 0 );
+}
+
+static std::vector<Opm::PinchNNC> processPinch( const std::string& keywords , const std::vector<double>& multz , std::vector<int>& actnum ) {
+    const std::string deck =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 2 1 7 /\n"
+        "GRID\n"
+        "DXV\n"
+        " 10 10 /\n"
+        "DYV\n"
+        " 10 /\n"
+        "DZV\n"
+        " 1 0.1 1 1 1 3 1 /\n"
+        "TOPS\n"
+        " 2*1000 /\n"
+        "ACTNUM\n"
+        " 10*1 0 3*1 /\n" + keywords;
+
+    Opm::Parser parser;
+    Opm::EclipseGrid grid( parser.parseString( deck , Opm::ParseContext() ));
+
+    /* Layer 3 has a small pore volume in both columns. */
+    std::vector<double> porv( grid.getCartesianSize() , 10.0 );
+    porv[6] = porv[7] = 0.5;
+
+    const auto nncs = grid.processPinch( porv , multz );
+    grid.exportACTNUM( actnum );
+    return nncs;
+}
+
+static void checkPinchNNC( const std::vector<Opm::PinchNNC>& nncs , const std::vector<std::array<double,3>>& expected ) {
+    BOOST_CHECK_EQUAL( nncs.size() , expected.size() );
+    for (size_t n = 0; n < std::min( nncs.size() , expected.size() ); n++) {
+        BOOST_CHECK_EQUAL( nncs[n].cell1 , size_t( expected[n][0] ));
+        BOOST_CHECK_EQUAL( nncs[n].cell2 , size_t( expected[n][1] ));
+        BOOST_CHECK_CLOSE( nncs[n].multz , expected[n][2] , 1e-10 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ProcessPinch) {
+    /*
+      Column i = 0, from the top: active, thin (0.1), active, small pore
+      volume, active, ACTNUM 0 (thickness 3), active. The cell in layer
+      k of that column has global index 2 * k. Column i = 1 is the same,
+      except that the cell in layer 5 is active.
+    */
+    const std::vector<double> multz = { 1 , 1 , 0.2 , 1 , 0.9 , 1 , 0.5 , 1 , 0.8 , 1 , 0.3 , 1 , 1 , 1 };
+    std::vector<int> actnum;
+
+    checkPinchNNC( processPinch( "" , {} , actnum ) , {} );
+    BOOST_CHECK_EQUAL( std::count( actnum.begin() , actnum.end() , 0 ) , 1 );
+
+    checkPinchNNC( processPinch( "MINPV\n 1 /\n" , {} , actnum ) , {} );
+    BOOST_CHECK_EQUAL( actnum[6] , 0 );
+    BOOST_CHECK_EQUAL( actnum[7] , 0 );
+    BOOST_CHECK_EQUAL( actnum[2] , 1 );
+
+    /* MINPVFIL connects across the removed cells also without PINCH. */
+    checkPinchNNC( processPinch( "MINPVFIL\n 1 /\n" , {} , actnum ) , {{ {{ 4 , 8 , 1 }} , {{ 5 , 9 , 1 }} }} );
+
+    /* PINCH with the default GAP option: the thin cell is pinched out, and the ACTNUM gap is bridged. */
+    checkPinchNNC( processPinch( "MINPV\n 1 /\nPINCH\n 0.5 /\n" , multz , actnum ) ,
+                   {{ {{ 0 , 4 , 1 }} , {{ 1 , 5 , 1 }} , {{ 4 , 8 , 0.9 }} , {{ 5 , 9 , 1 }} , {{ 8 , 12 , 0.8 }} }} );
+    BOOST_CHECK_EQUAL( actnum[2] , 0 );
+    BOOST_CHECK_EQUAL( actnum[3] , 0 );
+    BOOST_CHECK_EQUAL( std::count( actnum.begin() , actnum.end() , 0 ) , 5 );
+
+    checkPinchNNC( processPinch( "MINPV\n 1 /\nPINCH\n 0.5 NOGAP /\n" , multz , actnum ) ,
+                   {{ {{ 0 , 4 , 1 }} , {{ 1 , 5 , 1 }} , {{ 4 , 8 , 0.9 }} , {{ 5 , 9 , 1 }} }} );
+
+    checkPinchNNC( processPinch( "MINPV\n 1 /\nPINCH\n 0.5 GAP 2.0 /\n" , multz , actnum ) ,
+                   {{ {{ 0 , 4 , 1 }} , {{ 1 , 5 , 1 }} , {{ 4 , 8 , 0.9 }} , {{ 5 , 9 , 1 }} }} );
+
+    checkPinchNNC( processPinch( "MINPV\n 1 /\nPINCH\n 0.5 GAP 1* ALL ALL /\n" , multz , actnum ) ,
+                   {{ {{ 0 , 4 , 0.2 }} , {{ 1 , 5 , 1 }} , {{ 4 , 8 , 0.5 }} , {{ 5 , 9 , 1 }} , {{ 8 , 12 , 0.3 }} }} );
+
+    /* Without MINPV the small pore volume cell stays active. */
+    checkPinchNNC( processPinch( "PINCH\n 0.5 /\n" , {} , actnum ) , {{ {{ 0 , 4 , 1 }} , {{ 1 , 5 , 1 }} , {{ 8 , 12 , 1 }} }} );
+
+    Opm::EclipseGrid grid( 2 , 2 , 2 , 1 , 1 , 1 );
+    BOOST_CHECK_THROW( grid.processPinch( std::vector<double>( 7 , 1.0 )) , std::invalid_argument );
+    BOOST_CHECK_THROW( grid.processPinch( std::vector<double>( 8 , 1.0 ) , std::vector<double>( 2 , 1.0 )) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(ProcessPinchThinInactive) {
+    /* The middle cell is thin, and inactive in the input. */
+    const std::string deck =
+        "RUNSPEC\n"
+        "DIMENS\n"
+        " 1 1 3 /\n"
+        "GRID\n"
+        "DXV\n"
+        " 10 /\n"
+        "DYV\n"
+        " 10 /\n"
+        "DZV\n"
+        " 1 0.1 1 /\n"
+        "TOPS\n"
+        " 1000 /\n"
+        "ACTNUM\n"
+        " 1 0 1 /\n";
+    const std::vector<double> porv( 3 , 10.0 );
+
+    Opm::Parser parser;
+    {
+        /* NOGAP: an inactive cell is a gap, also when it is thinner than the threshold */
+        Opm::EclipseGrid grid( parser.parseString( deck + "PINCH\n 0.5 NOGAP /\n" , Opm::ParseContext() ));
+        checkPinchNNC( grid.processPinch( porv ) , {} );
+        BOOST_CHECK_EQUAL( grid.getNumActive() , 2U );
+    }
+
+    {
+        Opm::EclipseGrid grid( parser.parseString( deck + "PINCH\n 0.5 GAP /\n" , Opm::ParseContext() ));
+        checkPinchNNC( grid.processPinch( porv ) , {{ {{ 0 , 2 , 1 }} }} );
+    }
+
+    {
+        /* the empty gap is 0.1 thick */
+        Opm::EclipseGrid grid( parser.parseString( deck + "PINCH\n 0.5 GAP 0.05 /\n" , Opm::ParseContext() ));
+        checkPinchNNC( grid.processPinch( porv ) , {} );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SpatialIndexFindCell) {
+    const auto grid = faultedGrid( 8 , 7 , 5 );
+    const Opm::GridSpatialIndex index( grid );
+
+    std::vector<std::array<double,3>> centers;
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        centers.push_back( grid.getCellCenter( g ));
+        BOOST_CHECK_EQUAL( index.findCell( centers[g][0] , centers[g][1] , centers[g][2] ) , int( g ));
+    }
+
+    const auto cells = index.findCells( centers );
+    for (size_t g = 0; g < grid.getCartesianSize(); g++)
+        BOOST_CHECK_EQUAL( cells[g] , int( g ));
+
+    /* Pseudo random points compared with a brute force scan over all cells. */
+    unsigned int seed = 12345;
+    const auto random = [&seed]( double lo , double hi ) {
+        seed = seed * 1103515245 + 12345;
+        return lo + (hi - lo) * ((seed >> 8) & 0xFFFF) / 65535.0;
+    };
+
+    size_t found = 0;
+    for (int n = 0; n < 2000; n++) {
+        const double x = random( -50 , 1000 );
+        const double y = random( -50 , 700 );
+        const double z = random( 1990 , 2200 );
+
+        std::vector<int> brute_force;
+        for (size_t g = 0; g < grid.getCartesianSize(); g++)
+            if (index.cellContains( g , x , y , z ))
+                brute_force.push_back( g );
+
+        const int cell = index.findCell( x , y , z );
+        if (brute_force.empty())
+            BOOST_CHECK_EQUAL( cell , -1 );
+        else {
+            BOOST_CHECK( std::find( brute_force.begin() , brute_force.end() , cell ) != brute_force.end() );
+            found++;
+        }
+    }
+    BOOST_CHECK( found > 500 );
+    BOOST_CHECK_EQUAL( index.findCell( 0 , 0 , 5000 ) , -1 );
+    BOOST_CHECK_EQUAL( index.findCell( -1000 , 0 , 2050 ) , -1 );
+}
+
+BOOST_AUTO_TEST_CASE(SpatialIndexTraverse) {
+    const auto grid = faultedGrid( 8 , 7 , 5 );
+    const Opm::GridSpatialIndex index( grid );
+
+    /* A vertical segment through the middle of a column crosses all the layers in order. */
+    const auto center = grid.getCellCenter( 2 , 3 , 0 );
+    const auto column = index.traverse( {{ center[0] , center[1] , 1000 }} , {{ center[0] , center[1] , 4000 }} );
+    BOOST_CHECK_EQUAL( column.size() , grid.getNZ() );
+    for (size_t k = 0; k < column.size(); k++) {
+        BOOST_CHECK_EQUAL( column[k].global_index , grid.getGlobalIndex( 2 , 3 , k ));
+        BOOST_CHECK( column[k].exit > column[k].entry );
+        if (k > 0)
+            BOOST_CHECK_CLOSE( column[k].entry , column[k - 1].exit , 1e-8 );
+    }
+
+    /* A slanted segment through the fault compared with point location along the segment. */
+    const std::array<double,3> p0 = {{ 20 , 30 , 1995 }};
+    const std::array<double,3> p1 = {{ 780 , 520 , 2110 }};
+    const auto crossed = index.traverse( p0 , p1 );
+    const double length = std::sqrt( std::pow( p1[0] - p0[0] , 2 ) + std::pow( p1[1] - p0[1] , 2 ) + std::pow( p1[2] - p0[2] , 2 ));
+    BOOST_CHECK( crossed.size() > 10 );
+
+    for (size_t n = 0; n < crossed.size(); n++) {
+        const auto& cell = crossed[n];
+        const double t = 0.5 * (cell.entry + cell.exit) / length;
+        BOOST_CHECK( index.cellContains( cell.global_index ,
+                                         p0[0] + t * (p1[0] - p0[0]) ,
+                                         p0[1] + t * (p1[1] - p0[1]) ,
+                                         p0[2] + t * (p1[2] - p0[2]) ));
+        if (n > 0)
+            BOOST_CHECK( cell.entry >= crossed[n - 1].exit - 1e-6 );
+    }
+
+    for (int s = 0; s < 1000; s++) {
+        const double t = (s + 0.5) / 1000;
+        const int g = index.findCell( p0[0] + t * (p1[0] - p0[0]) , p0[1] + t * (p1[1] - p0[1]) , p0[2] + t * (p1[2] - p0[2]) );
+        if (g < 0)
+            continue;
+
+        const auto iter = std::find_if( crossed.begin() , crossed.end() , [g]( const Opm::GridSpatialIndex::Intersection& cell ) {
+                return cell.global_index == size_t( g );
+            });
+        BOOST_CHECK( iter != crossed.end() );
+        if (iter != crossed.end()) {
+            BOOST_CHECK( iter->entry <= t * length + 1e-6 );
+            BOOST_CHECK( iter->exit >= t * length - 1e-6 );
+        }
+    }
+
+    BOOST_CHECK( index.traverse( p0 , p0 ).empty() );
+    BOOST_CHECK( index.traverse( {{ -500 , -500 , 2000 }} , {{ -400 , -500 , 2000 }} ).empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE(GeometryCache) {
+    auto grid = faultedGrid( 6 , 5 , 4 );
+    std::vector<double> ert_volume;
+    std::vector<std::array<double,3>> ert_center;
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        ert_volume.push_back( grid.getCellVolume( g ) );
+        ert_center.push_back( grid.getCellCenter( g ) );
+    }
+
+    const auto& volumes = grid.getCellVolumes();
+    BOOST_CHECK_EQUAL( volumes.size() , grid.getCartesianSize() );
+    BOOST_CHECK_EQUAL( &volumes , &grid.getCellVolumes() );
+    for (size_t g = 0; g < grid.getCartesianSize(); g++) {
+        BOOST_CHECK_CLOSE( volumes[g] , ert_volume[g] , 1e-8 );
+        BOOST_CHECK_EQUAL( grid.getCellVolume( g ) , volumes[g] );
+        BOOST_CHECK_EQUAL( grid.getCellDepth( g ) , grid.getCellDepths()[g] );
+        BOOST_CHECK_EQUAL( grid.getCellThicknes( g ) , grid.getCellThicknesses()[g] );
+        for (size_t d = 0; d < 3; d++)
+            BOOST_CHECK_CLOSE( grid.getCellCenter( g )[d] , ert_center[g][d] , 1e-8 );
+    }
+    BOOST_CHECK_EQUAL( grid.getCellVolume( 1 , 2 , 3 ) , volumes[ grid.getGlobalIndex( 1 , 2 , 3 ) ] );
+
+    /* ACTNUM does not change the geometry */
+    std::vector<int> actnum( grid.getCartesianSize() , 1 );
+    actnum[0] = 0;
+    grid.resetACTNUM( actnum.data() );
+    BOOST_CHECK_EQUAL( &volumes , &grid.getCellVolumes() );
+
+    /* Copies share the geometry, unless ZCORN is changed. */
+    const Opm::EclipseGrid copy( grid );
+    BOOST_CHECK_EQUAL( &volumes , &copy.getCellVolumes() );
+
+    const Opm::EclipseGrid actnum_copy( grid , actnum );
+    BOOST_CHECK_EQUAL( &volumes , &actnum_copy.getCellVolumes() );
+
+    std::vector<double> zcorn;
+    grid.exportZCORN( zcorn );
+    for (auto& z : zcorn) z *= 2;
+    const Opm::EclipseGrid zcorn_copy( grid , zcorn , actnum );
+    BOOST_CHECK( &volumes != &zcorn_copy.getCellVolumes() );
+    BOOST_CHECK_CLOSE( zcorn_copy.getCellDepth( 7 ) , 2 * grid.getCellDepth( 7 ) , 1e-8 );
+}
+
+
 
 BOOST_AUTO_TEST_CASE(MoveTest) {
     int nx = 3;
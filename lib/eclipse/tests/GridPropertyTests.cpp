@@ -17,9 +17,12 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <sstream>
 
 #define BOOST_TEST_MODULE EclipseGridTests
 
@@ -37,7 +40,9 @@
 #include <opm/parser/eclipse/EclipseState/Grid/Box.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperties.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridPropertyEdits.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Utility/GridKernels.hpp>
 
 static const Opm::DeckKeyword createSATNUMKeyword( ) {
     const char* deckData =
@@ -152,6 +157,53 @@ BOOST_AUTO_TEST_CASE(SetFromDeckKeyword) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(SetFromDeckKeyword_box_and_defaults) {
+    const char* deckData =
+    "PERMX \n"
+    "  8*100 2* 6*200 / \n"
+    "PORO \n"
+    "  16*0.25 / \n"
+    "\n";
+
+    Opm::Parser parser;
+    Opm::Deck deck = parser.parseString(deckData, Opm::ParseContext());
+    const auto& permxKw = deck.getKeyword("PERMX");
+    const auto& poroKw = deck.getKeyword("PORO");
+    const auto& permxItem = permxKw.getRecord(0).getItem(0);
+    BOOST_CHECK( permxItem.hasDefaultedValues() );
+    BOOST_CHECK( !poroKw.getRecord(0).getItem(0).hasDefaultedValues() );
+
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    const Opm::Box global( 4, 4, 2 );
+    const Opm::Box layer( global, 0, 3, 0, 3, 1, 1 );
+    const Opm::Box columns( global, 1, 2, 0, 3, 0, 1 );
+
+    for (const auto* box : { &layer, &columns }) {
+        Opm::GridProperty<double> permx( 4, 4, 2, SupportedKeywordInfo( "PERMX", -1.0, "Permeability" ) );
+        Opm::GridProperty<double> poro( 4, 4, 2, SupportedKeywordInfo( "PORO", -1.0, "1" ) );
+        permx.loadFromDeckKeyword( *box, permxKw );
+        poro.loadFromDeckKeyword( *box, poroKw );
+
+        size_t offset = 0;
+        for (size_t g : *box) {
+            const double expected = permxItem.defaultApplied( offset ) ? -1.0 : permxItem.getSIDouble( offset );
+            BOOST_CHECK_EQUAL( permx.iget( g ), expected );
+            BOOST_CHECK_EQUAL( poro.iget( g ), 0.25 );
+            offset++;
+        }
+
+        size_t untouched = 0;
+        for (size_t g = 0; g < 32; g++)
+            untouched += poro.iget( g ) == -1.0;
+        BOOST_CHECK_EQUAL( untouched, 16U );
+    }
+
+    Opm::GridProperty<double> poro( 4, 4, 1, SupportedKeywordInfo( "PORO", -1.0, "1" ) );
+    poro.loadFromDeckKeyword( poroKw );
+    for (size_t g = 0; g < 16; g++)
+        BOOST_CHECK_EQUAL( poro.iget( g ), 0.25 );
+}
+
 BOOST_AUTO_TEST_CASE(copy) {
     typedef Opm::GridProperty<int>::SupportedKeywordInfo SupportedKeywordInfo;
     SupportedKeywordInfo keywordInfo1("P1", 0, "1");
@@ -488,6 +540,233 @@ BOOST_AUTO_TEST_CASE(mask_test) {
         BOOST_CHECK_EQUAL( p1.iget(g) , p2.iget(g));
 }
 
+BOOST_AUTO_TEST_CASE(region_cells) {
+    typedef Opm::GridProperty<int>::SupportedKeywordInfo SupportedKeywordInfo;
+    SupportedKeywordInfo keywordInfo("MULTNUM" , 1 , "1");
+    Opm::GridProperty<int> p( 5 , 5 , 4 , keywordInfo);
+
+    for (size_t g = 0; g < p.getCartesianSize(); g += 3)
+        p.iset( g , 3 );
+
+    {
+        const auto& index = p.regionCells();
+        BOOST_CHECK( index.cells( 2 ).empty() );
+        BOOST_CHECK( index.cells( 0 ).empty() );
+        BOOST_CHECK( index.cells( 100 ).empty() );
+
+        const auto cells = index.cells( 3 );
+        BOOST_CHECK_EQUAL( cells.size() , 34U );
+        size_t expected = 0;
+        for (auto g : cells) {
+            BOOST_CHECK_EQUAL( g , expected );
+            expected += 3;
+        }
+
+        BOOST_CHECK_EQUAL( index.cells( 1 ).size() + cells.size() , p.getCartesianSize() );
+        BOOST_CHECK_EQUAL( &p.regionCells() , &index );
+    }
+
+    /* modifying the property rebuilds the index */
+    p.iset( 1 , 3 );
+    BOOST_CHECK_EQUAL( p.regionCells().cells( 3 ).size() , 35U );
+    p.getData()[2] = 3;
+    BOOST_CHECK_EQUAL( p.regionCells().cells( 3 ).size() , 36U );
+
+    /* a sparse value range */
+    p.iset( 4 , 1000000 );
+    p.iset( 5 , -1000000 );
+    const auto& index = p.regionCells();
+    BOOST_CHECK_EQUAL( index.cells( 1000000 ).size() , 1U );
+    BOOST_CHECK_EQUAL( *index.cells( -1000000 ).begin() , 5U );
+    BOOST_CHECK_EQUAL( index.cells( 3 ).size() , 36U );
+    BOOST_CHECK( index.cells( 999999 ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE(compressed_storage) {
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    const size_t size = 4 * 3 * 2;
+    Opm::GridProperty<double> p( 4 , 3 , 2 , SupportedKeywordInfo( "P" , 7.0 , "1" ) );
+    auto globalMap = std::make_shared< std::vector< int > >( size, -1 );
+    int active = 0;
+    for (size_t g = 0; g < size; g++) {
+        p.iset( g , 0.5 * g );
+        if (g % 3 != 0)
+            (*globalMap)[g] = active++;
+    }
+
+    const auto before = p.memoryUsage();
+    BOOST_CHECK_THROW( p.getActiveData() , std::logic_error );
+    p.compress( globalMap );
+    BOOST_CHECK( p.isCompressed() );
+    BOOST_CHECK( p.memoryUsage() < before );
+    BOOST_CHECK_EQUAL( p.getCartesianSize() , size );
+    BOOST_CHECK_EQUAL( p.getActiveData().size() , size_t( active ) );
+
+    for (size_t g = 0; g < size; g++) {
+        const double expected = g % 3 != 0 ? 0.5 * g : 7.0;
+        BOOST_CHECK_EQUAL( p.iget( g ) , expected );
+    }
+    BOOST_CHECK_EQUAL( p.iget( 2 , 2 , 1 ) , 0.5 * 22 );
+    BOOST_CHECK_EQUAL( p.iget( 1 , 2 , 1 ) , 7.0 );
+    /* the eight inactive cells and cell 14 */
+    BOOST_CHECK_EQUAL( p.indexEqual( 7.0 ).size() , 9U );
+    BOOST_CHECK( !p.containsNaN() );
+    BOOST_CHECK_THROW( p.checkLimits( 0 , 6 ) , std::invalid_argument );
+    p.checkLimits( 0 , 12 );
+    BOOST_CHECK( p.isCompressed() );
+
+    /* modifying the property expands it */
+    p.iset( 0 , -1 );
+    BOOST_CHECK( !p.isCompressed() );
+    BOOST_CHECK_EQUAL( p.getData().size() , size );
+    BOOST_CHECK_EQUAL( p.iget( 0 ) , -1 );
+    BOOST_CHECK_EQUAL( p.iget( 3 ) , 7.0 );
+    BOOST_CHECK_EQUAL( p.iget( 4 ) , 2.0 );
+
+    auto shortMap = std::make_shared< std::vector< int > >( size - 1, 0 );
+    BOOST_CHECK_THROW( p.compress( shortMap ) , std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(sparse_storage) {
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    const size_t size = 10 * 10 * 10;
+    /* the same operations on a sparse and a dense property */
+    Opm::GridProperty<double> sparse( 10 , 10 , 10 , SupportedKeywordInfo( "MULTX" , 1.0 , "1" ) );
+    Opm::GridProperty<double> dense( 10 , 10 , 10 , SupportedKeywordInfo( "MULTX" ,
+        []( size_t n ) { return std::vector< double >( n, 1.0 ); } , "1" ) );
+    const auto check = [&]() {
+        for (size_t g = 0; g < size; g++)
+            BOOST_CHECK_EQUAL( sparse.iget( g ) , dense.iget( g ) );
+    };
+
+    BOOST_CHECK( sparse.isSparse() );
+    BOOST_CHECK( !dense.isSparse() );
+    BOOST_CHECK( sparse.memoryUsage() < size * sizeof( double ) );
+    BOOST_CHECK_THROW( sparse.iget( size ) , std::out_of_range );
+    BOOST_CHECK_THROW( sparse.iset( size , 0.5 ) , std::out_of_range );
+
+    const Opm::Box global( 10 , 10 , 10 );
+    const Opm::Box column( global , 2 , 2 , 3 , 3 , 0 , 9 );
+    const Opm::Box corner( global , 0 , 1 , 0 , 1 , 0 , 1 );
+    for (auto* p : { &sparse , &dense }) {
+        p->setScalar( 0.5 , column );
+        p->multiplyValueAtIndex( 5 , 0.25 );
+        p->iset( 7 , 3.0 );
+        p->iset( 7 , 1.0 );
+        p->scale( 2.0 , global );
+        p->add( 1.0 , corner );
+    }
+    BOOST_CHECK( sparse.isSparse() );
+    BOOST_CHECK_EQUAL( sparse.iget( 2 , 3 , 4 ) , 1.0 );
+    BOOST_CHECK_EQUAL( sparse.iget( 5 ) , 0.5 );
+    BOOST_CHECK_EQUAL( sparse.iget( 9 , 9 , 9 ) , 2.0 );
+    check();
+
+    BOOST_CHECK( !sparse.containsNaN() );
+    sparse.checkLimits( 0 , 3 );
+    BOOST_CHECK_THROW( sparse.checkLimits( 0 , 1.5 ) , std::invalid_argument );
+    BOOST_CHECK_EQUAL( sparse.indexEqual( 1.0 ).size() , 10U );
+
+    const Opm::EclipseGrid grid( 10 , 10 , 10 );
+    BOOST_CHECK( sparse.compressedCopy( grid ) == dense.compressedCopy( grid ) );
+
+    /* multiplying with a sparse property only visits the overrides */
+    Opm::GridProperty<double> multx( 10 , 10 , 10 , SupportedKeywordInfo( "MULTX" , 1.0 , "1" ) );
+    multx.setScalar( 0.1 , corner );
+    sparse.multiplyWith( multx );
+    dense.multiplyWith( multx );
+    BOOST_CHECK( sparse.isSparse() );
+    check();
+
+    /* a const read of the full array does not promote */
+    const auto& constSparse = sparse;
+    BOOST_CHECK_EQUAL( constSparse.getData().size() , size );
+    BOOST_CHECK_EQUAL( constSparse.getData()[5] , sparse.iget( 5 ) );
+    BOOST_CHECK( sparse.isSparse() );
+
+    /* a write to a large box promotes to full storage */
+    const Opm::Box layers( global , 0 , 9 , 0 , 9 , 3 , 4 );
+    sparse.setScalar( 4.0 , layers );
+    dense.setScalar( 4.0 , layers );
+    BOOST_CHECK( !sparse.isSparse() );
+    check();
+    BOOST_CHECK_EQUAL( sparse.getData().size() , size );
+
+    /* a global setScalar() only sets the constant */
+    Opm::GridProperty<int> satnum( 10 , 10 , 10 , Opm::GridProperty<int>::SupportedKeywordInfo( "SATNUM" , 1 , "1" ) );
+    satnum.setScalar( 3 , global );
+    BOOST_CHECK( satnum.isSparse() );
+    BOOST_CHECK_EQUAL( satnum.iget( 999 ) , 3 );
+    BOOST_CHECK_EQUAL( satnum.regionCells().cells( 3 ).size() , size );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_const_reads) {
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    const size_t size = 20 * 20 * 20;
+    Opm::GridProperty<double> p( 20 , 20 , 20 , SupportedKeywordInfo( "P" , 7.0 , "1" ) );
+    auto globalMap = std::make_shared< std::vector< int > >( size, -1 );
+    int active = 0;
+    for (size_t g = 0; g < size; g++) {
+        p.iset( g , 0.5 * g );
+        if (g % 3 != 0)
+            (*globalMap)[g] = active++;
+    }
+    p.compress( globalMap );
+
+    /* the const readers see the same full array and leave the storage alone */
+    const auto& cp = p;
+    const int readers = 16;
+    std::vector< const std::vector< double >* > views( readers );
+    std::vector< size_t > errors( readers, 0 );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(8)
+#endif
+    for (int r = 0; r < readers; r++) {
+        const auto& data = cp.getData();
+        views[r] = &data;
+        for (size_t g = 0; g < size; g++) {
+            const double expected = g % 3 != 0 ? 0.5 * g : 7.0;
+            if (data[g] != expected || cp.iget( g ) != expected)
+                errors[r]++;
+        }
+
+        std::vector< bool > mask;
+        cp.initMask( 7.0 , mask );
+        /* the inactive cells and cell 14 */
+        if (size_t( std::count( mask.begin(), mask.end(), true ) ) != size - active + 1)
+            errors[r]++;
+    }
+
+    for (int r = 0; r < readers; r++) {
+        BOOST_CHECK_EQUAL( errors[r] , 0U );
+        BOOST_CHECK_EQUAL( views[r] , views[0] );
+    }
+    BOOST_CHECK( p.isCompressed() );
+    BOOST_CHECK_EQUAL( p.getActiveData().size() , size_t( active ) );
+
+    /* a sparse property stays sparse */
+    Opm::GridProperty<int> fipnum( 20 , 20 , 20 , Opm::GridProperty<int>::SupportedKeywordInfo( "FIPNUM" , 1 , "1" ) );
+    fipnum.iset( 17 , 2 );
+    const auto& cfipnum = fipnum;
+    std::vector< size_t > regions( readers, 0 );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(8)
+#endif
+    for (int r = 0; r < readers; r++)
+        regions[r] = cfipnum.getData()[17] + cfipnum.regionCells().cells( 1 ).size();
+
+    for (int r = 0; r < readers; r++)
+        BOOST_CHECK_EQUAL( regions[r] , 2 + size - 1 );
+    BOOST_CHECK( fipnum.isSparse() );
+
+    /* the explicit expand() returns to full storage */
+    p.expand();
+    BOOST_CHECK( !p.isCompressed() );
+    BOOST_CHECK_EQUAL( p.getData().size() , size );
+    BOOST_CHECK_EQUAL( p.iget( 3 ) , 7.0 );
+    BOOST_CHECK_EQUAL( p.iget( 4 ) , 2.0 );
+}
+
 BOOST_AUTO_TEST_CASE(CheckLimits) {
     typedef Opm::GridProperty<int>::SupportedKeywordInfo SupportedKeywordInfo;
     SupportedKeywordInfo keywordInfo1("P" , 1 , "1");
@@ -555,3 +834,270 @@ BOOST_AUTO_TEST_CASE(hasKeyword_assertKeyword) {
 
     BOOST_CHECK_THROW( gridProperties.getKeyword( "NOT-SUPPORTED" ), std::invalid_argument );
 }
+
+
+BOOST_AUTO_TEST_CASE(handles) {
+    typedef Opm::GridProperties<int>::SupportedKeywordInfo SupportedKeywordInfo;
+    const auto supported = []() {
+        return std::vector<SupportedKeywordInfo> {
+            SupportedKeywordInfo("SATNUM" , 2, "1"),
+            SupportedKeywordInfo("PVTNUM" , 3, "1")
+        };
+    };
+    const Opm::EclipseGrid grid(10, 7, 9);
+    Opm::GridProperties<int> gridProperties( grid, supported() );
+    const Opm::GridProperties<int> other( grid, supported() );
+
+    /* the position in the supported list, in any container */
+    BOOST_CHECK_EQUAL( gridProperties.getHandle( "SATNUM" ), 0U );
+    BOOST_CHECK_EQUAL( gridProperties.getHandle( "PVTNUM" ), 1U );
+    BOOST_CHECK_EQUAL( other.getHandle( "PVTNUM" ), 1U );
+    BOOST_CHECK_EQUAL( gridProperties.getHandle( "pvtnum  " ), 1U );
+    BOOST_CHECK_THROW( gridProperties.getHandle( "NOT-SUPPORTED" ), std::invalid_argument );
+
+    /* the handle overloads auto create like the string overloads */
+    const auto pvtnum = gridProperties.getHandle( "PVTNUM" );
+    BOOST_CHECK( !gridProperties.hasKeyword( pvtnum ) );
+    BOOST_CHECK_EQUAL( gridProperties.getKeyword( pvtnum ).iget( 17 ), 3 );
+    BOOST_CHECK( gridProperties.hasKeyword( pvtnum ) );
+    BOOST_CHECK( gridProperties.hasKeyword( "PVTNUM" ) );
+    BOOST_CHECK( !gridProperties.hasDeckKeyword( "PVTNUM" ) );
+    const auto& constProperties = gridProperties;
+    BOOST_CHECK_EQUAL( &gridProperties.getKeyword( pvtnum ), &constProperties.getKeyword( "pvtnum" ) );
+    BOOST_CHECK_THROW( gridProperties.getKeyword( size_t( 17 ) ), std::out_of_range );
+    BOOST_CHECK_THROW( gridProperties.hasKeyword( size_t( 17 ) ), std::out_of_range );
+
+    /* FIPxxx keywords are numbered as they are first used */
+    const auto fipreg = gridProperties.getHandle( "FIPREG" );
+    BOOST_CHECK_EQUAL( fipreg, 2U );
+    BOOST_CHECK( !gridProperties.hasKeyword( "FIPREG" ) );
+    BOOST_CHECK( gridProperties.addKeyword( "FIPREG" ) );
+    BOOST_CHECK( gridProperties.hasDeckKeyword( "FIPREG" ) );
+    BOOST_CHECK_EQUAL( gridProperties.getKeyword( fipreg ).iget( 0 ), 1 );
+
+    /* a copy has its own handle table */
+    Opm::GridProperties<int> copy( gridProperties );
+    const auto& constCopy = copy;
+    BOOST_CHECK( copy.hasKeyword( pvtnum ) );
+    BOOST_CHECK( &copy.getKeyword( pvtnum ) != &gridProperties.getKeyword( pvtnum ) );
+    BOOST_CHECK_EQUAL( &copy.getKeyword( pvtnum ), &constCopy.getKeyword( "PVTNUM" ) );
+    BOOST_CHECK_EQUAL( constCopy.getKeyword( "SATNUM" ).iget( 0 ), 2 );
+    BOOST_CHECK( !gridProperties.hasKeyword( "SATNUM" ) );
+
+    copy = other;
+    BOOST_CHECK( !copy.hasKeyword( pvtnum ) );
+    BOOST_CHECK_EQUAL( copy.getKeyword( pvtnum ).iget( 0 ), 3 );
+    BOOST_CHECK( !other.hasKeyword( pvtnum ) );
+}
+
+
+BOOST_AUTO_TEST_CASE(OPERATE_kernels) {
+    const std::vector< std::string > operations = {
+        "MULTA 2 0.5", "POLY 2 0.5", "SLOG 0.5 2", "LOG10", "LOGE", "INV", "MULTX 2",
+        "ADDX 2", "COPY", "MAXLIM 0.3", "MINLIM 0.3", "MULTP 2 0.5", "ABS", "MULTIPLY"
+    };
+    const size_t nz = operations.size();
+
+    std::stringstream deckString;
+    deckString << "RUNSPEC\nDIMENS\n 2 2 " << nz << " /\n"
+               << "GRID\nDX\n" << 4 * nz << "*1 /\nDY\n" << 4 * nz << "*1 /\n"
+               << "DZ\n" << 4 * nz << "*1 /\nTOPS\n4*1 /\n"
+               << "NTG\n" << 4 * nz << "*0.5 /\nSWAT\n";
+    for (size_t g = 0; g < 4 * nz; g++)
+        deckString << ( g / 4 == 12 ? -1 : 1 ) * (0.125 + 0.0625 * g) << " ";
+    deckString << "/\nOPERATE\n";
+    for (size_t k = 0; k < nz; k++) {
+        if (k == 0)
+            deckString << "NTG 1 2 1 1 1 1 ";
+        else
+            deckString << "NTG 1 2 1 2 " << k + 1 << " " << k + 1 << " ";
+        deckString << operations[k].substr( 0, operations[k].find( ' ' ) ) << " SWAT "
+                   << ( operations[k].find( ' ' ) == std::string::npos ? "" : operations[k].substr( operations[k].find( ' ' ) ) )
+                   << " /\n";
+    }
+    deckString << "/\n";
+
+    Opm::Parser parser;
+    auto deck = parser.parseString( deckString.str(), Opm::ParseContext() );
+    Opm::TableManager tm( deck );
+    Opm::EclipseGrid eg( deck );
+    Opm::Eclipse3DProperties props( deck, tm, eg );
+
+    const auto& ntg = props.getDoubleGridProperty( "NTG" ).getData();
+    const auto& swat = props.getDoubleGridProperty( "SWAT" ).getData();
+
+    for (size_t g = 0; g < 4 * nz; g++) {
+        const double R = 0.5;
+        const double X = swat[g];
+        double expected = R;
+
+        switch (g / 4) {
+            case 0:  expected = g < 2 ? 2 * X + 0.5 : R;  break;
+            case 1:  expected = R + 2 * std::pow( X, 0.5 ); break;
+            case 2:  expected = std::pow( 10, 0.5 + 2 * X ); break;
+            case 3:  expected = std::log10( X ); break;
+            case 4:  expected = std::log( X ); break;
+            case 5:  expected = 1.0 / X; break;
+            case 6:  expected = 2 * X; break;
+            case 7:  expected = 2 + X; break;
+            case 8:  expected = X; break;
+            case 9:  expected = std::min( 0.3, X ); break;
+            case 10: expected = std::max( 0.3, X ); break;
+            case 11: expected = 2 * std::pow( X, 0.5 ); break;
+            case 12: expected = std::abs( X ); break;
+            case 13: expected = R * X; break;
+        }
+
+        BOOST_CHECK_EQUAL( ntg[g], expected );
+    }
+
+    BOOST_CHECK( swat[48] < 0 );
+    BOOST_CHECK_EQUAL( ntg[48], -swat[48] );
+
+    Opm::Deck invalid = parser.parseString( deckString.str() + "OPERATE\nNTG 4* 1 1 NOSUCHOP SWAT /\n/\n",
+                                            Opm::ParseContext() );
+    BOOST_CHECK_THROW( Opm::Eclipse3DProperties invalidProps( invalid, tm, eg ), std::invalid_argument );
+}
+
+
+BOOST_AUTO_TEST_CASE(fused_edits) {
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    const size_t nx = 7, ny = 5, nz = 6;
+    const Opm::Box global( nx, ny, nz );
+
+    std::vector< Opm::GridProperty<double> > sequential;
+    for (int p = 0; p < 3; p++)
+        sequential.emplace_back( nx, ny, nz, SupportedKeywordInfo( "P" + std::to_string( p ), 0.25 * (p + 1), "1" ) );
+    auto fused = sequential;
+
+    Opm::GridPropertyEdits< double > edits;
+    unsigned seed = 17;
+    auto next = [&seed]( size_t n ) { seed = seed * 1103515245 + 12345; return size_t( (seed >> 16) % n ); };
+
+    for (int op = 0; op < 200; op++) {
+        const int i1 = next( nx ), i2 = i1 + next( nx - i1 );
+        const int j1 = next( ny ), j2 = j1 + next( ny - j1 );
+        const int k1 = next( nz ), k2 = k1 + next( nz - k1 );
+        const Opm::Box box = next( 4 ) == 0 ? global : Opm::Box( global, i1, i2, j1, j2, k1, k2 );
+        const size_t target = next( 3 );
+        const size_t src = next( 3 );
+        const double value = 0.5 + 0.125 * next( 9 );
+
+        switch (next( 4 )) {
+            case 0:
+                sequential[target].setScalar( value, box );
+                edits.assign( fused[target].getData(), value, box );
+                break;
+            case 1:
+                sequential[target].add( value, box );
+                edits.add( fused[target].getData(), value, box );
+                break;
+            case 2:
+                sequential[target].scale( value, box );
+                edits.multiply( fused[target].getData(), value, box );
+                break;
+            case 3:
+                sequential[target].copyFrom( sequential[src], box );
+                edits.copy( fused[target].getData(), fused[src].getData(), box );
+                break;
+        }
+    }
+
+    BOOST_CHECK_EQUAL( edits.size(), 200U );
+    edits.apply();
+    BOOST_CHECK( edits.empty() );
+
+    for (size_t p = 0; p < 3; p++) {
+        const auto& expected = sequential[p].getData();
+        const auto& data = fused[p].getData();
+        BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bulk_kernels) {
+    typedef Opm::GridProperty<double>::SupportedKeywordInfo SupportedKeywordInfo;
+    /* more than two chunks, so the kernels run in parallel */
+    const size_t nx = 60, ny = 50, nz = 20;
+    const size_t size = nx * ny * nz;
+    const Opm::Box global( nx, ny, nz );
+    const Opm::Box layers( global, 0, nx - 1, 0, ny - 1, 3, 17 );
+    const Opm::Box columns( global, 5, 41, 2, 47, 0, nz - 1 );
+
+    std::vector< double > values( size );
+    for (size_t g = 0; g < size; g++)
+        values[g] = double( g % 7 );
+
+    std::vector< double > expected = values;
+    for (size_t g = 0; g < size; g++) {
+        if (expected[g] == 3)
+            expected[g] = 10;
+        else if (g % 5 == 0)
+            expected[g] = expected[g] * 2 + 1;
+    }
+
+    for (size_t g : layers)
+        expected[g] *= 0.5;
+    for (size_t g : columns)
+        expected[g] += 4;
+
+    for (int threads : { 1, 3, 0 }) {
+        Opm::GridKernels::setThreads( threads );
+
+        Opm::GridProperty<double> prop( nx, ny, nz, SupportedKeywordInfo( "P", 0.0, "1" ) );
+        Opm::GridProperty<double> ten( nx, ny, nz, SupportedKeywordInfo( "T", 10.0, "1" ) );
+        prop.getData() = values;
+
+        std::vector< bool > bits;
+        Opm::GridProperty<double>::ByteMask bytes;
+        prop.initMask( 3, bits );
+        prop.initMask( 3, bytes );
+        BOOST_CHECK_EQUAL( bits.size(), size );
+        BOOST_CHECK_EQUAL( bytes.size(), size );
+        for (size_t g = 0; g < size; g++) {
+            BOOST_CHECK_EQUAL( bits[g], values[g] == 3 );
+            BOOST_CHECK_EQUAL( bool( bytes[g] ), values[g] == 3 );
+        }
+
+        Opm::GridProperty<double>::ByteMask every_fifth( size, 0 );
+        std::vector< bool > every_fifth_bits( size, false );
+        for (size_t g = 0; g < size; g += 5) {
+            every_fifth[g] = values[g] != 3;
+            every_fifth_bits[g] = values[g] != 3;
+        }
+
+        auto copy = prop;
+        prop.maskedCopy( ten, bytes );
+        prop.maskedMultiply( 2, every_fifth );
+        prop.maskedAdd( 1, every_fifth );
+        prop.scale( 0.5, layers );
+        prop.add( 4, columns );
+
+        copy.maskedSet( 10, bits );
+        copy.maskedMultiply( 2, every_fifth_bits );
+        copy.maskedAdd( 1, every_fifth_bits );
+        copy.scale( 0.5, layers );
+        copy.add( 4, columns );
+
+        const auto& data = prop.getData();
+        BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( copy.getData().begin(), copy.getData().end(), expected.begin(), expected.end() );
+
+        /* the first offending element is reported, whatever the number of threads */
+        prop.setScalar( 1, global );
+        prop.iset( size - 1, -7 );
+        prop.iset( 40000, -5 );
+        prop.iset( 20000, 9 );
+        try {
+            prop.checkLimits( 0, 2 );
+            BOOST_CHECK( false );
+        } catch (const std::invalid_argument& e) {
+            BOOST_CHECK( std::string( e.what() ).find( std::to_string( 9.0 ) ) != std::string::npos );
+        }
+
+        BOOST_CHECK( !prop.containsNaN() );
+        prop.iset( size - 1, std::nan( "" ) );
+        BOOST_CHECK( prop.containsNaN() );
+    }
+
+    Opm::GridKernels::setThreads( 0 );
+}
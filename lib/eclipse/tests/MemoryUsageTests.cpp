@@ -0,0 +1,290 @@
+/*
+  Copyright 2017 Statoil ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE MemoryUsageTests
+
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Deck/DeckItem.hpp>
+#include <opm/parser/eclipse/Deck/DeckKeyword.hpp>
+#include <opm/parser/eclipse/Deck/DeckRecord.hpp>
+#include <opm/parser/eclipse/EclipseState/Eclipse3DProperties.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/GridProperty.hpp>
+#include <opm/parser/eclipse/EclipseState/Runspec.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Utility/GridMemory.hpp>
+#include <opm/parser/eclipse/Utility/MemoryUsage.hpp>
+
+using namespace Opm;
+
+/*
+  Counting allocator: every allocation is prefixed with its size, so the
+  number of live heap bytes can be compared with the memoryUsage()
+  estimates.
+*/
+
+namespace {
+    size_t live_bytes = 0;
+    const size_t header = alignof( std::max_align_t );
+}
+
+void* operator new( size_t size ) {
+    auto* p = static_cast< char* >( std::malloc( size + header ) );
+    if( !p ) throw std::bad_alloc();
+
+    *reinterpret_cast< size_t* >( p ) = size;
+    live_bytes += size;
+    return p + header;
+}
+
+void operator delete( void* ptr ) noexcept {
+    if( !ptr ) return;
+
+    auto* p = static_cast< char* >( ptr ) - header;
+    live_bytes -= *reinterpret_cast< size_t* >( p );
+    std::free( p );
+}
+
+void operator delete( void* ptr, size_t ) noexcept {
+    operator delete( ptr );
+}
+
+
+BOOST_AUTO_TEST_CASE(DeckKeywordExact) {
+    const auto before = live_bytes;
+    {
+        DeckKeyword kw( "A_LONG_KEYWORD_NAME_ON_THE_HEAP" );
+        for( int r = 0; r < 10; r++ ) {
+            DeckItem ints( "INTEGER_ITEM_WITH_LONG_NAME", int() );
+            DeckItem doubles( "D", double() );
+            DeckItem strings( "S", std::string() );
+
+            for( int i = 0; i < 100 * r; i++ ) {
+                ints.push_back( i );
+                doubles.push_back( 0.5 * i );
+            }
+            strings.push_back( std::string( "short" ) );
+            strings.push_back( std::string( 100, 'x' ) );
+            strings.push_backDefault( std::string( "default" ) );
+
+            std::vector< DeckItem > items;
+            items.push_back( std::move( ints ) );
+            items.push_back( std::move( doubles ) );
+            items.push_back( std::move( strings ) );
+            kw.addRecord( DeckRecord( std::move( items ) ) );
+        }
+
+        BOOST_CHECK_EQUAL( live_bytes - before, kw.memoryUsage() );
+
+        const auto& item = kw.getRecord( 9 ).getItem( 1 );
+        const auto item_bytes = item.memoryUsage();
+        BOOST_CHECK( item_bytes >= 900 * sizeof( double ) );
+    }
+    BOOST_CHECK_EQUAL( live_bytes, before );
+}
+
+BOOST_AUTO_TEST_CASE(GridPropertyExact) {
+    typedef GridProperty< double >::SupportedKeywordInfo SupportedKeywordInfo;
+    SupportedKeywordInfo kwInfo( "PERMX", 1.0, "Permeability" );
+
+    const auto before = live_bytes;
+    {
+        GridProperty< double > prop( 10, 11, 12, kwInfo );
+        BOOST_CHECK( prop.isSparse() );
+        BOOST_CHECK_EQUAL( live_bytes - before, prop.memoryUsage() );
+
+        prop.getData();
+        BOOST_CHECK( !prop.isSparse() );
+        BOOST_CHECK_EQUAL( live_bytes - before, prop.memoryUsage() );
+        BOOST_CHECK( prop.memoryUsage() >= 10 * 11 * 12 * sizeof( double ) );
+    }
+}
+
+/*
+  The Schedule and TableManager estimates do not count every allocation,
+  but they must not exceed what was allocated for the object; the table
+  estimate leaves out the small bookkeeping containers of the manager.
+*/
+BOOST_AUTO_TEST_CASE(TableManagerEstimate) {
+    const std::string input =
+        "RUNSPEC\n"
+        "OIL\n"
+        "WATER\n"
+        "GAS\n"
+        "DISGAS\n"
+        "TABDIMS\n"
+        " 1 1 20 20 /\n"
+        "PROPS\n"
+        "SWOF\n"
+        " 0.1 0.0 1.0 0.0\n"
+        " 0.2 0.1 0.8 0.0\n"
+        " 0.5 0.3 0.4 0.0\n"
+        " 0.8 0.6 0.1 0.0\n"
+        " 0.9 1.0 0.0 0.0 /\n"
+        "PVTO\n"
+        " 0.0   10  1.05 2.5\n"
+        "       50  1.04 2.6 /\n"
+        " 50.0 100  1.20 1.5\n"
+        "      200  1.18 1.6 /\n"
+        "/\n"
+        "PVTW\n"
+        " 100 1.01 4e-5 0.5 0 /\n"
+        "DENSITY\n"
+        " 800 1000 1 /\n";
+
+    Parser parser;
+    const auto deck = parser.parseString( input, ParseContext() );
+    { TableManager warmup( deck ); }
+
+    const auto before = live_bytes;
+    {
+        TableManager tables( deck );
+        const auto allocated = live_bytes - before;
+
+        MemoryUsage usage;
+        tables.memoryUsage( usage );
+        BOOST_CHECK( usage.get( "Tables/SWOF" ) > 0 );
+        BOOST_CHECK( usage.get( "Tables/PVTO" ) > 0 );
+        BOOST_CHECK( usage.get( "Tables/PVTW" ) > 0 );
+        BOOST_CHECK( usage.total() <= allocated );
+        BOOST_CHECK( usage.total() >= allocated / 3 );
+    }
+    BOOST_CHECK_EQUAL( live_bytes, before );
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleEstimate) {
+    std::string input =
+        "START\n"
+        " 1 NOV 1979 /\n"
+        "SCHEDULE\n"
+        "DATES\n"
+        " 1 DES 1979 /\n"
+        "/\n"
+        "WELSPECS\n";
+    for (int w = 0; w < 20; w++)
+        input += " 'W" + std::to_string( w ) + "' 'G' " + std::to_string( w % 10 + 1 ) + " 1 1* 'OIL' /\n";
+    input += "/\nCOMPDAT\n";
+    for (int w = 0; w < 20; w++)
+        input += " 'W" + std::to_string( w ) + "' 0 0 1 10 'OPEN' 1* 10.0 0.311 /\n";
+    input += "/\n";
+    for (int d = 1; d < 12; d++)
+        input += "DATES\n " + std::to_string( d ) + " JAN " + std::to_string( 1980 + d ) + " /\n/\n";
+
+    Parser parser;
+    const auto deck = parser.parseString( input, ParseContext() );
+    const EclipseGrid grid( 10, 10, 10 );
+    const TableManager tables( deck );
+    const Eclipse3DProperties props( deck, tables, grid );
+    { Schedule warmup( deck, grid, props, Phases( true, true, true ), ParseContext() ); }
+
+    const auto before = live_bytes;
+    {
+        Schedule schedule( deck, grid, props, Phases( true, true, true ), ParseContext() );
+        const auto allocated = live_bytes - before;
+
+        MemoryUsage usage;
+        schedule.memoryUsage( usage );
+        BOOST_CHECK( usage.get( "Schedule/wells" ) > 0 );
+        BOOST_CHECK( usage.total() <= allocated );
+        BOOST_CHECK( usage.total() >= allocated / 2 );
+    }
+    BOOST_CHECK_EQUAL( live_bytes, before );
+}
+
+BOOST_AUTO_TEST_CASE(DeckComponents) {
+    Deck deck;
+    deck.addKeyword( DeckKeyword( "RUNSPEC" ) );
+
+    DeckKeyword kw( "PORO" );
+    DeckItem item( "data", double() );
+    item.push_back( 0.25, 1000 );
+    std::vector< DeckItem > items;
+    items.push_back( std::move( item ) );
+    kw.addRecord( DeckRecord( std::move( items ) ) );
+    deck.addKeyword( std::move( kw ) );
+
+    MemoryUsage usage;
+    deck.memoryUsage( usage );
+
+    BOOST_CHECK( usage.get( "Deck/keywords/PORO" ) >= 1000 * sizeof( double ) );
+    BOOST_CHECK( usage.get( "Deck/keywords/RUNSPEC" ) > 0 );
+    BOOST_CHECK_EQUAL( usage.get( "Deck/keywords/NOSUCH" ), 0U );
+    BOOST_CHECK_EQUAL( usage.total(), deck.memoryUsage() );
+}
+
+BOOST_AUTO_TEST_CASE(SortedReport) {
+    MemoryUsage usage;
+    usage.add( "A", 10 );
+    usage.add( "B", 1000 );
+    usage.add( "C", 100 );
+    usage.add( "A", 5 );
+
+    BOOST_CHECK_EQUAL( usage.total(), 1115U );
+    BOOST_CHECK_EQUAL( usage.get( "A" ), 15U );
+
+    const auto sorted = usage.sorted();
+    BOOST_CHECK_EQUAL( sorted.size(), 3U );
+    BOOST_CHECK_EQUAL( sorted[0].first, "B" );
+    BOOST_CHECK_EQUAL( sorted[1].first, "C" );
+    BOOST_CHECK_EQUAL( sorted[2].first, "A" );
+
+    std::stringstream ss;
+    usage.report( ss, 2 );
+    const auto report = ss.str();
+    BOOST_CHECK( report.find( "B" ) < report.find( "C" ) );
+    BOOST_CHECK( report.find( "1 smaller" ) != std::string::npos );
+    BOOST_CHECK( report.find( "1115" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE(GridMemoryPlacement) {
+    const size_t large = 3 * GridMemory::large_array / sizeof( double ) + 7;
+
+    const auto filled = GridMemory::filled( large, 2.5 );
+    BOOST_CHECK_EQUAL( filled.size(), large );
+    BOOST_CHECK_EQUAL( filled.capacity(), large );
+    BOOST_CHECK_EQUAL( filled.front(), 2.5 );
+    BOOST_CHECK_EQUAL( filled.back(), 2.5 );
+
+    std::vector< int > v = { 1, 2, 3 };
+    GridMemory::resize( v, large );
+    BOOST_CHECK_EQUAL( v.size(), large );
+    BOOST_CHECK_EQUAL( v[0], 1 );
+    BOOST_CHECK_EQUAL( v[2], 3 );
+    BOOST_CHECK_EQUAL( v[3], 0 );
+    BOOST_CHECK_EQUAL( v.back(), 0 );
+
+    const auto* data = v.data();
+    GridMemory::resize( v, 10 );
+    BOOST_CHECK_EQUAL( v.data(), data );
+    BOOST_CHECK_EQUAL( v.size(), 10U );
+
+    const auto small = GridMemory::filled( 10, 7 );
+    BOOST_CHECK_EQUAL( small.size(), 10U );
+    BOOST_CHECK_EQUAL( small[9], 7 );
+}
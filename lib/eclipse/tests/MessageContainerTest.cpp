@@ -79,3 +79,69 @@ BOOST_AUTO_TEST_CASE(appendMessages) {
     BOOST_CHECK_EQUAL("Error: msgContainer.", msgContainer.begin()->message);
     BOOST_CHECK_EQUAL("Warning: msgList.", (msgContainer.end()-1)->message);
 }
+
+
+BOOST_AUTO_TEST_CASE(AggregatedMessages) {
+    MessageContainer mc;
+    mc.setMessageLimit( 2 );
+    BOOST_CHECK_EQUAL( 2U , mc.messageLimit() );
+
+    for (size_t line = 1; line <= 5; line++)
+        mc.add( Message( Message::Warning, "Extra data", Location( "CASE.DATA", line ) ),
+                "PARSE_EXTRA_DATA", "EQUIL" );
+
+    mc.add( Message( Message::Warning, "Extra data", Location( "INC.DATA", 7 ) ),
+            "PARSE_EXTRA_DATA", "EQUIL" );
+    mc.add( Message( Message::Warning, "Unknown", {} ), "PARSE_UNKNOWN_KEYWORD", "XYZ" );
+    mc.warning( "Not aggregated" );
+
+    BOOST_CHECK_EQUAL( 5U , mc.size() );
+    BOOST_CHECK_EQUAL( 3U , mc.suppressed() );
+
+    const auto& counts = mc.counts();
+    BOOST_REQUIRE_EQUAL( 3U , counts.size() );
+    BOOST_CHECK_EQUAL( "PARSE_EXTRA_DATA" , counts[0].key );
+    BOOST_CHECK_EQUAL( "EQUIL" , counts[0].keyword );
+    BOOST_CHECK_EQUAL( "CASE.DATA" , counts[0].filename );
+    BOOST_CHECK_EQUAL( 5U , counts[0].count );
+    BOOST_CHECK_EQUAL( 1U , counts[0].first.lineno );
+    BOOST_CHECK_EQUAL( 5U , counts[0].last.lineno );
+    BOOST_CHECK_EQUAL( 1U , counts[1].count );
+    BOOST_CHECK_EQUAL( "INC.DATA" , counts[1].filename );
+    BOOST_CHECK( !counts[2].first );
+
+    MessageContainer other;
+    other.appendMessages( mc );
+    BOOST_CHECK_EQUAL( 5U , other.size() );
+    BOOST_CHECK_EQUAL( 3U , other.suppressed() );
+    BOOST_CHECK_EQUAL( 5U , other.counts()[0].count );
+}
+
+
+BOOST_AUTO_TEST_CASE(AppendMessagesRespectsLimit) {
+    MessageContainer merged;
+    merged.setMessageLimit( 3 );
+
+    for (int part = 0; part < 2; part++) {
+        MessageContainer mc;
+        mc.setMessageLimit( 2 );
+        for (size_t line = 1; line <= 4; line++)
+            mc.add( Message( Message::Warning, "Extra data", Location( "CASE.DATA", line ) ),
+                    "PARSE_EXTRA_DATA", "EQUIL" );
+        mc.warning( "Not aggregated" );
+
+        merged.appendMessages( mc );
+    }
+
+    /*
+      The first part stores its two messages; the count is then 4, past
+      the limit, so none of the second part is stored. The messages which
+      are not aggregated are always kept.
+    */
+    BOOST_CHECK_EQUAL( 2U + 2U , merged.size() );
+    BOOST_CHECK_EQUAL( 2U + 2U + 2U , merged.suppressed() );
+    BOOST_REQUIRE_EQUAL( 1U , merged.counts().size() );
+    BOOST_CHECK_EQUAL( 8U , merged.counts()[0].count );
+    BOOST_CHECK_EQUAL( 1U , merged.counts()[0].first.lineno );
+    BOOST_CHECK_EQUAL( 4U , merged.counts()[0].last.lineno );
+}
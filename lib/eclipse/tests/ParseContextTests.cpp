@@ -17,6 +17,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits>
 #include <stdexcept>
 #include <stdlib.h>
 #include <iostream>
@@ -417,3 +418,61 @@ BOOST_AUTO_TEST_CASE(test_1arg_constructor) {
         BOOST_CHECK_EQUAL(ctx.get(ParseContext::PARSE_RANDOM_SLASH), InputError::IGNORE);
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(TestErrorKeyId) {
+    ParseContext parseContext( {{"UNSUPPORTED_*" , InputError::WARN}} );
+
+    BOOST_CHECK_EQUAL( ParseContext::keyName( ParseContext::ErrorKey::PARSE_EXTRA_DATA ) , ParseContext::PARSE_EXTRA_DATA );
+    BOOST_CHECK_EQUAL( ParseContext::keyName( ParseContext::ErrorKey::SUMMARY_UNKNOWN_GROUP ) , ParseContext::SUMMARY_UNKNOWN_GROUP );
+    BOOST_CHECK_EQUAL( parseContext.get( ParseContext::ErrorKey::UNSUPPORTED_COMPORD_TYPE ) , InputError::WARN );
+    BOOST_CHECK_EQUAL( parseContext.get( ParseContext::ErrorKey::PARSE_RANDOM_TEXT ) , InputError::THROW_EXCEPTION );
+
+    parseContext.updateKey( ParseContext::PARSE_RANDOM_TEXT , InputError::IGNORE );
+    BOOST_CHECK_EQUAL( parseContext.get( ParseContext::ErrorKey::PARSE_RANDOM_TEXT ) , InputError::IGNORE );
+
+    parseContext.update( InputError::WARN );
+    BOOST_CHECK_EQUAL( parseContext.get( ParseContext::ErrorKey::PARSE_RANDOM_TEXT ) , InputError::WARN );
+
+    MessageContainer msgContainer;
+    msgContainer.setMessageLimit( 1 );
+    parseContext.handleError( ParseContext::ErrorKey::PARSE_EXTRA_DATA , msgContainer , "msg1" , "EQUIL" );
+    parseContext.handleError( ParseContext::ErrorKey::PARSE_EXTRA_DATA , msgContainer , "msg2" , "EQUIL" );
+    parseContext.handleError( ParseContext::PARSE_EXTRA_DATA , msgContainer , "msg3" );
+    BOOST_CHECK_EQUAL( msgContainer.size() , 2U );
+    BOOST_CHECK_EQUAL( msgContainer.suppressed() , 1U );
+    BOOST_CHECK_EQUAL( msgContainer.counts()[0].count , 2U );
+
+    parseContext.updateKey( ParseContext::PARSE_EXTRA_DATA , InputError::THROW_EXCEPTION );
+    BOOST_CHECK_THROW( parseContext.handleError( ParseContext::ErrorKey::PARSE_EXTRA_DATA , msgContainer , "msg4" ) , std::invalid_argument );
+}
+
+
+BOOST_AUTO_TEST_CASE(TestMessageLimitParseString) {
+    const char * deckString =
+        "RUNSPEC\n"
+        "FOOBAR\n"
+        "FOOBAR\n"
+        "FOOBAR\n";
+
+    ParseContext parseContext;
+    Parser parser;
+
+    parseContext.update(ParseContext::PARSE_UNKNOWN_KEYWORD , InputError::WARN );
+    BOOST_CHECK_EQUAL( parseContext.messageLimit() , std::numeric_limits< std::size_t >::max() );
+    {
+        auto deck = parser.parseString( deckString , parseContext );
+        BOOST_CHECK_EQUAL( deck.getMessageContainer().size() , 3U );
+        BOOST_CHECK_EQUAL( deck.getMessageContainer().suppressed() , 0U );
+    }
+
+    parseContext.setMessageLimit( 1 );
+    {
+        auto deck = parser.parseString( deckString , parseContext );
+        const auto& msgContainer = deck.getMessageContainer();
+        BOOST_CHECK_EQUAL( msgContainer.messageLimit() , 1U );
+        BOOST_CHECK_EQUAL( msgContainer.size() , 1U );
+        BOOST_CHECK_EQUAL( msgContainer.suppressed() , 2U );
+        BOOST_CHECK_EQUAL( msgContainer.counts()[0].count , 3U );
+    }
+}
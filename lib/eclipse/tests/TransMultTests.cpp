@@ -44,3 +44,22 @@ BOOST_AUTO_TEST_CASE(Empty) {
     BOOST_CHECK_EQUAL( transMult.getMultiplier(9,9,9, Opm::FaceDir::YMinus) , 1.0 );
     BOOST_CHECK_EQUAL( transMult.getMultiplier(100 , Opm::FaceDir::ZMinus) , 1.0 );
 }
+
+
+BOOST_AUTO_TEST_CASE(SparseMultipliers) {
+    Opm::Eclipse3DProperties props;
+    Opm::TransMult transMult(Opm::GridDims(10,10,10) ,{} , props);
+    Opm::GridPropertySupportedKeywordInfo<double> kwInfo("MULTX" , 1.0 , "1");
+    Opm::GridProperty<double> multx(10 , 10 , 10 , kwInfo);
+
+    multx.iset(1,2,3 , 0.5);
+    transMult.applyMULT(multx , Opm::FaceDir::XPlus);
+    transMult.applyMULT(multx , Opm::FaceDir::XPlus);
+
+    BOOST_CHECK( multx.isSparse() );
+    BOOST_CHECK_EQUAL( transMult.getMultiplier(1,2,3, Opm::FaceDir::XPlus) , 0.25 );
+    BOOST_CHECK_EQUAL( transMult.getMultiplier(3,2,1, Opm::FaceDir::XPlus) , 1.0 );
+    BOOST_CHECK_EQUAL( transMult.getMultiplier(1,2,3, Opm::FaceDir::XMinus) , 1.0 );
+    /* the source and the direction property both stay sparse */
+    BOOST_CHECK( transMult.memoryUsage() < 1000 * sizeof(double) );
+}